@@ -43,41 +43,956 @@ char *readFile(const char *filename, long *filesize)
     return buffer;
 }
 
-void benchmark_throughput() {
+/**
+ * Milliseconds between two gettimeofday readings.
+ */
+static double elapsed_ms(const struct timeval *start, const struct timeval *end) {
+    return (end->tv_sec - start->tv_sec) * 1000.0 + (end->tv_usec - start->tv_usec) / 1000.0;
+}
+
+void benchmark_throughput(const char *label, const json_parse_options_t *options) {
     struct timeval start_time, end_time;
 	double elapsed_time;
 
 	long* file_size = (long *) malloc(sizeof(long)); // make sure to allocate heap memory to pointer
 	char* file_contents = readFile("../benchmark_generation/generate/gened_output.json", file_size);
 
-	double time_sum;
+	double time_sum = 0;
     double best_time = INT_MAX;
 	int times = 20;
 
+    // in situ parsing overwrites its input, give it a fresh copy every time
+    bool insitu = options != NULL && (options->flags & JSON_PARSE_INSITU);
+    char *input = insitu ? (char *) malloc(*file_size + 1) : file_contents;
+
+    printf("===== %s =====\n", label);
 	for (int i = 0; i < times; i++) {
+        if (insitu) memcpy(input, file_contents, *file_size + 1);
+
 		gettimeofday(&start_time, NULL);
 
         // DO something
-        json_value_t *loaded_json = load_json(file_contents);
+        json_value_t *loaded_json = load_json_ex(input, options);
 
         gettimeofday(&end_time, NULL);
 
-        elapsed_time = (end_time.tv_sec - start_time.tv_sec) * 1000.0;
-        elapsed_time += (end_time.tv_usec - start_time.tv_usec) / 1000.0;
-
-        if (elapsed_time < best_time) {
-            best_time = elapsed_time;
-        }
+        elapsed_time = elapsed_ms(&start_time, &end_time);
+        best_time = fmin(best_time, elapsed_time);
 
         printf("Parsed %ld bytes in %lf ms\n", *file_size, elapsed_time);
         time_sum += elapsed_time;
         free_json(loaded_json);
 	}
 
-    free(file_size);
-    free(file_contents);
     printf("Average parsing throughput: %lf\n", time_sum / (double) times);
     printf("Best parse time: %lf\n", best_time);
+    printf("Best throughput: %.1lf MB/s\n", (*file_size / (1024.0 * 1024.0)) / (best_time / 1000.0));
+
+    if (insitu) free(input);
+    free(file_size);
+    free(file_contents);
+}
+
+/**
+ * SAX state for benchmark_sax: sums the "foo" member of every top level object.
+ */
+typedef struct foo_sum_s {
+    int depth;
+    bool is_foo;
+    long sum;
+} foo_sum_t;
+
+static bool foo_sum_begin(void *user) { ((foo_sum_t *) user)->depth++; return true; }
+static bool foo_sum_end(void *user, size_t size) { (void) size; ((foo_sum_t *) user)->depth--; return true; }
+static bool foo_sum_key(void *user, const char *key, size_t size) {
+    foo_sum_t *state = (foo_sum_t *) user;
+    state->is_foo = state->depth == 2 && size == 3 && memcmp(key, "foo", 3) == 0;
+    return true;
+}
+static bool foo_sum_int(void *user, long value) {
+    foo_sum_t *state = (foo_sum_t *) user;
+    if (state->is_foo) state->sum += value;
+    return true;
+}
+
+/**
+ * SAX: sums the "foo" field of the generated corpus with json_sax_parse (no document) against
+ * load_json, json_object_get on every element and free_json.
+ */
+void benchmark_sax() {
+    struct timeval start_time, end_time;
+    long file_size;
+    char *file_contents = readFile("../benchmark_generation/generate/gened_output.json", &file_size);
+
+    json_sax_handler_t handler = { 0 };
+    handler.on_object_begin = foo_sum_begin;
+    handler.on_array_begin = foo_sum_begin;
+    handler.on_object_end = foo_sum_end;
+    handler.on_array_end = foo_sum_end;
+    handler.on_key = foo_sum_key;
+    handler.on_int = foo_sum_int;
+
+    double sax_time = INT_MAX, dom_time = INT_MAX;
+    long sax_sum = 0, dom_sum = 0;
+    for (int i = 0; i < 10; i++) {
+        foo_sum_t state = { 0, false, 0 };
+        gettimeofday(&start_time, NULL);
+        json_sax_parse(file_contents, file_size, NULL, &handler, &state, NULL);
+        gettimeofday(&end_time, NULL);
+        sax_sum = state.sum;
+
+        sax_time = fmin(sax_time, elapsed_ms(&start_time, &end_time));
+
+        gettimeofday(&start_time, NULL);
+        json_value_t *loaded_json = load_json(file_contents);
+        dom_sum = 0;
+        for (size_t j = 0; j < json_array_size(loaded_json); j++) {
+            dom_sum += json_object_get(json_array_get(loaded_json, j), "foo", 3)->value.integer;
+        }
+        free_json(loaded_json);
+        gettimeofday(&end_time, NULL);
+
+        dom_time = fmin(dom_time, elapsed_ms(&start_time, &end_time));
+    }
+
+    printf("===== SAX =====\n");
+    printf("json_sax_parse: sum %ld in %lf ms (%.1lf MB/s)\n", sax_sum, sax_time, (file_size / (1024.0 * 1024.0)) / (sax_time / 1000.0));
+    printf("load_json + free_json: sum %ld in %lf ms (%.1lf MB/s)\n", dom_sum, dom_time, (file_size / (1024.0 * 1024.0)) / (dom_time / 1000.0));
+
+    free(file_contents);
+}
+
+static bool count_value(void *user, json_value_t *value) {
+    (*(long *) user)++;
+    free_json(value);
+    return true;
+}
+
+/**
+ * Stream: feeds the generated corpus in 64 KiB chunks, as it would come off a socket, once as SAX
+ * events (summing "foo" like benchmark_sax) and once handing out every element of the root array.
+ */
+void benchmark_stream() {
+    struct timeval start_time, end_time;
+    long file_size;
+    char *file_contents = readFile("../benchmark_generation/generate/gened_output.json", &file_size);
+    const long chunk_size = 64 << 10;
+
+    json_sax_handler_t handler = { 0 };
+    handler.on_object_begin = foo_sum_begin;
+    handler.on_array_begin = foo_sum_begin;
+    handler.on_object_end = foo_sum_end;
+    handler.on_array_end = foo_sum_end;
+    handler.on_key = foo_sum_key;
+    handler.on_int = foo_sum_int;
+
+    double sax_time = INT_MAX, values_time = INT_MAX;
+    long sax_sum = 0, values_count = 0;
+    for (int i = 0; i < 10; i++) {
+        foo_sum_t state = { 0, false, 0 };
+        json_stream_t stream;
+        gettimeofday(&start_time, NULL);
+        json_stream_init(&stream, JSON_STREAM_DEFAULT, &handler, &state);
+        for (long offset = 0; offset < file_size; offset += chunk_size) {
+            json_stream_feed(&stream, file_contents + offset, file_size - offset < chunk_size ? file_size - offset : chunk_size);
+        }
+        json_stream_close(&stream, NULL);
+        gettimeofday(&end_time, NULL);
+        sax_sum = state.sum;
+
+        sax_time = fmin(sax_time, elapsed_ms(&start_time, &end_time));
+
+        values_count = 0;
+        gettimeofday(&start_time, NULL);
+        json_stream_init_values(&stream, JSON_STREAM_DEFAULT, 1, count_value, &values_count);
+        for (long offset = 0; offset < file_size; offset += chunk_size) {
+            json_stream_feed(&stream, file_contents + offset, file_size - offset < chunk_size ? file_size - offset : chunk_size);
+        }
+        json_stream_close(&stream, NULL);
+        gettimeofday(&end_time, NULL);
+
+        values_time = fmin(values_time, elapsed_ms(&start_time, &end_time));
+    }
+
+    printf("===== stream (64 KiB chunks) =====\n");
+    printf("json_stream_feed, SAX: sum %ld in %lf ms (%.1lf MB/s)\n", sax_sum, sax_time, (file_size / (1024.0 * 1024.0)) / (sax_time / 1000.0));
+    printf("json_stream_feed, values at depth 1: %ld values in %lf ms (%.1lf MB/s)\n", values_count, values_time, (file_size / (1024.0 * 1024.0)) / (values_time / 1000.0));
+
+    free(file_contents);
+}
+
+/**
+ * Parallel array: parses the root array of the generated corpus with load_json_n against
+ * load_json_parallel spreading its elements over a growing number of workers.
+ */
+void benchmark_parallel() {
+    struct timeval start_time, end_time;
+    long file_size;
+    char *file_contents = readFile("../benchmark_generation/generate/gened_output.json", &file_size);
+
+    printf("===== PARALLEL ARRAY (%ld bytes) =====\n", file_size);
+
+    double best_time = INT_MAX;
+    for (int i = 0; i < 5; i++) {
+        gettimeofday(&start_time, NULL);
+        json_value_t *json_parsed = load_json_n(file_contents, file_size, NULL, NULL);
+        gettimeofday(&end_time, NULL);
+        free_json(json_parsed);
+
+        best_time = fmin(best_time, elapsed_ms(&start_time, &end_time));
+    }
+    printf("load_json_n: %lf ms (%.1lf MB/s)\n", best_time, (file_size / (1024.0 * 1024.0)) / (best_time / 1000.0));
+
+    size_t threads[] = { 1, 2, 4, 8, 16 };
+    for (int t = 0; t < 5; t++) {
+        best_time = INT_MAX;
+        for (int i = 0; i < 5; i++) {
+            gettimeofday(&start_time, NULL);
+            json_value_t *json_parsed = load_json_parallel(file_contents, file_size, NULL, threads[t], NULL);
+            gettimeofday(&end_time, NULL);
+            free_json(json_parsed);
+
+            best_time = fmin(best_time, elapsed_ms(&start_time, &end_time));
+        }
+        printf("load_json_parallel, %zu threads: %lf ms (%.1lf MB/s)\n", threads[t], best_time, (file_size / (1024.0 * 1024.0)) / (best_time / 1000.0));
+    }
+
+    free(file_contents);
+}
+
+/**
+ * NDJSON: turns the elements of the generated corpus into one record per line, then parses them line
+ * by line with load_json_n on one thread against load_json_lines with a growing number of workers.
+ */
+void benchmark_lines() {
+    struct timeval start_time, end_time;
+    json_value_t *corpus = load_json_file("../benchmark_generation/generate/gened_output.json");
+    if (corpus == NULL) {
+        printf("could not load the generated corpus\n");
+        return;
+    }
+
+    size_t capacity = 1 << 20, size = 0;
+    char *records = (char *) malloc(capacity);
+    for (size_t i = 0; i < json_array_size(corpus); i++) {
+        size_t record_size = 0;
+        char *record = dump_json_ex(json_array_get(corpus, i), JSON_DUMP_MINIFIED, &record_size);
+        while (size + record_size + 1 > capacity) {
+            capacity *= 2;
+            records = (char *) realloc(records, capacity);
+        }
+        memcpy(records + size, record, record_size);
+        size += record_size;
+        records[size++] = '\n';
+        free(record);
+    }
+
+    printf("===== NDJSON (%zu bytes) =====\n", size);
+
+    double best_time = INT_MAX;
+    for (int i = 0; i < 5; i++) {
+        // documents are kept until the end, like load_json_lines returns all of them
+        json_value_t **documents = (json_value_t **) malloc(json_array_size(corpus) * sizeof(json_value_t *));
+        size_t document_count = 0;
+        gettimeofday(&start_time, NULL);
+        for (char *line = records, *end = records + size; line < end;) {
+            char *newline = (char *) memchr(line, '\n', end - line);
+            documents[document_count++] = load_json_n(line, newline - line, NULL, NULL);
+            line = newline + 1;
+        }
+        gettimeofday(&end_time, NULL);
+        for (size_t j = 0; j < document_count; j++) {
+            free_json(documents[j]);
+        }
+        free(documents);
+
+        best_time = fmin(best_time, elapsed_ms(&start_time, &end_time));
+    }
+    free_json(corpus);
+    printf("load_json_n per line: %lf ms (%.1lf MB/s)\n", best_time, (size / (1024.0 * 1024.0)) / (best_time / 1000.0));
+
+    size_t threads[] = { 1, 2, 4, 8 };
+    for (int t = 0; t < 4; t++) {
+        best_time = INT_MAX;
+        size_t record_count = 0;
+        for (int i = 0; i < 5; i++) {
+            gettimeofday(&start_time, NULL);
+            json_lines_t *lines = load_json_lines(records, size, NULL, threads[t], NULL);
+            gettimeofday(&end_time, NULL);
+            if (lines == NULL) {
+                printf("load_json_lines failed\n");
+                break;
+            }
+            record_count = lines->size;
+            free_json_lines(lines);
+
+            best_time = fmin(best_time, elapsed_ms(&start_time, &end_time));
+        }
+        printf("load_json_lines, %zu threads: %zu records in %lf ms (%.1lf MB/s)\n", threads[t], record_count, best_time, (size / (1024.0 * 1024.0)) / (best_time / 1000.0));
+    }
+
+    free(records);
+}
+
+/**
+ * Validation: checks a file with json_validate against parsing and freeing it with load_json_n,
+ * the only way to find out whether input is well formed before.
+ */
+void benchmark_validate(const char *path) {
+    struct timeval start_time, end_time;
+    long file_size;
+    char *file_contents = readFile(path, &file_size);
+
+    double validate_time = INT_MAX, parse_time = INT_MAX;
+    bool valid = false;
+    for (int i = 0; i < 10; i++) {
+        gettimeofday(&start_time, NULL);
+        valid = json_validate(file_contents, file_size, NULL);
+        gettimeofday(&end_time, NULL);
+
+        validate_time = fmin(validate_time, elapsed_ms(&start_time, &end_time));
+
+        gettimeofday(&start_time, NULL);
+        free_json(load_json_n(file_contents, file_size, NULL, NULL));
+        gettimeofday(&end_time, NULL);
+
+        parse_time = fmin(parse_time, elapsed_ms(&start_time, &end_time));
+    }
+
+    printf("===== VALIDATE %s (%ld bytes) =====\n", path, file_size);
+    printf("json_validate: %s in %lf ms (%.1lf MB/s)\n", valid ? "valid" : "invalid", validate_time, (file_size / (1024.0 * 1024.0)) / (validate_time / 1000.0));
+    printf("load_json_n + free_json: %lf ms (%.1lf MB/s)\n", parse_time, (file_size / (1024.0 * 1024.0)) / (parse_time / 1000.0));
+
+    free(file_contents);
+}
+
+/**
+ * Integer behind a cursor, 0 if the value is malformed.
+ */
+static long cursor_int(json_cursor_t cursor) {
+    json_value_t *value = json_cursor_value(cursor, NULL);
+    return value != NULL ? value->value.integer : 0;
+}
+
+/**
+ * Lazy: reads three fields out of twitter.json, with load_json_lazy and cursors against load_json and
+ * json_object_get. The lazy document only decodes the fields that are read.
+ */
+void benchmark_lazy() {
+    struct timeval start_time, end_time;
+    long file_size;
+    char *file_contents = readFile("../benchmark_generation/twitter.json", &file_size);
+
+    double lazy_time = INT_MAX, dom_time = INT_MAX;
+    long lazy_sum = 0, dom_sum = 0;
+    for (int i = 0; i < 100; i++) {
+        gettimeofday(&start_time, NULL);
+        json_lazy_t *lazy = load_json_lazy(file_contents, file_size, NULL, NULL);
+        if (lazy == NULL) {
+            printf("could not index twitter.json\n");
+            break;
+        }
+        json_cursor_t root = json_lazy_root(lazy), metadata, count, statuses, status, id, user, followers;
+        bool found = json_cursor_object_get(root, "search_metadata", 15, &metadata)
+            && json_cursor_object_get(metadata, "count", 5, &count)
+            && json_cursor_object_get(root, "statuses", 8, &statuses)
+            && json_cursor_array_get(statuses, 50, &status)
+            && json_cursor_object_get(status, "id", 2, &id)
+            && json_cursor_object_get(status, "user", 4, &user)
+            && json_cursor_object_get(user, "followers_count", 15, &followers);
+        lazy_sum = found ? cursor_int(count) + cursor_int(id) + cursor_int(followers) : 0;
+        free_json_lazy(lazy);
+        gettimeofday(&end_time, NULL);
+
+        lazy_time = fmin(lazy_time, elapsed_ms(&start_time, &end_time));
+
+        gettimeofday(&start_time, NULL);
+        json_value_t *loaded_json = load_json_n(file_contents, file_size, NULL, NULL);
+        json_value_t *dom_status = json_array_get(json_object_get(loaded_json, "statuses", 8), 50);
+        dom_sum = json_object_get(json_object_get(loaded_json, "search_metadata", 15), "count", 5)->value.integer
+            + json_object_get(dom_status, "id", 2)->value.integer
+            + json_object_get(json_object_get(dom_status, "user", 4), "followers_count", 15)->value.integer;
+        free_json(loaded_json);
+        gettimeofday(&end_time, NULL);
+
+        dom_time = fmin(dom_time, elapsed_ms(&start_time, &end_time));
+    }
+
+    printf("===== lazy =====\n");
+    printf("load_json_lazy + 3 cursors: sum %ld in %lf ms\n", lazy_sum, lazy_time);
+    printf("load_json_n + 3 lookups: sum %ld in %lf ms\n", dom_sum, dom_time);
+
+    free(file_contents);
+}
+
+/**
+ * Nesting: an array of records that alternate objects and arrays 64 levels deep, the shape that
+ * stresses container handling rather than scalars. Also times how fast an adversarial payload of
+ * 10 million opening brackets is rejected by the default depth limit.
+ */
+void benchmark_nesting() {
+    struct timeval start_time, end_time;
+    int count = 20000;
+    int depth = 64;
+
+    char *corpus = (char *) malloc((size_t) count * (depth * 8 + 4) + 2);
+    char *p = corpus;
+    *p++ = '[';
+    for (int i = 0; i < count; i++) {
+        for (int d = 0; d < depth; d++) {
+            p += sprintf(p, d % 2 == 0 ? "{\"k\":" : "[%d,", d);
+        }
+        p += sprintf(p, "%d", i);
+        for (int d = depth - 1; d >= 0; d--) {
+            *p++ = d % 2 == 0 ? '}' : ']';
+        }
+        *p++ = i + 1 < count ? ',' : ']';
+    }
+    *p = '\0';
+    size_t corpus_size = (size_t) (p - corpus);
+
+    double best_time = INT_MAX;
+    for (int i = 0; i < 10; i++) {
+        gettimeofday(&start_time, NULL);
+        json_value_t *loaded_json = load_json_n(corpus, corpus_size, NULL, NULL);
+        gettimeofday(&end_time, NULL);
+
+        best_time = fmin(best_time, elapsed_ms(&start_time, &end_time));
+        free_json(loaded_json);
+    }
+
+    size_t brackets = 10000000;
+    char *adversarial = (char *) malloc(brackets);
+    memset(adversarial, '[', brackets);
+
+    json_parse_error_t error;
+    gettimeofday(&start_time, NULL);
+    json_value_t *rejected = load_json_n(adversarial, brackets, NULL, &error);
+    gettimeofday(&end_time, NULL);
+
+    double reject_time = elapsed_ms(&start_time, &end_time);
+
+    printf("===== nesting =====\n");
+    printf("Parsed %zu bytes nested %d deep in %lf ms (%.1lf MB/s)\n", corpus_size, depth, best_time, (corpus_size / (1024.0 * 1024.0)) / (best_time / 1000.0));
+    printf("%zu opening brackets: %s at byte %zu after %lf ms\n", brackets, rejected == NULL ? error.message : "accepted", rejected == NULL ? error.offset : 0, reject_time);
+
+    free(adversarial);
+    free(corpus);
+}
+
+/**
+ * Numeric corpus: a top level array of random doubles printed with 17 significant digits (enough
+ * to round trip) mixed with short decimals and exponents. Reports parse throughput and checks every
+ * parsed value bit for bit against strtod.
+ */
+void benchmark_floats() {
+    struct timeval start_time, end_time;
+    int count = 1000000;
+
+    char *corpus = (char *) malloc((size_t) count * 32 + 2);
+    char *p = corpus;
+    *p++ = '[';
+    srand(42);
+    for (int i = 0; i < count; i++) {
+        double value;
+        switch (i % 3) {
+            case 0: // full precision, any magnitude
+                value = ((double) rand() / RAND_MAX - 0.5) * pow(10, rand() % 600 - 300);
+                p += sprintf(p, "%.17g", value);
+                break;
+            case 1: // telemetry style short decimals
+                p += sprintf(p, "%d.%03d", rand() % 100000 - 50000, rand() % 1000);
+                break;
+            default: // small negative exponents
+                p += sprintf(p, "%de-%d", rand() % 100000, rand() % 20);
+                break;
+        }
+        *p++ = i + 1 < count ? ',' : ']';
+    }
+    *p = '\0';
+    size_t corpus_size = (size_t) (p - corpus);
+
+    double best_time = INT_MAX;
+    for (int i = 0; i < 10; i++) {
+        gettimeofday(&start_time, NULL);
+        json_value_t *loaded_json = load_json(corpus);
+        gettimeofday(&end_time, NULL);
+
+        best_time = fmin(best_time, elapsed_ms(&start_time, &end_time));
+        free_json(loaded_json);
+    }
+
+    // Verify every value round trips exactly
+    json_value_t *loaded_json = load_json(corpus);
+    int mismatches = 0;
+    char *number = corpus + 1;
+    for (size_t i = 0; i < json_array_size(loaded_json); i++) {
+        char *number_end;
+        double expected = strtod(number, &number_end);
+        json_value_t *value = json_array_get(loaded_json, i);
+        double parsed = value->type == JSON_FLOAT ? value->value.floating : (double) value->value.integer;
+        if (memcmp(&expected, &parsed, sizeof(double)) != 0) {
+            mismatches++;
+        }
+        number = number_end + 1;
+    }
+    free_json(loaded_json);
+
+    printf("===== float parsing =====\n");
+    printf("Parsed %zu bytes of numbers in %lf ms (%.1lf MB/s)\n", corpus_size, best_time, (corpus_size / (1024.0 * 1024.0)) / (best_time / 1000.0));
+    printf("Values not bit exact with strtod: %d / %d\n", mismatches, count);
+
+    free(corpus);
+}
+
+/**
+ * Integer corpus: objects holding 19 digit ids and 10 or 13 digit timestamps like the ones in our
+ * payloads. Reports parse throughput and checks every value against strtoll.
+ */
+void benchmark_integers() {
+    struct timeval start_time, end_time;
+    int count = 500000;
+
+    char *corpus = (char *) malloc((size_t) count * 64 + 2);
+    char *p = corpus;
+    *p++ = '[';
+    srand(42);
+    for (int i = 0; i < count; i++) {
+        long long id = ((long long) rand() << 32 | (long long) rand()) % 9000000000000000000LL + 1000000000000000000LL;
+        long long timestamp = 1600000000LL + rand() % 100000000;
+        if (i % 2) timestamp = timestamp * 1000 + rand() % 1000;
+        p += sprintf(p, "{\"id\":%lld,\"ts\":%lld}", id, timestamp);
+        *p++ = i + 1 < count ? ',' : ']';
+    }
+    *p = '\0';
+    size_t corpus_size = (size_t) (p - corpus);
+
+    double best_time = INT_MAX;
+    for (int i = 0; i < 10; i++) {
+        gettimeofday(&start_time, NULL);
+        json_value_t *loaded_json = load_json(corpus);
+        gettimeofday(&end_time, NULL);
+
+        best_time = fmin(best_time, elapsed_ms(&start_time, &end_time));
+        free_json(loaded_json);
+    }
+
+    // Verify every value against strtoll
+    json_value_t *loaded_json = load_json(corpus);
+    int mismatches = 0;
+    char *number = corpus;
+    for (size_t i = 0; i < json_array_size(loaded_json); i++) {
+        json_value_t *object = json_array_get(loaded_json, i);
+        json_value_t *id = json_object_get(object, "id", 2);
+        json_value_t *timestamp = json_object_get(object, "ts", 2);
+
+        number = strchr(number, ':') + 1;
+        mismatches += id->type != JSON_INT || id->value.integer != strtoll(number, &number, 10);
+        number = strchr(number, ':') + 1;
+        mismatches += timestamp->type != JSON_INT || timestamp->value.integer != strtoll(number, &number, 10);
+    }
+    free_json(loaded_json);
+
+    printf("===== integer parsing =====\n");
+    printf("Parsed %zu bytes of ids and timestamps in %lf ms (%.1lf MB/s)\n", corpus_size, best_time, (corpus_size / (1024.0 * 1024.0)) / (best_time / 1000.0));
+    printf("Values not equal to strtoll: %d / %d\n", mismatches, count * 2);
+
+    free(corpus);
+}
+
+/**
+ * Float formatting: dumps an array of a million doubles (full precision values of any magnitude,
+ * short telemetry style decimals and small values with negative exponents) and compares against
+ * formatting the same values with snprintf("%.17g"). Checks every dumped value reads back bit for
+ * bit with strtod.
+ */
+void benchmark_float_formatting() {
+    struct timeval start_time, end_time;
+    int count = 1000000;
+
+    double *values = (double *) malloc(count * sizeof(double));
+    json_value_t array = build_json_array(0);
+    srand(42);
+    for (int i = 0; i < count; i++) {
+        switch (i % 3) {
+            case 0: values[i] = ((double) rand() / RAND_MAX - 0.5) * pow(10, rand() % 600 - 300); break;
+            case 1: values[i] = (rand() % 100000000 - 50000000) / 1000.0; break;
+            default: values[i] = rand() % 100000 * pow(10, -(rand() % 20)); break;
+        }
+        json_array_append(&array, build_json_float(values[i]));
+    }
+
+    double dump_time = INT_MAX, snprintf_time = INT_MAX;
+    size_t dump_size = 0, snprintf_size = 0;
+    char buffer[32];
+    for (int i = 0; i < 10; i++) {
+        gettimeofday(&start_time, NULL);
+        char *dumped = dump_json_ex(&array, JSON_DUMP_MINIFIED, &dump_size);
+        gettimeofday(&end_time, NULL);
+        free(dumped);
+
+        dump_time = fmin(dump_time, elapsed_ms(&start_time, &end_time));
+
+        snprintf_size = 0;
+        gettimeofday(&start_time, NULL);
+        for (int j = 0; j < count; j++) {
+            snprintf_size += snprintf(buffer, sizeof(buffer), "%.17g", values[j]);
+        }
+        gettimeofday(&end_time, NULL);
+
+        snprintf_time = fmin(snprintf_time, elapsed_ms(&start_time, &end_time));
+    }
+
+    // Verify every value round trips exactly
+    char *dumped = dump_json(&array);
+    int mismatches = 0;
+    char *number = dumped + 1;
+    for (int i = 0; i < count; i++) {
+        double parsed = strtod(number, &number);
+        mismatches += memcmp(&parsed, &values[i], sizeof(double)) != 0;
+        number++;
+    }
+    free(dumped);
+
+    printf("===== float formatting =====\n");
+    printf("dump_json: %zu bytes in %lf ms (%.1lf MB/s)\n", dump_size, dump_time, (dump_size / (1024.0 * 1024.0)) / (dump_time / 1000.0));
+    printf("snprintf %%.17g: %zu bytes in %lf ms\n", snprintf_size, snprintf_time);
+    printf("Values not bit exact after strtod: %d / %d\n", mismatches, count);
+
+    free_json_children(&array);
+    free(values);
+}
+
+/**
+ * File loading: readFile (malloc + fread of the whole file) followed by load_json against
+ * load_json_file, which maps the file and parses straight from the mapping. Both include the
+ * file I/O in the timed region.
+ */
+void benchmark_file_loading() {
+    const char *path = "../benchmark_generation/generate/gened_output.json";
+    struct timeval start_time, end_time;
+    double read_time = INT_MAX, mmap_time = INT_MAX;
+    long file_size = 0;
+
+    for (int i = 0; i < 10; i++) {
+        gettimeofday(&start_time, NULL);
+        char *file_contents = readFile(path, &file_size);
+        json_value_t *loaded_json = load_json(file_contents);
+        gettimeofday(&end_time, NULL);
+        free_json(loaded_json);
+        free(file_contents);
+
+        read_time = fmin(read_time, elapsed_ms(&start_time, &end_time));
+
+        gettimeofday(&start_time, NULL);
+        loaded_json = load_json_file(path);
+        gettimeofday(&end_time, NULL);
+        free_json(loaded_json);
+
+        mmap_time = fmin(mmap_time, elapsed_ms(&start_time, &end_time));
+    }
+
+    printf("===== file loading =====\n");
+    printf("readFile + load_json: %lf ms (%.1lf MB/s)\n", read_time, (file_size / (1024.0 * 1024.0)) / (read_time / 1000.0));
+    printf("load_json_file (mmap): %lf ms (%.1lf MB/s)\n", mmap_time, (file_size / (1024.0 * 1024.0)) / (mmap_time / 1000.0));
+}
+
+static size_t count_values(const json_value_t *value) {
+    size_t count = 1;
+    if (value->type == JSON_ARRAY) {
+        for (size_t i = 0; i < json_array_size(value); i++) {
+            count += count_values(json_array_get(value, i));
+        }
+    } else if (value->type == JSON_OBJECT) {
+        for (size_t i = 0; i < json_object_size(value); i++) {
+            count += count_values(&value->value.object->entries[i].value);
+        }
+    }
+    return count;
+}
+
+/**
+ * Footprint: parses a file and reports how much of the document's arena its values, strings and
+ * containers take, and how much was allocated for it.
+ */
+void benchmark_footprint(const char *path) {
+    long file_size;
+    char *file_contents = readFile(path, &file_size);
+    json_value_t *json_parsed = load_json_n(file_contents, file_size, NULL, NULL);
+
+    // the root is the first member of its document
+    size_t used = 0, allocated = 0;
+    for (json_arena_block_t *block = ((json_document_t *) json_parsed)->arena.head; block != NULL; block = block->next) {
+        used += block->used;
+        allocated += sizeof(json_arena_block_t) + block->capacity;
+    }
+
+    printf("===== FOOTPRINT %s (%ld bytes) =====\n", path, file_size);
+    printf("%zu values, %zu byte nodes: %zu bytes used (%.2lf per input byte), %zu bytes allocated\n",
+        count_values(json_parsed), sizeof(json_value_t), used, (double) used / file_size, allocated);
+
+    free_json(json_parsed);
+    free(file_contents);
+}
+
+/**
+ * Adds up the bytes of every string value below value, counting the strings and how many of them
+ * are stored inline in their node.
+ */
+static uint64_t sum_strings(const json_value_t *value, size_t *strings, size_t *inline_strings) {
+    uint64_t sum = 0;
+    if (value->type == JSON_STRING) {
+        size_t size;
+        const char *string = json_string_get(value, &size);
+        for (size_t i = 0; i < size; i++) {
+            sum += (unsigned char) string[i];
+        }
+        *strings += 1;
+        *inline_strings += value->inline_size != 0;
+    } else if (value->type == JSON_ARRAY) {
+        for (size_t i = 0; i < json_array_size(value); i++) {
+            sum += sum_strings(json_array_get(value, i), strings, inline_strings);
+        }
+    } else if (value->type == JSON_OBJECT) {
+        for (size_t i = 0; i < json_object_size(value); i++) {
+            sum += sum_strings(&value->value.object->entries[i].value, strings, inline_strings);
+        }
+    }
+    return sum;
+}
+
+/**
+ * Strings: parses a file and reads back the bytes of every string value, the access pattern of
+ * iterating records. Strings of up to JSON_STRING_INLINE_MAX bytes are read from their node.
+ */
+void benchmark_strings(const char *path) {
+    struct timeval start_time, end_time;
+    long file_size;
+    char *file_contents = readFile(path, &file_size);
+    json_value_t *json_parsed = load_json_n(file_contents, file_size, NULL, NULL);
+
+    double best_time = INT_MAX;
+    size_t strings = 0, inline_strings = 0;
+    uint64_t sum = 0;
+    for (int i = 0; i < 10; i++) {
+        strings = 0;
+        inline_strings = 0;
+
+        gettimeofday(&start_time, NULL);
+        sum = sum_strings(json_parsed, &strings, &inline_strings);
+        gettimeofday(&end_time, NULL);
+
+        best_time = fmin(best_time, elapsed_ms(&start_time, &end_time));
+    }
+
+    printf("===== STRINGS %s (%ld bytes) =====\n", path, file_size);
+    printf("%zu strings, %zu stored inline: read back in %lf ms (byte sum %llu)\n", strings, inline_strings, best_time, (unsigned long long) sum);
+
+    free_json(json_parsed);
+    free(file_contents);
+}
+
+/**
+ * Key interning: parses the generated corpus with every key copied, with a per-parse intern table
+ * and with a shared table kept across runs, reporting parse time and arena footprint. Then looks up
+ * "bar" and "foo" in every record, once with string literals and once with the shared table's copies
+ * that match by pointer.
+ */
+void benchmark_intern() {
+    const char *path = "../benchmark_generation/generate/gened_output.json";
+    struct timeval start_time, end_time;
+    long file_size;
+    char *file_contents = readFile(path, &file_size);
+
+    json_intern_t *intern = json_intern_create();
+    json_parse_options_t copied = { JSON_PARSE_DEFAULT, 0, NULL };
+    json_parse_options_t per_parse = { JSON_PARSE_INTERN_KEYS, 0, NULL };
+    json_parse_options_t shared = { JSON_PARSE_DEFAULT, 0, intern };
+    const json_parse_options_t *configurations[] = { &copied, &per_parse, &shared };
+    const char *labels[] = { "copied keys", "per-parse table", "shared table" };
+
+    printf("===== KEY INTERNING %s (%ld bytes) =====\n", path, file_size);
+    for (int c = 0; c < 3; c++) {
+        double best_time = INT_MAX;
+        size_t used = 0, allocated = 0;
+        for (int i = 0; i < 10; i++) {
+            gettimeofday(&start_time, NULL);
+            json_value_t *json_parsed = load_json_n(file_contents, file_size, configurations[c], NULL);
+            gettimeofday(&end_time, NULL);
+
+            best_time = fmin(best_time, elapsed_ms(&start_time, &end_time));
+
+            used = 0;
+            allocated = 0;
+            for (json_arena_block_t *block = ((json_document_t *) json_parsed)->arena.head; block != NULL; block = block->next) {
+                used += block->used;
+                allocated += sizeof(json_arena_block_t) + block->capacity;
+            }
+            free_json(json_parsed);
+        }
+
+        printf("%s: %lf ms (%.1lf MB/s), %zu bytes used, %zu bytes allocated\n", labels[c], best_time,
+            (file_size / (1024.0 * 1024.0)) / (best_time / 1000.0), used, allocated);
+    }
+
+    json_value_t *json_parsed = load_json_n(file_contents, file_size, &shared, NULL);
+    const char *bar = json_intern(intern, "bar", 3);
+    const char *foo = json_intern(intern, "foo", 3);
+    size_t records = json_array_size(json_parsed);
+
+    double literal_time = INT_MAX, interned_time = INT_MAX;
+    long checksum = 0;
+    for (int i = 0; i < 10; i++) {
+        gettimeofday(&start_time, NULL);
+        for (size_t r = 0; r < records; r++) {
+            json_value_t *record = json_array_get(json_parsed, r);
+            checksum += json_object_get(record, "bar", 3) != NULL;
+            checksum += json_object_get(record, "foo", 3)->value.integer;
+        }
+        gettimeofday(&end_time, NULL);
+
+        literal_time = fmin(literal_time, elapsed_ms(&start_time, &end_time));
+
+        gettimeofday(&start_time, NULL);
+        for (size_t r = 0; r < records; r++) {
+            json_value_t *record = json_array_get(json_parsed, r);
+            checksum -= json_object_get(record, bar, 3) != NULL;
+            checksum -= json_object_get(record, foo, 3)->value.integer;
+        }
+        gettimeofday(&end_time, NULL);
+
+        interned_time = fmin(interned_time, elapsed_ms(&start_time, &end_time));
+    }
+
+    printf("%zu distinct keys, lookups over %zu records: literal keys %lf ms, interned keys %lf ms (checksum %ld)\n",
+        intern->size, records, literal_time, interned_time, checksum);
+
+    free_json(json_parsed);
+    json_intern_free(intern);
+    free(file_contents);
+}
+
+/**
+ * Tape: parses a file into a tree with load_json_n and into a tape with load_json_tape, and reports
+ * parse time, free time and the memory each representation holds on to.
+ */
+void benchmark_tape(const char *path) {
+    struct timeval start_time, end_time;
+    long file_size;
+    char *file_contents = readFile(path, &file_size);
+
+    double tree_time = INT_MAX, tree_free_time = INT_MAX, tape_time = INT_MAX, tape_free_time = INT_MAX;
+    size_t tree_bytes = 0, tape_bytes = 0;
+    for (int i = 0; i < 10; i++) {
+        gettimeofday(&start_time, NULL);
+        json_value_t *json_parsed = load_json_n(file_contents, file_size, NULL, NULL);
+        gettimeofday(&end_time, NULL);
+
+        tree_time = fmin(tree_time, elapsed_ms(&start_time, &end_time));
+
+        tree_bytes = 0;
+        for (json_arena_block_t *block = ((json_document_t *) json_parsed)->arena.head; block != NULL; block = block->next) {
+            tree_bytes += sizeof(json_arena_block_t) + block->capacity;
+        }
+
+        gettimeofday(&start_time, NULL);
+        free_json(json_parsed);
+        gettimeofday(&end_time, NULL);
+
+        tree_free_time = fmin(tree_free_time, elapsed_ms(&start_time, &end_time));
+
+        gettimeofday(&start_time, NULL);
+        json_tape_t *tape = load_json_tape(file_contents, file_size, NULL, NULL);
+        gettimeofday(&end_time, NULL);
+
+        tape_time = fmin(tape_time, elapsed_ms(&start_time, &end_time));
+
+        tape_bytes = sizeof(json_tape_t) + tape->size * sizeof(uint64_t) + tape->strings_size;
+
+        gettimeofday(&start_time, NULL);
+        free_json_tape(tape);
+        gettimeofday(&end_time, NULL);
+
+        tape_free_time = fmin(tape_free_time, elapsed_ms(&start_time, &end_time));
+    }
+
+    printf("===== TAPE %s (%ld bytes) =====\n", path, file_size);
+    printf("tree: parse %lf ms (%.1lf MB/s), free %lf ms, %zu bytes allocated\n", tree_time, (file_size / (1024.0 * 1024.0)) / (tree_time / 1000.0), tree_free_time, tree_bytes);
+    printf("tape: parse %lf ms (%.1lf MB/s), free %lf ms, %zu bytes allocated\n", tape_time, (file_size / (1024.0 * 1024.0)) / (tape_time / 1000.0), tape_free_time, tape_bytes);
+
+    free(file_contents);
+}
+
+/**
+ * Serializer: dumps an already parsed document minified and pretty printed and reports the output
+ * throughput.
+ */
+void benchmark_dump(const char *path) {
+    struct timeval start_time, end_time;
+    json_value_t *loaded_json = load_json_file(path);
+    if (loaded_json == NULL) {
+        printf("could not load %s\n", path);
+        return;
+    }
+
+    printf("===== dump_json %s =====\n", path);
+    const char *labels[] = { "minified", "pretty" };
+    unsigned int flags[] = { JSON_DUMP_MINIFIED, JSON_DUMP_PRETTY };
+    for (int mode = 0; mode < 2; mode++) {
+        double best_time = INT_MAX;
+        size_t dump_size = 0;
+        for (int i = 0; i < 50; i++) {
+            gettimeofday(&start_time, NULL);
+            char *dumped = dump_json_ex(loaded_json, flags[mode], &dump_size);
+            gettimeofday(&end_time, NULL);
+            free(dumped);
+
+            best_time = fmin(best_time, elapsed_ms(&start_time, &end_time));
+        }
+        printf("%s: %zu bytes in %lf ms (%.1lf MB/s)\n", labels[mode], dump_size, best_time, (dump_size / (1024.0 * 1024.0)) / (best_time / 1000.0));
+    }
+
+    free_json(loaded_json);
+}
+
+/**
+ * Printer: prints the generated corpus pretty printed to /dev/null through a stdio stream and
+ * through a file descriptor writer, both buffered by json_writer_t.
+ */
+void benchmark_print() {
+    const char *path = "../benchmark_generation/generate/gened_output.json";
+    struct timeval start_time, end_time;
+    json_value_t *loaded_json = load_json_file(path);
+    FILE *null_file = fopen("/dev/null", "w");
+    if (loaded_json == NULL || null_file == NULL) {
+        printf("could not set up print benchmark\n");
+        return;
+    }
+
+    printf("===== print_json_value =====\n");
+    const char *labels[] = { "FILE* writer", "fd writer" };
+    for (int mode = 0; mode < 2; mode++) {
+        double best_time = INT_MAX;
+        for (int i = 0; i < 5; i++) {
+            gettimeofday(&start_time, NULL);
+            if (mode == 0) {
+                fprint_json_value(null_file, *loaded_json);
+                fflush(null_file);
+            } else {
+                json_writer_t writer;
+                json_writer_init_fd(&writer, fileno(null_file));
+                print_json_value_to(&writer, *loaded_json);
+                json_writer_close(&writer);
+            }
+            gettimeofday(&end_time, NULL);
+
+            best_time = fmin(best_time, elapsed_ms(&start_time, &end_time));
+        }
+        printf("%s: %lf ms\n", labels[mode], best_time);
+    }
+
+    fclose(null_file);
+    free_json(loaded_json);
 }
 
 // Define ReaD Time Stamp Counter  (RDTSC) instructions for benchmarking cycles 
@@ -112,7 +1027,7 @@ void benchmark_throughput() {
     } while (0)
 
 void benchmark_cycles() {
-    uint64_t cycles_start, cycles_final, cycles_diff, min_diff;
+    uint64_t cycles_start, cycles_final, cycles_diff, min_diff = UINT64_MAX;
 
 	long* file_size = (long *) malloc(sizeof(long)); // make sure to allocate memory
 	char* file_contents = readFile("../benchmark_generation/generate/gened_output.json", file_size);
@@ -132,19 +1047,61 @@ void benchmark_cycles() {
             min_diff = cycles_diff;
         }
 
-        printf("Cycles elapsed: %llu\n", cycles_diff);
+        printf("Cycles elapsed: %llu\n", (unsigned long long) cycles_diff);
         free_json(loaded_json);
 	}
 
-    free(file_size);
-    free(file_contents);
     float per_byte = min_diff / (double) *file_size;
     printf("%.2f cycles per byte", per_byte);
     printf("\n");
+
+    free(file_size);
+    free(file_contents);
 }
 
 int main() {
-    benchmark_throughput();
+    // baseline recursive descent, skips white space byte by byte
+    benchmark_throughput("recursive descent", NULL);
+
+    // SIMD stage 1 builds a structural index the recursive descent jumps through
+    json_parse_options_t structural_index = { JSON_PARSE_STRUCTURAL_INDEX, 0, NULL };
+    benchmark_throughput("structural index", &structural_index);
+
+    // strings decoded in place inside the input, no copies into the arena
+    json_parse_options_t insitu = { JSON_PARSE_INSITU, 0, NULL };
+    benchmark_throughput("in situ", &insitu);
+
+    benchmark_file_loading();
+
+    benchmark_sax();
+    benchmark_stream();
+
+    benchmark_lines();
+    benchmark_parallel();
+
+    benchmark_lazy();
+
+    benchmark_validate("../benchmark_generation/generate/gened_output.json");
+    benchmark_validate("../benchmark_generation/twitter.json");
+
+    benchmark_footprint("../benchmark_generation/twitter.json");
+    benchmark_footprint("../benchmark_generation/generate/gened_output.json");
+    benchmark_strings("../benchmark_generation/twitter.json");
+    benchmark_strings("../benchmark_generation/generate/gened_output.json");
+    benchmark_intern();
+    benchmark_tape("../benchmark_generation/twitter.json");
+    benchmark_tape("../benchmark_generation/generate/gened_output.json");
+
+    benchmark_dump("../benchmark_generation/twitter.json");
+    benchmark_dump("../benchmark_generation/gists.json");
+
+    benchmark_print();
+
+    benchmark_nesting();
+
+    benchmark_floats();
+    benchmark_float_formatting();
+    benchmark_integers();
 
     benchmark_cycles();
 
@@ -8,9 +8,44 @@
 #include <ctype.h>
 #include <math.h>
 #include <stdint.h>
+#include <limits.h>
+
+// load_json_file maps regular files on POSIX systems and reads everything else with stdio
+#if defined(__unix__) || defined(__APPLE__)
+#define JSON_HAS_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+// load_json_lines parses records on POSIX threads, everywhere else it parses on the calling thread
+#if (defined(__unix__) || defined(__APPLE__)) && (defined(__GNUC__) || defined(__clang__)) && !defined(JAJSON_NO_THREADS)
+#define JSON_HAS_THREADS 1
+#include <pthread.h>
+#endif
+
+// SIMD engines are picked at compile time (-mavx2, -msse2, -march=native, ...).
+// Define JAJSON_NO_SIMD before including jajson.h to force the scalar fallback.
+#if !defined(JAJSON_NO_SIMD) && defined(__AVX2__)
+#define JSON_SIMD_AVX2 1
+#include <immintrin.h>
+#elif !defined(JAJSON_NO_SIMD) && defined(__SSE2__)
+#define JSON_SIMD_SSE2 1
+#include <emmintrin.h>
+#if defined(__PCLMUL__)
+#include <wmmintrin.h>
+#endif
+#endif
 
 // #define long long int
 #define JSON_NULL_VALUE 0
+#define JSON_SMALLEST_POWER_OF_TEN -342 // decimal exponents below this always round to zero
+#define JSON_LARGEST_POWER_OF_TEN 308   // decimal exponents above this always round to infinity
+#define JSON_LARGEST_POWER_OF_FIVE 325  // largest power of five the shortest float formatter needs (subnormals)
+#define JSON_VALIDATE_MAX_DEPTH 1024    // deepest nesting json_validate accepts, a multiple of 64
+#define JSON_MAX_DEPTH 1024             // deepest nesting the parser accepts unless json_parse_options_t says otherwise
 
 /**
 project level comments:
@@ -42,17 +77,14 @@ typedef enum json_types_s
 } json_types_t;
 
 typedef struct json_string_s json_string_t;
-typedef struct json_int_s json_int_t;
-typedef struct json_float_s json_float_t;
-typedef struct json_bool_s json_bool_t;
-typedef struct json_null_s json_null_t;
 typedef struct json_object_s json_object_t;
+typedef struct json_object_entry_s json_object_entry_t;
 typedef struct json_array_s json_array_t;
 typedef union json_element_s json_element_t;
 typedef struct json_value_s json_value_t;
 
 /**
- * \brief struct defining json string type
+ * \brief struct defining json string type, the bytes of a json string together with their length
  */
 struct json_string_s
 {
@@ -61,89 +93,629 @@ struct json_string_s
 };
 
 /**
- * \brief struct defining json int type
+ * \brief union defining json element type. A json element in jajson.h defines the
+ * possible values a json_value_t type can carry. Scalars are stored inline, strings and
+ * containers through a pointer.
+ *
+ * NOTE: Union is retrieved based on value name
+ */
+union json_element_s
+{
+    const char *string; // null terminated, its length is the size of the json_value_t. Only for strings stored out of line
+    long integer;
+    double floating;
+    bool boolean;
+    struct json_object_s *object;
+    struct json_array_s *array;
+};
+
+#define JSON_STRING_INLINE_MAX 12 // longest string kept inside its node, the node's first 13 bytes hold it and its null
+
+/**
+ * \brief struct defining json value type. json_value_t is the user-interfacing json type
+ * for users. Every value is a single 16 byte node holding its payload or child pointer, the
+ * length of a string and the type tag, so reading a scalar never follows a pointer. Strings of
+ * up to JSON_STRING_INLINE_MAX bytes are stored inside the node itself, read strings through
+ * json_string_get rather than value.string.
+ */
+struct json_value_s
+{
+    union json_element_s value;
+    uint32_t size;             // length of a string stored out of line in bytes, not counting the null termination character
+    char inline_end;           // an inline string runs over value and size into this byte
+    unsigned char inline_size; // length + 1 of a string stored inline, 0 if the string is stored out of line
+    unsigned char type;        // json_types_t
+    unsigned char flags;       // json_value_flags_t, describes who owns the memory of this value
+};
+
+// Objects below this many members are searched linearly instead of through a hash index
+#define JSON_OBJECT_INDEX_THRESHOLD 8
+
+/**
+ * \brief struct defining a single key-value pair of a json object
+ */
+struct json_object_entry_s
+{
+    const char *key;
+    size_t key_size; // length of key, not counting the null termination character
+    struct json_value_s value;
+};
+
+/**
+ * \brief struct defining json object type. Members are stored contiguously in insertion order,
+ * objects with at least JSON_OBJECT_INDEX_THRESHOLD members also carry an open addressing hash
+ * index into the member array.
  */
-struct json_int_s
+struct json_object_s
 {
-    long value;
+    struct json_object_entry_s *entries;
     size_t size;
+    uint32_t *index;   // slot holds position of entry + 1, 0 marks an empty slot. NULL for small objects
+    size_t index_mask; // number of slots in index - 1, number of slots is a power of two
 };
 
 /**
- * \brief struct defining json float type
+ * \brief struct defining json array type. Elements are stored contiguously in order.
  */
-struct json_float_s
+struct json_array_s
 {
-    double value;
+    struct json_value_s *values;
     size_t size;
-} ;
+    size_t capacity; // number of elements values has room for, equal to size for parsed arrays
+};
+
+/**
+ * \brief enum type describing who owns the memory behind a json_value_t
+ */
+typedef enum json_value_flags_s
+{
+    JSON_VALUE_HEAP = 0,     // value was built node by node with calloc (build_json_*), free_json walks it
+    JSON_VALUE_ARENA = 1,    // value lives in an arena, it is released together with its document
+    JSON_VALUE_DOCUMENT = 2  // value is the root of a document returned by load_json and owns the arena
+} json_value_flags_t;
+
+// ================== ARENA RELATED START =================
+#define JSON_ARENA_ALIGNMENT 8
+#define JSON_ARENA_MIN_BLOCK_SIZE ((size_t) 4096)
+#define JSON_ARENA_MAX_BLOCK_SIZE ((size_t) 8 << 20)
+#define JSON_STRING_RESERVE 64 // free space kept ahead of the string reader: one vector, one escape and a null
+#define JSON_PARSER_STACK_SIZE 64 // open containers the parser tracks on the C stack before its stack moves to the heap
+
+typedef struct json_arena_block_s json_arena_block_t;
+typedef struct json_arena_s json_arena_t;
+typedef struct json_document_s json_document_t;
+typedef struct json_parser_s json_parser_t;
+typedef struct json_parser_frame_s json_parser_frame_t;
+typedef struct json_parse_error_s json_parse_error_t;
+typedef struct json_sax_handler_s json_sax_handler_t;
+typedef struct json_builder_s json_builder_t;
+typedef struct json_builder_frame_s json_builder_frame_t;
+
+/**
+ * \brief struct defining a single block of memory owned by an arena. Block data directly
+ * follows the header.
+ */
+struct json_arena_block_s
+{
+    struct json_arena_block_s *next; // pointer to previously filled block
+    size_t capacity;
+    size_t used;
+};
+
+/**
+ * \brief struct defining a bump allocator. Memory handed out by an arena can not be freed
+ * individually, all of it is released at once with json_arena_free.
+ */
+struct json_arena_s
+{
+    struct json_arena_block_s *head; // block that is currently bump allocated from
+    size_t next_block_size;          // grows geometrically up to JSON_ARENA_MAX_BLOCK_SIZE
+};
+
+/**
+ * \brief struct defining a document returned by load_json. The root value is the first member
+ * so a pointer to the root is also a pointer to its document.
+ */
+struct json_document_s
+{
+    struct json_value_s root;
+    struct json_arena_s arena;
+};
+
+/**
+ * \brief struct describing why load_json_n rejected its input
+ */
+struct json_parse_error_s
+{
+    const char *message; // static description of the error, NULL if the input was parsed
+    size_t offset;       // byte offset into the input where the error was detected
+};
+
+/**
+ * \brief struct defining the state threaded through the recursive descent parser
+ */
+struct json_parser_s
+{
+    const struct json_sax_handler_s *handler; // receives an event for every token
+    void *user;                 // passed through to every callback of handler
+    struct json_arena_s *arena; // strings are decoded into here, NULL to borrow them from the input instead
+    char *scratch;              // decoded strings with escapes when there is no arena, reused for every string
+    size_t scratch_capacity;
+    char *input;                // start of the input, structural positions are relative to it
+    const char *end;            // end of the input, nothing at or after it is part of the document
+    const char *readable_end;   // end of the memory vector loads may touch, end + JSON_PADDING for padded input
+    uint32_t *structurals;      // stage 1 index of token starts, NULL when white space is skipped byte by byte
+    size_t structural_cursor;   // first structural position that has not been skipped over yet
+    bool insitu;                // strings are decoded in place inside the input instead of copied into the arena
+    struct json_intern_s *intern; // object keys are looked up here and handed out as the stored copy, NULL to copy every key
+    size_t max_depth;           // deepest nesting of objects and arrays accepted, counted from the value the parse starts at
+    json_parse_error_t error;   // first error found, parsing stops there
+};
+
+/**
+ * \brief enum type defining what a value starting with a given byte is, see json_value_classes
+ */
+typedef enum json_value_class_s
+{
+    JSON_VALUE_CLASS_INVALID = 0,
+    JSON_VALUE_CLASS_STRING,
+    JSON_VALUE_CLASS_SINGLE_QUOTED_STRING,
+    JSON_VALUE_CLASS_NUMBER,
+    JSON_VALUE_CLASS_OBJECT,
+    JSON_VALUE_CLASS_ARRAY,
+    JSON_VALUE_CLASS_TRUE,
+    JSON_VALUE_CLASS_FALSE,
+    JSON_VALUE_CLASS_NULL
+} json_value_class_t;
+
+/**
+ * \brief struct defining an object or array the parser is inside of
+ */
+struct json_parser_frame_s
+{
+    size_t size; // members read so far
+    bool is_object;
+};
+
+/**
+ * \brief struct defining an open container of the document load_json is building
+ */
+struct json_builder_frame_s
+{
+    size_t stack_start; // offset on the builder stack where the members of this container start
+    bool is_object;
+    const char *key;    // key of this container in its parent object
+    size_t key_size;
+};
+
+/**
+ * \brief struct defining the state of the DOM builder, the SAX client behind load_json
+ */
+struct json_builder_s
+{
+    struct json_document_s *document; // every node of the document is allocated from its arena
+    char *stack;                      // scratch space collecting members of containers that are still open
+    size_t stack_size;
+    size_t stack_capacity;
+    struct json_builder_frame_s *frames; // containers that are still open, innermost last
+    size_t depth;
+    size_t frames_capacity;
+    const char *key;                  // key of the object member whose value comes next
+    size_t key_size;
+    const char *failure;              // why the builder stopped the parse, NULL while all is well
+};
+// ================== ARENA RELATED END =================
+
+// ================== PARSE OPTIONS START =================
+#define JSON_PADDING 64 // bytes that must be readable after input parsed with JSON_PARSE_PADDED
+
+typedef struct json_parse_options_s json_parse_options_t;
+typedef struct json_block_s json_block_t;
+
+/**
+ * \brief enum type defining flags that change how load_json_ex parses its input
+ */
+typedef enum json_parse_flags_s
+{
+    JSON_PARSE_DEFAULT = 0,
+    JSON_PARSE_STRUCTURAL_INDEX = 1 << 0, // run the SIMD structural index stage before the recursive descent
+    JSON_PARSE_INSITU = 1 << 1,           // decode strings in place inside the input, see load_json_insitu
+    JSON_PARSE_PADDED = 1 << 2,           // JSON_PADDING readable bytes of any value follow the input, see load_json_n
+    JSON_PARSE_INTERN_KEYS = 1 << 3       // store each distinct object key once per document, see json_intern_t
+} json_parse_flags_t;
+
+/**
+ * \brief struct defining options for load_json_ex
+ */
+struct json_parse_options_s
+{
+    unsigned int flags; // json_parse_flags_t values or'ed together
+    size_t max_depth;   // deepest nesting of objects and arrays accepted, 0 for JSON_MAX_DEPTH
+    struct json_intern_s *intern; // long lived table object keys are interned into, NULL for none. Must outlive the documents
+};
+
+/**
+ * \brief struct defining the character classes found in a 64 byte block of input, bit i
+ * describes byte i of the block
+ */
+struct json_block_s
+{
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t white_space;
+    uint64_t op; // structural characters { } [ ] : ,
+};
+// ================== PARSE OPTIONS END =================
+
+// ================== SAX START =================
+/**
+ * \brief struct defining the callbacks of a SAX parse, see json_sax_parse. Every callback may be
+ * NULL, the event is skipped then. A callback returning false stops the parse.
+ *
+ * Strings and keys are not null terminated and only valid during the callback: strings without
+ * escapes point straight into the input, strings with escapes are decoded into a buffer that is
+ * reused for the next string.
+ */
+struct json_sax_handler_s
+{
+    bool (*on_object_begin)(void *user);
+    bool (*on_key)(void *user, const char *key, size_t size);
+    bool (*on_object_end)(void *user, size_t size); // size is the number of members
+    bool (*on_array_begin)(void *user);
+    bool (*on_array_end)(void *user, size_t size);  // size is the number of elements
+    bool (*on_string)(void *user, const char *string, size_t size);
+    bool (*on_int)(void *user, long value);
+    bool (*on_float)(void *user, double value);
+    bool (*on_bool)(void *user, bool value);
+    bool (*on_null)(void *user);
+};
+// ================== SAX END =================
+
+// ================== INTERN START =================
+#define JSON_INTERN_MIN_SLOTS 64 // slots of an intern table when its first key arrives
+
+typedef struct json_intern_s json_intern_t;
+typedef struct json_intern_entry_s json_intern_entry_t;
+
+/**
+ * \brief struct defining a stored key of an intern table
+ */
+struct json_intern_entry_s
+{
+    const char *key; // stored copy, null terminated. NULL marks an empty slot
+    uint32_t key_size;
+    uint32_t hash;   // low bits of json_hash_key, kept so growing never rehashes the bytes
+};
+
+/**
+ * \brief struct defining a key intern table: every distinct key is stored once and parses that
+ * use the table hand out that one copy for each occurrence, so equal keys share a pointer.
+ */
+struct json_intern_s
+{
+    struct json_intern_entry_s *entries; // open addressing, load factor kept at or below 1/2
+    size_t size;                         // distinct keys stored
+    size_t mask;                         // number of slots - 1, 0 before the first key
+    struct json_arena_s *arena;          // receives the stored keys: storage, or the document of a per-parse table
+    struct json_arena_s storage;         // owned by tables from json_intern_create, unused otherwise
+};
+// ================== INTERN END =================
+
+// ================== LAZY START =================
+#define JSON_LAZY_INVALID ((size_t) -1) // token position returned when a walk over the structural index runs off its container
+
+typedef struct json_lazy_s json_lazy_t;
+typedef struct json_cursor_s json_cursor_t;
+
+/**
+ * \brief struct defining a document returned by load_json_lazy. Only the structure of the input is
+ * indexed up front, values are decoded when a cursor pointing at them is materialized.
+ */
+struct json_lazy_s
+{
+    struct json_document_s document; // arena receiving materialized values, its root is scratch space of the builder
+    struct json_parser_s parser;     // input, bounds and structural index, reused for every materialization
+    struct json_builder_s builder;   // DOM builder materialized subtrees are fed through
+};
+
+/**
+ * \brief struct defining a handle to a value of a lazy document that has not been decoded yet.
+ * Cursors are plain values, copying one is free and it stays valid as long as its document.
+ */
+struct json_cursor_s
+{
+    struct json_lazy_s *document;
+    size_t token; // position of the first token of the value in the structural index of the document
+};
+// ================== LAZY END =================
+
+// ================== STREAM START =================
+typedef struct json_stream_s json_stream_t;
+typedef struct json_stream_frame_s json_stream_frame_t;
+
+/**
+ * \brief function type receiving the values completed by a stream set up with json_stream_init_values
+ *
+ * \param[in] user pointer handed to json_stream_init_values
+ * \param[in] value completed value, a document now owned by the callee and released with free_json
+ *
+ * \return true to keep parsing, false to stop the stream
+ */
+typedef bool (*json_stream_value_callback_t)(void *user, json_value_t *value);
+
+/**
+ * \brief enum type defining flags that change what a json_stream_t accepts
+ */
+typedef enum json_stream_flags_s
+{
+    JSON_STREAM_DEFAULT = 0,
+    JSON_STREAM_MULTIPLE_VALUES = 1 << 0 // any number of root values separated by white space, such as NDJSON
+} json_stream_flags_t;
+
+/**
+ * \brief enum type defining what a json_stream_t expects next
+ */
+typedef enum json_stream_state_s
+{
+    JSON_STREAM_VALUE = 0,        // a value: start of input and after ':'
+    JSON_STREAM_VALUE_OR_END = 1, // a value or ']': after '[' and after ',' in arrays
+    JSON_STREAM_KEY_OR_END = 2,   // a key or '}': after '{' and after ',' in objects
+    JSON_STREAM_COLON = 3,        // ':' after a key
+    JSON_STREAM_COMMA_OR_END = 4, // ',' or the closing bracket after a value inside a container
+    JSON_STREAM_DONE = 5          // the root value is complete, only white space may follow
+} json_stream_state_t;
+
+/**
+ * \brief enum type defining the kind of token a json_stream_t holds back because a chunk ended in it
+ */
+typedef enum json_stream_token_s
+{
+    JSON_STREAM_TOKEN_NONE = 0,
+    JSON_STREAM_TOKEN_STRING = 1, // string value, waiting for its closing quote
+    JSON_STREAM_TOKEN_KEY = 2,    // object key, waiting for its closing quote
+    JSON_STREAM_TOKEN_SCALAR = 3  // number or literal, waiting for the byte that ends it
+} json_stream_token_t;
+
+/**
+ * \brief struct defining an open container of a json_stream_t
+ */
+struct json_stream_frame_s
+{
+    size_t size; // members or elements completed so far
+    bool is_object;
+};
+
+/**
+ * \brief struct defining the state of an incremental parser. Input is fed in chunks of any size with
+ * json_stream_feed, events are delivered as soon as the tokens behind them are complete. Only the open
+ * containers and a token split across chunks are kept between chunks.
+ *
+ * NOTE: the stream points into itself once initialized, it must not be moved
+ */
+struct json_stream_s
+{
+    struct json_parser_s parser;        // parses complete tokens, pointed at the current chunk or at token_buffer
+    const struct json_sax_handler_s *handler; // receives the events of values at or below emit_depth
+    void *user;
+    unsigned int flags;                 // json_stream_flags_t values or'ed together
+    enum json_stream_state_s state;
+    struct json_stream_frame_s *frames; // containers that are still open, innermost last
+    size_t depth;
+    size_t frames_capacity;
+    size_t max_depth;                   // deepest nesting of objects and arrays accepted, JSON_MAX_DEPTH unless set after init
+    enum json_stream_token_s token;     // kind of the token split across chunks
+    char *token_buffer;                 // bytes of that token received so far
+    size_t token_size;
+    size_t token_capacity;
+    size_t token_offset;                // stream offset of the first byte of that token
+    char quote;                         // quote style of the string being scanned
+    bool escaped;                       // the string being scanned was cut right after a backslash
+    size_t offset;                      // stream offset of the current chunk
+    size_t base;                        // stream offset of the buffer the parser points at
+    size_t emit_depth;                  // nesting depth of the values handed to on_value
+    json_stream_value_callback_t on_value; // NULL for a SAX stream
+    void *value_user;
+    struct json_builder_s builder;      // builds the value handed to on_value next
+    json_parse_error_t error;           // first error found, the stream rejects everything after it
+};
+// ================== STREAM END =================
+
+// ================== LINES START =================
+#define JSON_LINES_BATCH 64 // records a worker of load_json_lines claims at a time
+
+typedef struct json_lines_s json_lines_t;
+typedef struct json_lines_job_s json_lines_job_t;
+typedef struct json_lines_worker_s json_lines_worker_t;
 
 /**
- * \brief struct defining json bool type
+ * \brief struct defining the records returned by load_json_lines. Record i of the input is values[i],
+ * every node of a record lives in the arena of the worker that parsed it.
  */
-struct json_bool_s
+struct json_lines_s
 {
-    bool value;
+    struct json_value_s *values; // roots of the records in input order, flagged JSON_VALUE_ARENA
     size_t size;
+    struct json_arena_s *arenas; // one arena per worker, released together by free_json_lines
+    size_t arena_count;
 };
 
 /**
- * \brief struct defining json null type
+ * \brief struct defining the work shared by the workers of load_json_lines and json_cursor_value_parallel
  */
-struct json_null_s
+struct json_lines_job_s
 {
-    short value; // will only contain the json_null value
+    const char *json;
     size_t size;
+    unsigned int flags;          // json_parse_flags_t every record is parsed with
+    size_t max_depth;            // deepest nesting accepted inside a record
+    const size_t *records;       // start and end offset of every record
+    const uint32_t *structurals; // structural index of the whole input shared by the records, NULL to parse them on their own
+    const size_t *tokens;        // position of every record in structurals
+    size_t record_count;
+    struct json_value_s *values; // receives the root of record i at position i
+    size_t next_record;          // first record no worker has claimed yet, advanced atomically
+    size_t failed;               // lowest record found malformed so far, record_count if none
 };
 
-// TODO: key value pair, implement with linked list? then try hash table?
 /**
- * \brief struct defining json object type
+ * \brief struct defining the state of one worker of load_json_lines
  */
-struct json_object_s
+struct json_lines_worker_s
 {
-    const char *key;
-    struct json_value_s *value;
-    struct json_object_s *next; // pointer to next element in linked list
+    struct json_lines_job_s *job;
+    struct json_document_s document; // arena shared by every record the worker parses, the root is scratch space
+    struct json_intern_s intern;     // keys of every record the worker parses with JSON_PARSE_INTERN_KEYS, stored in document
+    size_t error_record;             // first record the worker found malformed, record_count if none
+    struct json_parse_error_s error; // why, with the offset into the whole input
 };
+// ================== LINES END =================
+
+// ================== TAPE START =================
+#define JSON_TAPE_PAYLOAD_MASK ((UINT64_C(1) << 56) - 1) // low 56 bits of a tape word, the tag is in the top 8 bits
+#define JSON_TAPE_COUNT_MAX ((size_t) 0xFFFFFF)          // member counts of containers saturate here
+#define JSON_TAPE_INVALID ((size_t) -1)
+
+typedef struct json_tape_s json_tape_t;
+typedef struct json_tape_builder_s json_tape_builder_t;
 
 /**
- * \brief struct defining json array type
+ * \brief enum type defining the tag in the top 8 bits of every tape word
  */
-struct json_array_s
+typedef enum json_tape_tags_s
 {
-    struct json_value_s *value;
-    struct json_array_s *next; // pointer to next element in linked list
+    JSON_TAPE_ROOT = 'r',         // first and last word, the first one points past the last
+    JSON_TAPE_OBJECT_BEGIN = '{', // payload: member count << 32 | index of the word after the matching '}'
+    JSON_TAPE_OBJECT_END = '}',   // payload: index of the matching '{'
+    JSON_TAPE_ARRAY_BEGIN = '[',  // payload: element count << 32 | index of the word after the matching ']'
+    JSON_TAPE_ARRAY_END = ']',    // payload: index of the matching '['
+    JSON_TAPE_STRING = '"',       // payload: offset of the string in the string buffer, keys are strings too
+    JSON_TAPE_INT = 'l',          // the next word holds the value
+    JSON_TAPE_FLOAT = 'd',        // the next word holds the bits of the value
+    JSON_TAPE_TRUE = 't',
+    JSON_TAPE_FALSE = 'f',
+    JSON_TAPE_NULL = 'n'
+} json_tape_tags_t;
+
+/**
+ * \brief struct defining a document flattened into a tape: one array of 64 bit words that lists
+ * the values in document order, plus a buffer holding every string as a 32 bit length, the bytes
+ * and a null termination character. The root value starts at index 1. A tape is two allocations,
+ * the words are stored right behind this header.
+ */
+struct json_tape_s
+{
+    char *strings;       // string buffer, the second allocation
+    size_t strings_size; // bytes used in strings
+    size_t size;         // number of words
+    uint64_t words[];
 };
 
 /**
- * \brief union defining json element type. A json element in jajson.h defines the
- * possible values a json_value_t type can carry
- *
- * NOTE: Union is retrieved based on value name
+ * \brief struct defining the state of the tape builder, the SAX client behind load_json_tape
  */
-union json_element_s
+struct json_tape_builder_s
 {
-    struct json_string_s string;
-    struct json_int_s integer;
-    struct json_float_s floating;
-    struct json_bool_s boolean;
-    struct json_null_s null;
-    struct json_object_s *object;
-    struct json_array_s *array;
+    struct json_tape_s *tape;    // grown while parsing, trimmed once the document is complete
+    size_t capacity;             // number of words tape has room for
+    size_t strings_capacity;
+    size_t *open;                // index of the begin word of every container that is still open
+    size_t depth;
+    size_t open_capacity;
+    const char *failure;         // why the builder stopped the parse, NULL while all is well
 };
+// ================== TAPE END =================
+
+// ================== DUMP OPTIONS START =================
+#define JSON_DUMP_INDENT 4 // spaces per nesting level in pretty output, same as print_json_value
 
 /**
- * \brief struct defining json value type. json_value_t is the user-interfacing json type
- * for users
+ * \brief enum type defining flags that change how dump_json_ex formats its output
  */
-struct json_value_s
+typedef enum json_dump_flags_s
+{
+    JSON_DUMP_MINIFIED = 0,    // no white space at all
+    JSON_DUMP_PRETTY = 1 << 0  // one member per line, nested values indented by JSON_DUMP_INDENT spaces
+} json_dump_flags_t;
+// ================== DUMP OPTIONS END =================
+
+// ================== WRITER START =================
+#define JSON_WRITER_BUFFER_SIZE ((size_t) 64 << 10) // bytes collected before a writer flushes to its sink
+
+typedef struct json_writer_s json_writer_t;
+
+/**
+ * \brief function type receiving the output of a callback writer
+ *
+ * \param[in] user pointer handed to json_writer_init_callback
+ * \param[in] data bytes to consume
+ * \param[in] size number of bytes
+ *
+ * \return true if all bytes were consumed, false to mark the writer as failed
+ */
+typedef bool (*json_write_callback_t)(void *user, const char *data, size_t size);
+
+/**
+ * \brief enum type defining where a json_writer_t flushes its buffer to
+ */
+typedef enum json_writer_sink_s
 {
-    union json_element_s *value;
-    enum json_types_s type;
+    JSON_WRITER_FILE = 0,    // stdio stream, written with fwrite
+    JSON_WRITER_FD = 1,      // file descriptor, written with write (POSIX only)
+    JSON_WRITER_CALLBACK = 2 // user callback
+} json_writer_sink_t;
+
+/**
+ * \brief struct defining a buffered output sink. Output is collected in one large buffer and handed
+ * to the sink in JSON_WRITER_BUFFER_SIZE pieces instead of one call per token.
+ */
+struct json_writer_s
+{
+    char *buffer;
+    size_t size;     // number of bytes waiting in buffer
+    size_t capacity;
+    enum json_writer_sink_s sink;
+    FILE *file;
+    int fd;
+    json_write_callback_t callback;
+    void *user;
+    bool failed;     // a flush to the sink failed, later output is dropped
 };
+// ================== WRITER END =================
 
 // Function init (for function docstrings, see function implementation)
+//===== ARENA INIT =====
+void json_arena_init(json_arena_t *arena, size_t initial_block_size);
+void* json_arena_alloc(json_arena_t *arena, size_t size);
+void json_arena_free(json_arena_t *arena);
+static void json_arena_merge(json_arena_t *arena, json_arena_t *other);
+static char* json_arena_reserve(json_arena_t *arena, size_t size, size_t *available);
+static void json_arena_commit(json_arena_t *arena, size_t size);
+static void json_arena_unwind(json_arena_t *arena, const char *memory, size_t size);
+//===== END ARENA INIT =====
+
+//===== STRUCTURAL INDEX INIT =====
+static int json_ctz64(uint64_t bits);
+static int json_clz64(uint64_t bits);
+static uint64_t json_prefix_xor(uint64_t bits);
+static void json_classify_block(const char *in, json_block_t *block);
+static uint64_t json_escaped_bits(uint64_t backslash, uint64_t *prev_escaped);
+static uint32_t* json_build_structural_index(const char *json, size_t size, bool padded);
+//===== END STRUCTURAL INDEX INIT =====
+
+//===== ACCESS JSON INIT =====
+static uint64_t json_hash_key(const char *key, size_t key_size);
+static void json_object_build_index(json_object_t *json_object, uint32_t *index, size_t index_slots);
+static size_t json_object_index_slots(size_t size);
+json_value_t* json_object_get(const json_value_t *json_value, const char *key, size_t key_size);
+size_t json_object_size(const json_value_t *json_value);
+json_value_t* json_array_get(const json_value_t *json_value, size_t i);
+size_t json_array_size(const json_value_t *json_value);
+bool json_array_append(json_value_t *json_value, json_value_t element);
+static bool json_string_set(json_value_t *json_value, const char *string, size_t size);
+const char* json_string_get(const json_value_t *json_value, size_t *size);
+size_t json_string_size(const json_value_t *json_value);
+//===== END ACCESS JSON INIT =====
+
 //===== BUILD JSON INIT =====
 json_value_t build_json_string(const char string_v[]);
 json_value_t build_json_int(int int_v);
@@ -154,40 +726,235 @@ json_value_t build_json_object(int n_args, ...);
 json_value_t build_json_array(int n_args, ...);
 //===== END BUILD JSON INIT =====
 
+//===== WRITER INIT =====
+bool json_writer_init_file(json_writer_t *writer, FILE *file);
+bool json_writer_init_fd(json_writer_t *writer, int fd);
+bool json_writer_init_callback(json_writer_t *writer, json_write_callback_t callback, void *user);
+void json_writer_write(json_writer_t *writer, const char *data, size_t size);
+bool json_writer_flush(json_writer_t *writer);
+bool json_writer_close(json_writer_t *writer);
+static bool json_writer_init(json_writer_t *writer, json_writer_sink_t sink);
+static bool json_writer_sink(json_writer_t *writer, const char *data, size_t size);
+static void json_writer_put(json_writer_t *writer, char c);
+static void json_writer_indent(json_writer_t *writer, int tab_level);
+static void json_writer_string(json_writer_t *writer, const char *string, size_t size);
+//===== END WRITER INIT =====
+
 //===== PRINT JSON INIT =====
-static void print_tab_helper(int tab_level);
-void print_json_string(json_string_t json_string, int tab_level, bool append_comma, bool is_object_value);
-void print_json_int(json_int_t json_int, int tab_level, bool append_comma, bool is_object_value);
-void print_json_float(json_float_t json_float, int tab_level, bool append_comma, bool is_object_value);
-void print_json_bool(json_bool_t json_bool, int tab_level, bool append_comma, bool is_object_value);
-void print_json_null(int tab_level, bool append_comma, bool is_object_value);
-void print_json_object(json_object_t *json_object, int tab_level, bool append_comma, bool is_object_value);
-void print_json_array(json_array_t *json_array, int tab_level, bool append_comma, bool is_object_value);
+static void print_tab_helper(json_writer_t *writer, int tab_level);
+static void print_separator_helper(json_writer_t *writer, bool append_comma);
+void print_json_string(json_writer_t *writer, json_string_t json_string, int tab_level, bool append_comma, bool is_object_value);
+void print_json_int(json_writer_t *writer, long json_int, int tab_level, bool append_comma, bool is_object_value);
+void print_json_float(json_writer_t *writer, double json_float, int tab_level, bool append_comma, bool is_object_value);
+void print_json_bool(json_writer_t *writer, bool json_bool, int tab_level, bool append_comma, bool is_object_value);
+void print_json_null(json_writer_t *writer, int tab_level, bool append_comma, bool is_object_value);
+void print_json_object(json_writer_t *writer, json_object_t *json_object, int tab_level, bool append_comma, bool is_object_value);
+void print_json_array(json_writer_t *writer, json_array_t *json_array, int tab_level, bool append_comma, bool is_object_value);
 
 // All encompassing recursive function that users will interface with
-static void print_json_value_helper(json_value_t json_value, int tab_level, bool append_comma, bool is_object_value);
+static void print_json_value_helper(json_writer_t *writer, json_value_t json_value, int tab_level, bool append_comma, bool is_object_value);
 void print_json_value(json_value_t json_value); // TODO: does this need to be a pointer?
+bool print_json_value_to(json_writer_t *writer, json_value_t json_value);
+bool fprint_json_value(FILE *file, json_value_t json_value);
 //===== END PRINT JSON INIT =====
 
 //===== SERIALIZE/DESERIALIZE JSON INIT =====
-char *dump_json(json_value_t *json_value); // TOOD: just reuse print json logic. => determine string size by iterating once beforehand
+char* dump_json(const json_value_t *json_value);
+char* dump_json_ex(const json_value_t *json_value, unsigned int flags, size_t *size);
+
+// Helper functions for dumping JSON
+static size_t json_find_escape(const char *string, size_t i, size_t size);
+static char* json_escape_char(char *out, unsigned char c);
+static size_t json_dump_string_size(const char *string, size_t size);
+static char* json_dump_string(char *out, const char *string, size_t size);
+static size_t json_count_digits(uint64_t value);
+static size_t json_dump_int_size(long value);
+static char* json_dump_int(char *out, long value);
+static void json_write_digits(char *out, uint64_t value, size_t length);
+static int32_t json_pow5_bits(int32_t e);
+static int32_t json_log10_pow2(int32_t e);
+static int32_t json_log10_pow5(int32_t e);
+static bool json_multiple_of_power_of_five(uint64_t value, int32_t p);
+static uint64_t json_mul_shift(uint64_t m, const uint64_t *factor, int32_t j);
+static int32_t json_shortest_decimal(uint64_t ieee_mantissa, uint32_t ieee_exponent, uint64_t *digits);
+static size_t json_format_float(double value, char *buffer);
+static size_t json_dump_size(const json_value_t *json_value, unsigned int flags, size_t depth);
+static char* json_dump_value(char *out, const json_value_t *json_value, unsigned int flags, size_t depth);
+static char* json_dump_indent(char *out, size_t depth);
 
 // Helper functions for loading JSON
-static char* skip_white_space(char *json); // used in load_json to skip white space in json data
-static bool is_valid_json_number_char(char c);
-static size_t find_string_size(char *in, char quote_style);
-static char* read_string(char *in, char *out, char quote_style);
-static char* read_json_string(char *json, json_value_t *json_parsed, char quote_style);
-static char* read_json_number(char *json, json_value_t *json_parsed);
-static char* read_json_object(char *json, json_value_t *json_parsed);
-static char* read_json_array(char *json, json_value_t *json_parsed);
-
-static char* load_json_helper(char *json, json_value_t *json_parsed);
+static char* skip_white_space(json_parser_t *parser, char *json); // used in load_json to skip white space in json data
+static bool is_json_digit(char c);
+static uint64_t json_load_eight_bytes(const char *in);
+static bool json_is_eight_digits(uint64_t chunk);
+static uint64_t json_parse_eight_digits(uint64_t chunk);
+static char* json_read_digits(char *json, const char *end, uint64_t *mantissa);
+static uint64_t json_mul128(uint64_t a, uint64_t b, uint64_t *high);
+static uint64_t json_eisel_lemire(int64_t q, uint64_t w);
+static bool json_slow_to_double(const char *start, const char *end, double *value);
+static long read_hex4(const char *in, const char *end);
+static char* read_escape(json_parser_t *parser, char *in, char **out);
+static char* read_string(json_parser_t *parser, char *in, const char **out_string, size_t *out_size, char quote_style);
+static char* json_find_quote_or_backslash(json_parser_t *parser, char *in, char quote_style);
+static char* read_string_insitu(json_parser_t *parser, char *in, const char **out_string, size_t *out_size, char quote_style);
+static char* read_string_borrowed(json_parser_t *parser, char *in, const char **out_string, size_t *out_size, char quote_style);
+static bool json_parser_grow_scratch(json_parser_t *parser, size_t size);
+static char* json_parser_fail(json_parser_t *parser, const char *json, const char *message);
+static char json_peek(json_parser_t *parser, const char *json);
+static bool json_match_literal(json_parser_t *parser, const char *json, const char *literal, size_t size);
+static char* read_json_string(json_parser_t *parser, char *json, char quote_style);
+static char* read_json_number(json_parser_t *parser, char *json);
+static bool json_parser_push(json_parser_t *parser, const char *json, json_parser_frame_t **frames, size_t *capacity, size_t depth, bool is_object);
+
+static char* load_json_helper(json_parser_t *parser, char *json);
+static void json_parser_init(json_parser_t *parser, char *json, size_t size, unsigned int flags, const json_sax_handler_t *handler, void *user);
+static size_t json_parse_max_depth(const json_parse_options_t *options);
+static bool json_parser_run(json_parser_t *parser, json_parse_error_t *error);
+bool json_sax_parse(const char *json, size_t size, const json_parse_options_t *options, const json_sax_handler_t *handler, void *user, json_parse_error_t *error);
+
+// DOM builder, the SAX client behind every load_json_* entry point
+static void json_builder_init(json_builder_t *builder, json_document_t *document);
+static void* json_builder_push(json_builder_t *builder, size_t size);
+static json_value_t* json_builder_add(json_builder_t *builder, json_types_t type);
+static bool json_builder_begin(json_builder_t *builder, bool is_object);
+static bool json_builder_on_object_begin(void *user);
+static bool json_builder_on_key(void *user, const char *key, size_t size);
+static bool json_builder_on_object_end(void *user, size_t size);
+static bool json_builder_on_array_begin(void *user);
+static bool json_builder_on_array_end(void *user, size_t size);
+static bool json_builder_on_string(void *user, const char *string, size_t size);
+static bool json_builder_on_int(void *user, long value);
+static bool json_builder_on_float(void *user, double value);
+static bool json_builder_on_bool(void *user, bool value);
+static bool json_builder_on_null(void *user);
 json_value_t* load_json(char *json);
-
-void free_json(json_value_t *json_parsed); // Used for freeing allocated heap memory used to load json
+json_value_t* load_json_ex(char *json, const json_parse_options_t *options);
+json_value_t* load_json_insitu(char *json);
+json_value_t* load_json_n(const char *json, size_t size, const json_parse_options_t *options, json_parse_error_t *error);
+static json_value_t* load_json_bounded(char *json, size_t size, unsigned int flags, const json_parse_options_t *options, json_parse_error_t *error);
+json_value_t* load_json_file(const char *path);
+json_value_t* load_json_file_ex(const char *path, const json_parse_options_t *options, json_parse_error_t *error);
+static char* json_read_stream(FILE *file, size_t *size);
+
+static void free_json_children(json_value_t *json_parsed);
+void free_json(json_value_t *json_parsed); // Used for freeing allocated memory used to load or build json
 //===== END SERIALIZE/DESERIALIZE JSON INIT =====
 
+//===== LAZY JSON INIT =====
+static char json_lazy_char(json_lazy_t *document, size_t token);
+static size_t json_lazy_skip(json_lazy_t *document, size_t token);
+static size_t json_lazy_member(json_lazy_t *document, size_t token);
+static size_t json_lazy_first(json_lazy_t *document, size_t token);
+static size_t json_lazy_next(json_lazy_t *document, size_t token);
+static bool json_lazy_key_equals(json_lazy_t *document, size_t token, const char *key, size_t key_size);
+static bool json_lazy_on_int(void *user, long value);
+static bool json_lazy_on_float(void *user, double value);
+json_lazy_t* load_json_lazy(const char *json, size_t size, const json_parse_options_t *options, json_parse_error_t *error);
+void free_json_lazy(json_lazy_t *document);
+json_cursor_t json_lazy_root(json_lazy_t *document);
+bool json_cursor_type(json_cursor_t cursor, json_types_t *type);
+bool json_cursor_object_get(json_cursor_t cursor, const char *key, size_t key_size, json_cursor_t *out);
+bool json_cursor_array_get(json_cursor_t cursor, size_t i, json_cursor_t *out);
+size_t json_cursor_size(json_cursor_t cursor);
+bool json_cursor_child(json_cursor_t cursor, json_cursor_t *out);
+bool json_cursor_next(json_cursor_t *cursor);
+const char* json_cursor_key(json_cursor_t cursor, size_t *size);
+json_value_t* json_cursor_value(json_cursor_t cursor, json_parse_error_t *error);
+//===== END LAZY JSON INIT =====
+
+//===== STREAM JSON INIT =====
+static void json_stream_setup(json_stream_t *stream, unsigned int flags, const json_sax_handler_t *handler, void *user);
+static void json_stream_bind(json_stream_t *stream, char *buffer, size_t size, size_t base);
+static bool json_stream_fail(json_stream_t *stream, size_t offset, const char *message);
+static bool json_stream_check(json_stream_t *stream);
+static bool json_stream_forward(json_stream_t *stream, size_t offset);
+static bool json_stream_complete(json_stream_t *stream, size_t offset);
+static bool json_stream_begin(json_stream_t *stream, bool is_object, size_t offset);
+static bool json_stream_end(json_stream_t *stream, size_t offset);
+static bool json_stream_value(json_stream_t *stream, char *start, char *stop);
+static bool json_stream_key(json_stream_t *stream, char *start);
+static char* json_stream_string_end(json_stream_t *stream, char *in, char *end);
+static char* json_stream_scalar_end(char *in, char *end);
+static bool json_stream_append(json_stream_t *stream, const char *data, size_t size);
+static char* json_stream_hold(json_stream_t *stream, json_stream_token_t token, char *in, char *end);
+static char* json_stream_string(json_stream_t *stream, char *in, char *end, json_stream_token_t token);
+static char* json_stream_start_value(json_stream_t *stream, char *in, char *end);
+static char* json_stream_step(json_stream_t *stream, char *in, char *end);
+static bool json_stream_release(json_stream_t *stream);
+static char* json_stream_resume(json_stream_t *stream, char *in, char *end);
+void json_stream_init(json_stream_t *stream, unsigned int flags, const json_sax_handler_t *handler, void *user);
+void json_stream_init_values(json_stream_t *stream, unsigned int flags, size_t depth, json_stream_value_callback_t on_value, void *user);
+bool json_stream_feed(json_stream_t *stream, const char *chunk, size_t size);
+bool json_stream_close(json_stream_t *stream, json_parse_error_t *error);
+//===== END STREAM JSON INIT =====
+
+//===== LINES JSON INIT =====
+static uint64_t json_newline_bits(const char *in);
+static bool json_lines_add(const char *json, size_t start, size_t end, size_t **records, size_t *count, size_t *capacity);
+static size_t* json_lines_split(const char *json, size_t size, bool padded, size_t *count);
+static size_t json_lines_claim(json_lines_job_t *job);
+static void json_lines_fail(json_lines_job_t *job, size_t record);
+static bool json_lines_parse(json_lines_worker_t *worker, json_builder_t *builder, size_t i, json_parse_error_t *error);
+static void* json_lines_work(void *argument);
+static size_t json_lines_threads(size_t threads, size_t record_count);
+static bool json_lines_run(json_lines_job_t *job, size_t threads, json_arena_t *arenas, json_parse_error_t *error);
+json_lines_t* load_json_lines(const char *json, size_t size, const json_parse_options_t *options, size_t threads, json_parse_error_t *error);
+void free_json_lines(json_lines_t *lines);
+static bool json_parallel_add(json_lines_job_t *job, size_t *capacity, size_t start, size_t end, size_t token);
+json_value_t* json_cursor_value_parallel(json_cursor_t cursor, size_t threads, json_parse_error_t *error);
+json_value_t* load_json_parallel(const char *json, size_t size, const json_parse_options_t *options, size_t threads, json_parse_error_t *error);
+//===== END LINES JSON INIT =====
+
+//===== VALIDATE JSON INIT =====
+static bool json_validate_fail(json_parse_error_t *error, size_t offset, const char *message);
+static size_t json_validate_white_space(const char *json, size_t size, size_t i);
+static size_t json_validate_find_special(const char *json, size_t size, size_t i);
+static size_t json_validate_utf8(const unsigned char *in, size_t available);
+static bool json_validate_string(const char *json, size_t size, size_t *i, json_parse_error_t *error);
+static size_t json_validate_digits(const char *json, size_t size, size_t i);
+static bool json_validate_number(const char *json, size_t size, size_t *i, json_parse_error_t *error);
+static bool json_validate_key(const char *json, size_t size, size_t *i, json_parse_error_t *error);
+bool json_validate(const char *json, size_t size, json_parse_error_t *error);
+//===== END VALIDATE JSON INIT =====
+
+//===== TAPE JSON INIT =====
+static bool json_tape_reserve(json_tape_builder_t *builder, size_t count);
+static bool json_tape_append(json_tape_builder_t *builder, char tag, uint64_t payload);
+static bool json_tape_append_number(json_tape_builder_t *builder, char tag, uint64_t bits);
+static bool json_tape_begin(json_tape_builder_t *builder, char tag);
+static bool json_tape_end(json_tape_builder_t *builder, char tag, size_t size);
+static bool json_tape_on_string(void *user, const char *string, size_t size);
+static bool json_tape_on_object_begin(void *user);
+static bool json_tape_on_object_end(void *user, size_t size);
+static bool json_tape_on_array_begin(void *user);
+static bool json_tape_on_array_end(void *user, size_t size);
+static bool json_tape_on_int(void *user, long value);
+static bool json_tape_on_float(void *user, double value);
+static bool json_tape_on_bool(void *user, bool value);
+static bool json_tape_on_null(void *user);
+json_tape_t* load_json_tape(const char *json, size_t size, const json_parse_options_t *options, json_parse_error_t *error);
+void free_json_tape(json_tape_t *tape);
+json_types_t json_tape_type(const json_tape_t *tape, size_t i);
+size_t json_tape_skip(const json_tape_t *tape, size_t i);
+size_t json_tape_child(const json_tape_t *tape, size_t i);
+size_t json_tape_next(const json_tape_t *tape, size_t i);
+size_t json_tape_size(const json_tape_t *tape, size_t i);
+long json_tape_int(const json_tape_t *tape, size_t i);
+double json_tape_float(const json_tape_t *tape, size_t i);
+bool json_tape_bool(const json_tape_t *tape, size_t i);
+const char* json_tape_string(const json_tape_t *tape, size_t i, size_t *size);
+size_t json_tape_object_get(const json_tape_t *tape, size_t i, const char *key, size_t key_size);
+size_t json_tape_array_get(const json_tape_t *tape, size_t i, size_t index);
+//===== END TAPE JSON INIT =====
+
+//===== INTERN JSON INIT =====
+static void json_intern_init(json_intern_t *intern, json_arena_t *arena);
+static bool json_intern_grow(json_intern_t *intern);
+json_intern_t* json_intern_create(void);
+void json_intern_free(json_intern_t *intern);
+const char* json_intern(json_intern_t *intern, const char *key, size_t key_size);
+//===== END INTERN JSON INIT =====
+
 //===== BUILD JSON IMPLEMENTATION =====
 /**
  * \brief Function to build a json string
@@ -197,20 +964,15 @@ void free_json(json_value_t *json_parsed); // Used for freeing allocated heap me
  */
 json_value_t build_json_string(const char string_v[])
 {
-    // Build json_element_t
-    json_element_t *json_element = (json_element_t *)calloc(1, sizeof(json_element_t));
-
-    json_string_t json_string;
-    json_string.value = strdup(string_v);
-    json_string.size = strlen(string_v);
-
-    json_element->string = json_string;
-
     // return json_value_t
     json_value_t json_value;
-    json_value.value = json_element;
+    json_value.flags = JSON_VALUE_HEAP;
     json_value.type = JSON_STRING;
 
+    size_t size = strlen(string_v);
+    if (size <= JSON_STRING_INLINE_MAX) json_string_set(&json_value, string_v, size);
+    else json_string_set(&json_value, strdup(string_v), size);
+
     return json_value;
 }
 
@@ -222,18 +984,11 @@ json_value_t build_json_string(const char string_v[])
  */
 json_value_t build_json_int(int int_v)
 {
-    // Build json_element_t
-    json_element_t *json_element = (json_element_t *)calloc(1, sizeof(json_element_t));
-
-    json_int_t json_int;
-    json_int.value = int_v;
-    json_int.size = sizeof(int_v);
-
-    json_element->integer = json_int;
-
     // return json_value_t
     json_value_t json_value;
-    json_value.value = json_element;
+    json_value.flags = JSON_VALUE_HEAP;
+    json_value.value.integer = int_v;
+    json_value.size = 0;
     json_value.type = JSON_INT;
 
     return json_value;
@@ -247,18 +1002,11 @@ json_value_t build_json_int(int int_v)
  */
 json_value_t build_json_float(double float_v)
 {
-    // Build json_element_t
-    json_element_t *json_element = (json_element_t *)calloc(1, sizeof(json_element_t));
-
-    json_float_t json_float;
-    json_float.value = float_v;
-    json_float.size = sizeof(json_float);
-
-    json_element->floating = json_float;
-
     // return json_value_t
     json_value_t json_value;
-    json_value.value = json_element;
+    json_value.flags = JSON_VALUE_HEAP;
+    json_value.value.floating = float_v;
+    json_value.size = 0;
     json_value.type = JSON_FLOAT;
 
     return json_value;
@@ -272,18 +1020,11 @@ json_value_t build_json_float(double float_v)
  */
 json_value_t build_json_bool(bool bool_v)
 {
-    // Build json_element_t
-    json_element_t *json_element = (json_element_t *)calloc(1, sizeof(json_element_t));
-
-    json_bool_t json_bool;
-    json_bool.value = bool_v;
-    json_bool.size = sizeof(json_bool);
-
-    json_element->boolean = json_bool;
-
     // return json_value_t
     json_value_t json_value;
-    json_value.value = json_element;
+    json_value.flags = JSON_VALUE_HEAP;
+    json_value.value.boolean = bool_v;
+    json_value.size = 0;
     json_value.type = JSON_BOOL;
 
     return json_value;
@@ -296,18 +1037,11 @@ json_value_t build_json_bool(bool bool_v)
  */
 json_value_t build_json_null()
 {
-    // Build json_element_t
-    json_element_t *json_element = (json_element_t *)calloc(1, sizeof(json_element_t));
-
-    json_null_t json_null;
-    json_null.value = JSON_NULL_VALUE;
-    json_null.size = 0;
-
-    json_element->null = json_null;
-
     // return json_value_t
     json_value_t json_value;
-    json_value.value = json_element;
+    json_value.flags = JSON_VALUE_HEAP;
+    json_value.value.integer = JSON_NULL_VALUE;
+    json_value.size = 0;
     json_value.type = JSON_NULL;
 
     return json_value;
@@ -326,37 +1060,38 @@ json_value_t build_json_null()
  */
 json_value_t build_json_object(int n_args, ...)
 {
-    json_element_t *json_element = (json_element_t *) calloc(1, sizeof(json_element_t));
-    json_object_t *json_object = NULL; // set initial linkedlist node as NULL
+    json_object_t *json_object = (json_object_t *) calloc(1, sizeof(json_object_t));
+    json_object->entries = (json_object_entry_t *) calloc(n_args, sizeof(json_object_entry_t));
+    json_object->size = n_args;
 
     // Parse variadic function arguments
     va_list ap;
 
     va_start(ap, n_args); // Collect variadic list
 
-    // process args
+    // process args, members keep the order they were passed in
     for (int i = 0; i < n_args ; ++i)
     {
         char *key = va_arg(ap, char *);                // get key from variadic list
 
-        json_value_t *value = (json_value_t *) calloc(1, sizeof(json_value_t)); // get value from variadic list
-        *value = va_arg(ap, json_value_t);
-
-        // Build linkedlist
-        json_object_t *temp = (json_object_t *) calloc(1, sizeof(json_object_t));
-        temp->key = key;
-        temp->value = value;
-        temp->next = json_object;
-        json_object = temp;
+        json_object->entries[i].key = key;
+        json_object->entries[i].key_size = strlen(key);
+        json_object->entries[i].value = va_arg(ap, json_value_t); // get value from variadic list
     }
 
     va_end(ap); // End variadic list
 
-    json_element->object = json_object; // assign json_object to json_element
+    if (json_object->size >= JSON_OBJECT_INDEX_THRESHOLD)
+    {
+        size_t index_slots = json_object_index_slots(json_object->size);
+        json_object_build_index(json_object, (uint32_t *) malloc(index_slots * sizeof(uint32_t)), index_slots);
+    }
 
     json_value_t json_value;
+    json_value.flags = JSON_VALUE_HEAP;
     json_value.type = JSON_OBJECT;
-    json_value.value = json_element; // access stops working here, some invalid memory acc here
+    json_value.value.object = json_object;
+    json_value.size = 0;
 
     return json_value;
 }
@@ -373,8 +1108,10 @@ json_value_t build_json_object(int n_args, ...)
  */
 json_value_t build_json_array(int n_args, ...)
 {
-    json_element_t *json_element = (json_element_t *) calloc(1, sizeof(json_element_t));
-    json_array_t *json_array = NULL;
+    json_array_t *json_array = (json_array_t *) calloc(1, sizeof(json_array_t));
+    json_array->values = (json_value_t *) calloc(n_args, sizeof(json_value_t));
+    json_array->size = n_args;
+    json_array->capacity = n_args;
 
     // Parse variadic function arguments
     va_list ap;
@@ -384,737 +1121,7531 @@ json_value_t build_json_array(int n_args, ...)
     // process args
     for (int i = 0; i < n_args; ++i)
     {
-        json_value_t *value = (json_value_t *) calloc(1, sizeof(json_value_t)); // get value from variadic list
-        *value = va_arg(ap, json_value_t);
-
-        // build linkedlist
-        json_array_t *temp = (json_array_t *)calloc(1, sizeof(json_array_t));
-        ;
-        temp->value = value;
-        temp->next = json_array;
-        json_array = temp;
+        json_array->values[i] = va_arg(ap, json_value_t); // get value from variadic list
     }
 
     va_end(ap); // End variadic list
 
-    json_element->array = json_array; // assign json_array to json_element
-
     json_value_t json_value;
+    json_value.flags = JSON_VALUE_HEAP;
     json_value.type = JSON_ARRAY;
-    json_value.value = json_element;
+    json_value.value.array = json_array;
+    json_value.size = 0;
 
     return json_value;
 }
 //===== END BUILD JSON IMPLEMENTATION=====
 
-//===== PRINT JSON IMPLEMENTATION =====
-
+//===== WRITER IMPLEMENTATION =====
 /**
- * \brief Helper function to print tabs for formatting json indentation
- * 
- * \param[in] tab_level number of tabs to add
+ * \brief Helper function to set up the buffer shared by every kind of writer
+ *
+ * \param[in] writer writer to initialize
+ * \param[in] sink where the writer flushes to
+ *
+ * \return true if the buffer was allocated, false if out of memory
  */
-static void print_tab_helper(int tab_level)
+static bool json_writer_init(json_writer_t *writer, json_writer_sink_t sink)
 {
-    for (int i = 0; i < tab_level; ++i)
-    {
-        printf("    ");
-    }
+    writer->buffer = (char *) malloc(JSON_WRITER_BUFFER_SIZE);
+    writer->size = 0;
+    writer->capacity = JSON_WRITER_BUFFER_SIZE;
+    writer->sink = sink;
+    writer->file = NULL;
+    writer->fd = -1;
+    writer->callback = NULL;
+    writer->user = NULL;
+    writer->failed = writer->buffer == NULL;
+
+    return !writer->failed;
 }
 
 /**
- * \brief Function to print a json string. Mainly used as a helper function.
- * 
- * \param[in] json_string json string to be printed
- * \param[in] tab_level number of tabs to ident the printed string by
- * \param[in] append_comma boolean to show if a comma should be added after string
- * \param[in] is_object_value tabs will be prepended if current json value is a json object value
+ * \brief Function to initialize a writer that flushes to a stdio stream
+ *
+ * \param[in] writer writer to initialize, release it with json_writer_close
+ * \param[in] file stream to write to, it is not closed by the writer
+ *
+ * \return true if the writer is ready, false if out of memory
  */
-void print_json_string(json_string_t json_string, int tab_level, bool append_comma, bool is_object_value)
+bool json_writer_init_file(json_writer_t *writer, FILE *file)
 {
-    if (!is_object_value) print_tab_helper(tab_level);
-    printf("\"%s\"%s", 
-        json_string.value, 
-        append_comma ? ",\n" : "\n"
-    );
+    bool ready = json_writer_init(writer, JSON_WRITER_FILE);
+    writer->file = file;
+
+    return ready;
 }
 
 /**
- * \brief Function to print a json integer. Mainly used as a helper function.
- * 
- * \param[in] json_int json integer to be printed
- * \param[in] tab_level number of tabs to ident the printed string by
- * \param[in] append_comma boolean to show if a comma should be added after string
- * \param[in] is_object_value tabs will be prepended if current json value is a json object value
+ * \brief Function to initialize a writer that flushes to a file descriptor with write, bypassing
+ * stdio. Only available on POSIX systems.
+ *
+ * \param[in] writer writer to initialize, release it with json_writer_close
+ * \param[in] fd file descriptor to write to, it is not closed by the writer
+ *
+ * \return true if the writer is ready, false if out of memory or file descriptors are not supported
  */
-void print_json_int(json_int_t json_int, int tab_level, bool append_comma, bool is_object_value)
+bool json_writer_init_fd(json_writer_t *writer, int fd)
 {
-    if (!is_object_value) print_tab_helper(tab_level);
-    printf("%ld%s", 
-        json_int.value,
-        append_comma ? ",\n" : "\n"
-    );
+    bool ready = json_writer_init(writer, JSON_WRITER_FD);
+    writer->fd = fd;
+
+#if !defined(JSON_HAS_MMAP)
+    writer->failed = true;
+    ready = false;
+#endif
+
+    return ready;
 }
 
 /**
- * \brief Function to print a json float. Mainly used as a helper function.
- * 
- * \param[in] json_float json float to be printed
- * \param[in] tab_level number of tabs to ident the printed string by
- * \param[in] append_comma boolean to show if a comma should be added after string
- * \param[in] is_object_value tabs will be prepended if current json value is a json object value
+ * \brief Function to initialize a writer that hands its output to a user callback
+ *
+ * \param[in] writer writer to initialize, release it with json_writer_close
+ * \param[in] callback function receiving the output in pieces of up to JSON_WRITER_BUFFER_SIZE bytes
+ * \param[in] user pointer passed through to callback
+ *
+ * \return true if the writer is ready, false if out of memory
  */
-void print_json_float(json_float_t json_float, int tab_level, bool append_comma, bool is_object_value)
+bool json_writer_init_callback(json_writer_t *writer, json_write_callback_t callback, void *user)
 {
-    if (!is_object_value) print_tab_helper(tab_level);
-    printf("%f%s", 
-        json_float.value,
-        append_comma ? ",\n" : "\n"
-    );
+    bool ready = json_writer_init(writer, JSON_WRITER_CALLBACK);
+    writer->callback = callback;
+    writer->user = user;
+
+    return ready;
 }
 
 /**
- * \brief Function to print a json bool. Mainly used as a helper function.
- * 
- * \param[in] json_bool json bool to be printed
- * \param[in] tab_level number of tabs to ident the printed string by
+ * \brief Helper function to hand bytes straight to the sink of a writer
+ *
+ * \param[in] writer writer owning the sink
+ * \param[in] data bytes to write
+ * \param[in] size number of bytes
+ *
+ * \return true if every byte was written, false otherwise
+ */
+static bool json_writer_sink(json_writer_t *writer, const char *data, size_t size)
+{
+    switch (writer->sink)
+    {
+        case JSON_WRITER_FILE:
+            return fwrite(data, 1, size, writer->file) == size;
+
+        case JSON_WRITER_FD:
+#if defined(JSON_HAS_MMAP)
+            while (size > 0)
+            {
+                ssize_t written = write(writer->fd, data, size);
+                if (written < 0)
+                {
+                    if (errno == EINTR) continue;
+                    return false;
+                }
+                data += written;
+                size -= (size_t) written;
+            }
+            return true;
+#else
+            return false;
+#endif
+
+        case JSON_WRITER_CALLBACK:
+            return writer->callback(writer->user, data, size);
+    }
+
+    return false;
+}
+
+/**
+ * \brief Function to hand everything buffered by a writer to its sink
+ *
+ * \param[in] writer writer to flush
+ *
+ * \return true if the writer has not failed so far, false otherwise
+ */
+bool json_writer_flush(json_writer_t *writer)
+{
+    if (!writer->failed && writer->size > 0)
+    {
+        writer->failed = !json_writer_sink(writer, writer->buffer, writer->size);
+    }
+    writer->size = 0;
+
+    return !writer->failed;
+}
+
+/**
+ * \brief Function to flush a writer and release its buffer. The stream or file descriptor behind
+ * it is left open.
+ *
+ * \param[in] writer writer to close
+ *
+ * \return true if all output reached the sink, false otherwise
+ */
+bool json_writer_close(json_writer_t *writer)
+{
+    bool flushed = json_writer_flush(writer);
+    free(writer->buffer);
+    writer->buffer = NULL;
+    writer->capacity = 0;
+
+    return flushed;
+}
+
+/**
+ * \brief Function to append bytes to a writer. Output bigger than the buffer skips it and goes to
+ * the sink directly.
+ *
+ * \param[in] writer writer to append to
+ * \param[in] data bytes to append
+ * \param[in] size number of bytes
+ */
+void json_writer_write(json_writer_t *writer, const char *data, size_t size)
+{
+    if (writer->failed) return;
+
+    if (writer->capacity - writer->size < size)
+    {
+        json_writer_flush(writer);
+        if (size >= writer->capacity)
+        {
+            writer->failed = writer->failed || !json_writer_sink(writer, data, size);
+            return;
+        }
+    }
+
+    memcpy(writer->buffer + writer->size, data, size);
+    writer->size += size;
+}
+
+/**
+ * \brief Helper function to append a single byte to a writer
+ *
+ * \param[in] writer writer to append to
+ * \param[in] c byte to append
+ */
+static void json_writer_put(json_writer_t *writer, char c)
+{
+    if (writer->size == writer->capacity) json_writer_flush(writer);
+    if (writer->failed) return;
+
+    writer->buffer[writer->size++] = c;
+}
+
+/**
+ * \brief Helper function to append the indentation of a nesting level. Indents are copied out of
+ * a precomputed run of spaces instead of being written level by level.
+ *
+ * \param[in] writer writer to append to
+ * \param[in] tab_level nesting level, JSON_DUMP_INDENT spaces each
+ */
+static void json_writer_indent(json_writer_t *writer, int tab_level)
+{
+    static const char spaces[] =
+        "                                                                "
+        "                                                                ";
+
+    size_t size = tab_level > 0 ? (size_t) tab_level * JSON_DUMP_INDENT : 0;
+    while (size > 0)
+    {
+        size_t piece = size < sizeof(spaces) - 1 ? size : sizeof(spaces) - 1;
+        json_writer_write(writer, spaces, piece);
+        size -= piece;
+    }
+}
+/**
+ * \brief Helper function to append a string quoted and escaped. Clean spans found by
+ * json_find_escape are appended in bulk.
+ *
+ * \param[in] writer writer to append to
+ * \param[in] string string to append
+ * \param[in] size length of string
+ */
+static void json_writer_string(json_writer_t *writer, const char *string, size_t size)
+{
+    char escape[6];
+
+    json_writer_put(writer, '"');
+    size_t run_start = 0;
+    for (;;)
+    {
+        size_t i = json_find_escape(string, run_start, size);
+        json_writer_write(writer, string + run_start, i - run_start);
+        if (i == size) break;
+
+        json_writer_write(writer, escape, (size_t) (json_escape_char(escape, (unsigned char) string[i]) - escape));
+        run_start = i + 1;
+    }
+    json_writer_put(writer, '"');
+}
+//===== END WRITER IMPLEMENTATION =====
+
+//===== PRINT JSON IMPLEMENTATION =====
+
+/**
+ * \brief Helper function to print tabs for formatting json indentation
+ * 
+ * \param[in] writer writer to print to
+ * \param[in] tab_level number of tabs to add
+ */
+static void print_tab_helper(json_writer_t *writer, int tab_level)
+{
+    json_writer_indent(writer, tab_level);
+}
+
+/**
+ * \brief Helper function to end a printed value, with or without a comma
+ *
+ * \param[in] writer writer to print to
+ * \param[in] append_comma boolean to show if a comma should be added before the new line
+ */
+static void print_separator_helper(json_writer_t *writer, bool append_comma)
+{
+    if (append_comma) json_writer_write(writer, ",\n", 2);
+    else json_writer_put(writer, '\n');
+}
+
+/**
+ * \brief Function to print a json string. Mainly used as a helper function.
+ * 
+ * \param[in] writer writer to print to
+ * \param[in] json_string json string to be printed
+ * \param[in] tab_level number of tabs to ident the printed string by
+ * \param[in] append_comma boolean to show if a comma should be added after string
+ * \param[in] is_object_value tabs will be prepended if current json value is a json object value
+ */
+void print_json_string(json_writer_t *writer, json_string_t json_string, int tab_level, bool append_comma, bool is_object_value)
+{
+    if (!is_object_value) print_tab_helper(writer, tab_level);
+    json_writer_string(writer, json_string.value, json_string.size);
+    print_separator_helper(writer, append_comma);
+}
+
+/**
+ * \brief Function to print a json integer. Mainly used as a helper function.
+ * 
+ * \param[in] writer writer to print to
+ * \param[in] json_int json integer to be printed
+ * \param[in] tab_level number of tabs to ident the printed string by
+ * \param[in] append_comma boolean to show if a comma should be added after string
+ * \param[in] is_object_value tabs will be prepended if current json value is a json object value
+ */
+void print_json_int(json_writer_t *writer, long json_int, int tab_level, bool append_comma, bool is_object_value)
+{
+    char buffer[32];
+
+    if (!is_object_value) print_tab_helper(writer, tab_level);
+    json_writer_write(writer, buffer, (size_t) (json_dump_int(buffer, json_int) - buffer));
+    print_separator_helper(writer, append_comma);
+}
+
+/**
+ * \brief Function to print a json float. Mainly used as a helper function.
+ * 
+ * \param[in] writer writer to print to
+ * \param[in] json_float json float to be printed
+ * \param[in] tab_level number of tabs to ident the printed string by
  * \param[in] append_comma boolean to show if a comma should be added after string
  * \param[in] is_object_value tabs will be prepended if current json value is a json object value
  */
-void print_json_bool(json_bool_t json_bool, int tab_level, bool append_comma, bool is_object_value)
+void print_json_float(json_writer_t *writer, double json_float, int tab_level, bool append_comma, bool is_object_value)
 {
-    if (!is_object_value) print_tab_helper(tab_level);
-    printf("%s%s", 
-        json_bool.value ? "true" : "false",
-        append_comma ? ",\n" : "\n"
-    );
+    char buffer[32];
+
+    if (!is_object_value) print_tab_helper(writer, tab_level);
+    json_writer_write(writer, buffer, json_format_float(json_float, buffer));
+    print_separator_helper(writer, append_comma);
+}
+
+/**
+ * \brief Function to print a json bool. Mainly used as a helper function.
+ * 
+ * \param[in] writer writer to print to
+ * \param[in] json_bool json bool to be printed
+ * \param[in] tab_level number of tabs to ident the printed string by
+ * \param[in] append_comma boolean to show if a comma should be added after string
+ * \param[in] is_object_value tabs will be prepended if current json value is a json object value
+ */
+void print_json_bool(json_writer_t *writer, bool json_bool, int tab_level, bool append_comma, bool is_object_value)
+{
+    if (!is_object_value) print_tab_helper(writer, tab_level);
+    if (json_bool) json_writer_write(writer, "true", 4);
+    else json_writer_write(writer, "false", 5);
+    print_separator_helper(writer, append_comma);
 }
 
 /**
  * \brief Function to print a json null. Mainly used as a helper function.
  * 
- * \param[in] json_null json null to be printed
+ * \param[in] writer writer to print to
  * \param[in] tab_level number of tabs to ident the printed string by
  * \param[in] append_comma boolean to show if a comma should be added after string
  * \param[in] is_object_value tabs will be prepended if current json value is a json object value
  */
-void print_json_null(int tab_level, bool append_comma, bool is_object_value)
+void print_json_null(json_writer_t *writer, int tab_level, bool append_comma, bool is_object_value)
 {
-    if (!is_object_value) print_tab_helper(tab_level);
-    printf("null%s", append_comma ? ",\n" : "\n");
+    if (!is_object_value) print_tab_helper(writer, tab_level);
+    json_writer_write(writer, "null", 4);
+    print_separator_helper(writer, append_comma);
 }
 
 /**
  * \brief Function to print a json object. Mainly used as a helper function.
  * 
+ * \param[in] writer writer to print to
  * \param[in] json_object json object to be printed
  * \param[in] tab_level number of tabs to ident the printed string by
  * \param[in] append_comma boolean to show if a comma should be added after string
  * \param[in] is_object_value tabs will be prepended if current json value is a json object value
  */
-void print_json_object(json_object_t *json_object, int tab_level, bool append_comma, bool is_object_value)
+void print_json_object(json_writer_t *writer, json_object_t *json_object, int tab_level, bool append_comma, bool is_object_value)
 {
-    if (!is_object_value) print_tab_helper(tab_level);
-    // TODO: need a way to maintain tab state to know how many tabs to insert
-    // traverse linkedlist
-    json_object_t *p;
-    p = json_object;
-
-    printf("{\n"); tab_level++;
-    while (p != NULL)
+    if (!is_object_value) print_tab_helper(writer, tab_level);
+    // traverse members in insertion order
+    json_writer_write(writer, "{\n", 2); tab_level++;
+    for (size_t i = 0; i < json_object->size; ++i)
     {
-        bool append_value_comma = true;
+        json_object_entry_t *entry = &json_object->entries[i];
         // print key
-        print_tab_helper(tab_level);
-        printf("\"%s\": ", p->key); // print colon to separate key and value
+        print_tab_helper(writer, tab_level);
+        json_writer_string(writer, entry->key, entry->key_size);
+        json_writer_write(writer, ": ", 2); // print colon to separate key and value
 
         // print value
-        if (p->next == NULL) append_value_comma = false;
-        print_json_value_helper(*(p->value), tab_level,
+        bool append_value_comma = i + 1 < json_object->size;
+        print_json_value_helper(writer, entry->value, tab_level,
         append_value_comma, true
         );
-        p = p->next;
     }
 
-    print_tab_helper(--tab_level);
-    printf("}%s", append_comma ? ",\n" : "\n");
+    print_tab_helper(writer, --tab_level);
+    json_writer_put(writer, '}');
+    print_separator_helper(writer, append_comma);
 }
 
 /**
  * \brief Function to print a json array. Mainly used as a helper function.
  * 
+ * \param[in] writer writer to print to
  * \param[in] json_array json array to be printed
  * \param[in] tab_level number of tabs to ident the printed string by
  * \param[in] append_comma boolean to show if a comma should be added after string
  * \param[in] is_object_value tabs will be prepended if current json value is a json object value
  */
-void print_json_array(json_array_t *json_array, int tab_level, bool append_comma, bool is_object_value)
+void print_json_array(json_writer_t *writer, json_array_t *json_array, int tab_level, bool append_comma, bool is_object_value)
 {
-    if (!is_object_value) print_tab_helper(tab_level);
-    // traverse linkedlist
-    json_array_t *p;
-    p = json_array;
-
-    printf("[\n"); tab_level++;
-    while (p != NULL)
+    if (!is_object_value) print_tab_helper(writer, tab_level);
+    // traverse elements in order
+    json_writer_write(writer, "[\n", 2); tab_level++;
+    for (size_t i = 0; i < json_array->size; ++i)
     {
-        bool append_value_comma = true;
-
         // print value
-        if (p->next == NULL) append_value_comma = false;
-        print_json_value_helper(*(p->value), tab_level, append_value_comma, false
+        bool append_value_comma = i + 1 < json_array->size;
+        print_json_value_helper(writer, json_array->values[i], tab_level, append_value_comma, false
         );
-        p = p->next;
     }
 
-    print_tab_helper(--tab_level);
-    printf("]%s", append_comma ? ",\n" : "\n");
+    print_tab_helper(writer, --tab_level);
+    json_writer_put(writer, ']');
+    print_separator_helper(writer, append_comma);
 }
 
 /**
  * \brief Helper function to print a json value.
  * 
+ * \param[in] writer writer to print to
  * \param[in] json_value json value to be printed
  * \param[in] tab_level number of tabs to ident the printed string by
  * \param[in] append_comma boolean to show if a comma should be added after string
  * \param[in] is_object_value tabs will be prepended if current json value is a json object value
  */
-static void print_json_value_helper(json_value_t json_value, int tab_level, bool append_comma, bool is_object_value)
+static void print_json_value_helper(json_writer_t *writer, json_value_t json_value, int tab_level, bool append_comma, bool is_object_value)
 {    
     switch (json_value.type)
     {
         case JSON_STRING:
-            print_json_string(json_value.value->string, tab_level, append_comma, is_object_value);
+        {
+            json_string_t json_string;
+            json_string.value = json_string_get(&json_value, &json_string.size);
+            print_json_string(writer, json_string, tab_level, append_comma, is_object_value);
             break;
+        }
 
         case JSON_INT:
-            print_json_int(json_value.value->integer, tab_level, append_comma, is_object_value);
+            print_json_int(writer, json_value.value.integer, tab_level, append_comma, is_object_value);
             break;
 
         case JSON_FLOAT:
-            print_json_float(json_value.value->floating, tab_level, append_comma, is_object_value);
+            print_json_float(writer, json_value.value.floating, tab_level, append_comma, is_object_value);
             break;
 
         case JSON_BOOL:
-            print_json_bool(json_value.value->boolean, tab_level, append_comma, is_object_value);
+            print_json_bool(writer, json_value.value.boolean, tab_level, append_comma, is_object_value);
             break;
 
         case JSON_NULL:
-            print_json_null(tab_level, append_comma, is_object_value);
+            print_json_null(writer, tab_level, append_comma, is_object_value);
             break;
 
         case JSON_OBJECT:
-            print_json_object(json_value.value->object, tab_level, append_comma, is_object_value);
+            print_json_object(writer, json_value.value.object, tab_level, append_comma, is_object_value);
             break;
 
         case JSON_ARRAY:
-            print_json_array(json_value.value->array, tab_level, append_comma, is_object_value);
+            print_json_array(writer, json_value.value.array, tab_level, append_comma, is_object_value);
             break;
     };
 }
 
 /**
- * \brief User facing function to print a json value.
+ * \brief User facing function to print a json value to stdout.
  * 
  * \param[in] json_value json value to be printed
  */
 void print_json_value(json_value_t json_value)
 {    
-    print_json_value_helper(json_value, 0, false, false);
+    fprint_json_value(stdout, json_value);
 }
-//===== END PRINT JSON IMPLEMENTATION =====
 
 /**
- * \brief json serializer in jajson.h
+ * \brief User facing function to print a json value to a stdio stream through a buffered writer.
  *
- * \param[in] json_value: json_value_t pointer to access json structured data
+ * \param[in] file stream to print to
+ * \param[in] json_value json value to be printed
  *
- * \returns string containing json data in string format
+ * \return true if all output was written, false otherwise
  */
-char* dump_json(json_value_t *json_value)
+bool fprint_json_value(FILE *file, json_value_t json_value)
 {
-    /*
-    issues:
-    - how to load into c-string, make char array as big as possible?
-    */
-    return "hello";
+    json_writer_t writer;
+    if (!json_writer_init_file(&writer, file)) return false;
+
+    print_json_value_helper(&writer, json_value, 0, false, false);
+
+    return json_writer_close(&writer);
 }
 
 /**
- * \brief Helper function to different types of white space in string
- * 
- * \param[in] json input string
-*
- * \return remaining string after skipping white space characters
+ * \brief User facing function to print a json value into a writer. The writer is not flushed, so
+ * several values can be printed back to back before handing the output to the sink.
+ *
+ * \param[in] writer writer to print to
+ * \param[in] json_value json value to be printed
+ *
+ * \return true if the writer has not failed so far, false otherwise
  */
-static char* skip_white_space(char *json) 
+bool print_json_value_to(json_writer_t *writer, json_value_t json_value)
 {
-    while (*json == ' ' || *json == '\t' || *json == '\n') {
-        json++;
-    }
+    print_json_value_helper(writer, json_value, 0, false, false);
 
-    return json;
+    return !writer->failed;
 }
+//===== END PRINT JSON IMPLEMENTATION =====
 
+//===== ARENA IMPLEMENTATION =====
 /**
- * \brief Helper function to find the size of a string that is being parsed
- * 
- * \param[in] in input string
- * \param[in] quote_style quote type the json string is enclosed with
+ * \brief Function to initialize an empty arena. No memory is requested until the first allocation.
  *
- * \return size of first string found in input
+ * \param[in] arena arena to initialize
+ * \param[in] initial_block_size size of the first block, later blocks double in size
  */
-static size_t find_string_size(char *in, char quote_style)
+void json_arena_init(json_arena_t *arena, size_t initial_block_size)
 {
-    size_t size = 0;
+    arena->head = NULL;
+    arena->next_block_size = initial_block_size < JSON_ARENA_MIN_BLOCK_SIZE ? JSON_ARENA_MIN_BLOCK_SIZE : initial_block_size;
+}
 
-    bool escaped = false;
-    // Skip '"' or '\''
-    in++; 
+/**
+ * \brief Function to bump allocate memory from an arena. Memory is not zeroed.
+ *
+ * \param[in] arena arena to allocate from
+ * \param[in] size number of bytes to allocate
+ *
+ * \return pointer to allocated memory aligned to JSON_ARENA_ALIGNMENT, NULL if out of memory
+ */
+void* json_arena_alloc(json_arena_t *arena, size_t size)
+{
+    size = (size + JSON_ARENA_ALIGNMENT - 1) & ~((size_t) JSON_ARENA_ALIGNMENT - 1);
 
-    // if we reach the end quote and 
-    while (*in != quote_style || escaped) 
+    json_arena_block_t *block = arena->head;
+    if (block != NULL && block->capacity - block->used >= size)
     {
-        if (*in == '\\')
-        {
-          escaped = true;
-          in++;
-          continue;
-        }
+        char *memory = (char *) (block + 1) + block->used;
+        block->used += size;
+        return memory;
+    }
 
-        size++;
-        in++;
+    // Current block is full, chain a new one in front of it
+    size_t capacity = arena->next_block_size;
+    if (capacity < size) capacity = size;
 
-        if (escaped)
-            escaped = false;
+    block = (json_arena_block_t *) malloc(sizeof(json_arena_block_t) + capacity);
+    if (block == NULL) return NULL;
+
+    block->capacity = capacity;
+    block->used = size;
+
+    // Oversized allocations get a block of their own behind the head so the
+    // free space left in the current block is not thrown away
+    if (capacity > arena->next_block_size && arena->head != NULL)
+    {
+        block->next = arena->head->next;
+        arena->head->next = block;
+    } else
+    {
+        block->next = arena->head;
+        arena->head = block;
+        if (arena->next_block_size < JSON_ARENA_MAX_BLOCK_SIZE) arena->next_block_size *= 2;
     }
-    in++;
 
-    return size + 1; // add one for null termination character
+    return (char *) (block + 1);
 }
 
 /**
- * \brief Helper function to read a json string from input
- * 
- * \param[in] in input string
- * \param[in] out address to a pointer that stores the parsed string
- * \param[in] size size of string to be parsed
- * \param[in] quote_style quote type the string to be parsed will be enclosed by
+ * \brief Helper function to get at least size bytes of free space at the end of the current block
+ * without allocating them. Used to write data of unknown length straight into the arena, the
+ * space is claimed afterwards with json_arena_commit.
  *
- * \return remaining input string after reading the first string from the input string
+ * \param[in] arena arena to reserve from
+ * \param[in] size minimum number of free bytes needed
+ * \param[in] available address of a size that stores the number of free bytes actually available
+ *
+ * \return pointer to the free space, NULL if out of memory
  */
-static char* read_string(char *in, char *out, char quote_style)
+static char* json_arena_reserve(json_arena_t *arena, size_t size, size_t *available)
 {
-    bool escaped = false;
-    // Skip '"' or '\''
-    in++; 
-
-    // if we reach the end quote and 
-    while (*in != quote_style || escaped) 
+    json_arena_block_t *block = arena->head;
+    if (block == NULL || block->capacity - block->used < size)
     {
-        if (*in == '\\')
-        {
-          escaped = true;
-          in++;
-          continue;
-        }
+        size_t capacity = arena->next_block_size;
+        if (capacity < size) capacity = size;
 
-        *out++ = *in++;
+        block = (json_arena_block_t *) malloc(sizeof(json_arena_block_t) + capacity);
+        if (block == NULL) return NULL;
 
-        if (escaped)
-            escaped = false;
+        block->capacity = capacity;
+        block->used = 0;
+        block->next = arena->head;
+        arena->head = block;
+        if (arena->next_block_size < JSON_ARENA_MAX_BLOCK_SIZE) arena->next_block_size *= 2;
     }
-    in++;
-    
-    *out = '\0';
 
-    return in;
+    *available = block->capacity - block->used;
+    return (char *) (block + 1) + block->used;
 }
 
 /**
- * \brief Function to read a json string
- *
- * \param[in] json input string
- * \param[in] json_parsed resultant json value to store parsed string
- * \param[in] quote_style quote type the string to be parsed will be enclosed by
+ * \brief Helper function to claim space previously handed out by json_arena_reserve
  *
- * \return remaining input string after parsing first json string found
+ * \param[in] arena arena that was reserved from
+ * \param[in] size number of bytes written, at most the reserved amount
  */
-static char* read_json_string(char *json, json_value_t *json_parsed, char quote_style)
+static void json_arena_commit(json_arena_t *arena, size_t size)
 {
-    json_element_t *json_element = (json_element_t *)calloc(1, sizeof(json_element_t));
-    size_t string_size = find_string_size(json, quote_style);
-    char *string = (char *) malloc(string_size);
+    json_arena_block_t *block = arena->head;
+    size = (size + JSON_ARENA_ALIGNMENT - 1) & ~((size_t) JSON_ARENA_ALIGNMENT - 1);
+    block->used = block->used + size < block->capacity ? block->used + size : block->capacity;
+}
 
-    json = read_string(json, string, quote_style);
-    
-    // printf("String that is read: %s\n", string);
+/**
+ * \brief Helper function to give back the most recent allocation of an arena, such as a string that
+ * was copied elsewhere after all. Memory that is not the last allocation of the head block is left alone.
+ *
+ * \param[in] arena arena that was allocated from
+ * \param[in] memory start of the allocation
+ * \param[in] size number of bytes that were allocated or committed
+ */
+static void json_arena_unwind(json_arena_t *arena, const char *memory, size_t size)
+{
+    json_arena_block_t *block = arena->head;
+    size = (size + JSON_ARENA_ALIGNMENT - 1) & ~((size_t) JSON_ARENA_ALIGNMENT - 1);
+    if (block == NULL || block->used < size) return;
 
-    json_string_t json_string;
-    json_string.value = string;
-    json_string.size = string_size;
+    char *last = (char *) (block + 1) + block->used - size;
+    if (memory == last) block->used -= size;
+}
 
-    json_element->string = json_string;
+/**
+ * \brief Function to release every block owned by an arena in one pass
+ *
+ * \param[in] arena arena to release
+ */
+void json_arena_free(json_arena_t *arena)
+{
+    json_arena_block_t *block = arena->head;
+    while (block != NULL)
+    {
+        json_arena_block_t *temp = block->next;
+        free(block);
+        block = temp;
+    }
+    arena->head = NULL;
+}
 
-    json_parsed->value = json_element;
+/**
+ * \brief Helper function to hand every block of one arena over to another. The blocks are linked in
+ * behind the current block of arena, so its free space is still used by later allocations.
+ *
+ * \param[in] arena arena receiving the blocks
+ * \param[in] other arena giving up its blocks, left empty
+ */
+static void json_arena_merge(json_arena_t *arena, json_arena_t *other)
+{
+    json_arena_block_t *head = other->head;
+    if (head == NULL) return;
 
-    // MAJOR-TODO: what if json string is incorrect and escaped is true after leaving? or even worse, loop never ends
-    // if (escaped)
-    // {
-    //     // todo: print error, force uncontinueable error?
-    //     fprintf(stderr, "ERROR: Unable to read improper JSON string");
-    // }
+    if (arena->head == NULL)
+    {
+        arena->head = head;
+    } else
+    {
+        json_arena_block_t *tail = head;
+        while (tail->next != NULL) tail = tail->next;
 
-    return json; // return json to continue parsing
+        tail->next = arena->head->next;
+        arena->head->next = head;
+    }
+    other->head = NULL;
 }
+//===== END ARENA IMPLEMENTATION =====
 
+//===== STRUCTURAL INDEX IMPLEMENTATION =====
 /**
- * \brief Helper function to determine if a character is a valid character in a json number
+ * \brief Helper function to count trailing zero bits
  *
- * \param[in] c character in question
+ * \param[in] bits non zero bit mask
  *
- * \return true if c is a valid json number character, false otherwise
+ * \return position of lowest set bit
  */
-static bool is_valid_json_number_char(char c)
+static int json_ctz64(uint64_t bits)
 {
-    return isdigit(c) || c == 'e' || c == 'E' || c == '.';
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#else
+    int count = 0;
+    while ((bits & 1) == 0)
+    {
+        bits >>= 1;
+        count++;
+    }
+    return count;
+#endif
 }
 
 /**
- * \brief Function to read a json number
+ * \brief Helper function to count leading zero bits
  *
- * \param[in] json input string
- * \param[in] json_parsed resultant json value to store parsed integer or floating point value
+ * \param[in] bits non zero bit mask
  *
- * \return remaining input string after parsing first json number found
+ * \return number of zero bits above the highest set bit
  */
-static char* read_json_number(char *json, json_value_t *json_parsed)
+static int json_clz64(uint64_t bits)
 {
-    json_element_t *json_element = (json_element_t *) calloc(1, sizeof(json_element_t));
-
-    // TODO: add support for E, e in json values?
-    // while string that is curretnly being read
-    bool is_float = false;
-    long is_negative = 1;
-    int floating_count = 0;
-    long integer = 0;
-
-    bool use_scientific_notation = false;
-    long exponent = 0;
-
-    // negative check
-    if (*json == '-') 
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(bits);
+#else
+    int count = 0;
+    while ((bits & ((uint64_t) 1 << 63)) == 0)
     {
-        is_negative = -1;
-        json++;
+        bits <<= 1;
+        count++;
     }
+    return count;
+#endif
+}
 
-    while (is_valid_json_number_char(*json))
-    {
-        if (*json == '.')
-        {
-            is_float = true;
-            json++;
-            continue;
-        }
-        
-        if (*json == 'e' || *json == 'E')
-        {
-            use_scientific_notation = true;
-            json++;
-            continue;
-        }
-
-        if (is_float && !use_scientific_notation) 
-        {
-            floating_count -= 1;
-        }
+/**
+ * \brief Helper function computing the prefix xor of a bit mask: bit i of the result is the xor of
+ * bits 0..i of the input. Applied to unescaped quotes this marks every byte inside a string.
+ *
+ * \param[in] bits bit mask
+ *
+ * \return prefix xor of bits
+ */
+static uint64_t json_prefix_xor(uint64_t bits)
+{
+#if defined(__PCLMUL__) && (defined(JSON_SIMD_AVX2) || defined(JSON_SIMD_SSE2))
+    // carry-less multiplication by all ones is a prefix xor
+    __m128i result = _mm_clmulepi64_si128(_mm_set_epi64x(0, (long long) bits), _mm_set1_epi8((char) 0xFF), 0);
+    return (uint64_t) _mm_cvtsi128_si64(result);
+#else
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+#endif
+}
 
-        if (use_scientific_notation)
-        {
-            exponent *= 10;
-            exponent += *json++ - '0';
-        } else 
-        {
-            integer *= 10;
-            integer += *json++ - '0';
-        }
+/**
+ * \brief Helper function to classify 64 bytes of input into quote, backslash, white space and
+ * structural character bit masks
+ *
+ * \param[in] in 64 readable bytes of input
+ * \param[in] block resultant bit masks
+ */
+static void json_classify_block(const char *in, json_block_t *block)
+{
+#if defined(JSON_SIMD_AVX2)
+    block->quote = block->backslash = block->white_space = block->op = 0;
+    for (int i = 0; i < 64; i += 32)
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *) (in + i));
+        __m256i folded = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20)); // folds [ ] onto { }
+
+        __m256i quote = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'));
+        __m256i backslash = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'));
+        __m256i white_space = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r'))));
+        __m256i op = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(','))));
+
+        block->quote |= (uint64_t) (uint32_t) _mm256_movemask_epi8(quote) << i;
+        block->backslash |= (uint64_t) (uint32_t) _mm256_movemask_epi8(backslash) << i;
+        block->white_space |= (uint64_t) (uint32_t) _mm256_movemask_epi8(white_space) << i;
+        block->op |= (uint64_t) (uint32_t) _mm256_movemask_epi8(op) << i;
     }
-
-    // apply negative
-    integer *= is_negative;
-
-    if (is_float) 
+#elif defined(JSON_SIMD_SSE2)
+    block->quote = block->backslash = block->white_space = block->op = 0;
+    for (int i = 0; i < 64; i += 16)
     {
-        if (use_scientific_notation) 
-        {
-            floating_count += exponent;
-        }
-
-        double float_value = (double) integer * pow(10, floating_count);
-        json_float_t json_float;
-        json_float.value = float_value;
-
-        json_element->floating = json_float;
-        
-        json_parsed->type = JSON_FLOAT;
-        json_parsed->value = json_element;
-    } else 
+        __m128i chunk = _mm_loadu_si128((const __m128i *) (in + i));
+        __m128i folded = _mm_or_si128(chunk, _mm_set1_epi8(0x20)); // folds [ ] onto { }
+
+        __m128i quote = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'));
+        __m128i backslash = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'));
+        __m128i white_space = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'))));
+        __m128i op = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(folded, _mm_set1_epi8('}'))),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(','))));
+
+        block->quote |= (uint64_t) (uint16_t) _mm_movemask_epi8(quote) << i;
+        block->backslash |= (uint64_t) (uint16_t) _mm_movemask_epi8(backslash) << i;
+        block->white_space |= (uint64_t) (uint16_t) _mm_movemask_epi8(white_space) << i;
+        block->op |= (uint64_t) (uint16_t) _mm_movemask_epi8(op) << i;
+    }
+#else
+    block->quote = block->backslash = block->white_space = block->op = 0;
+    for (int i = 0; i < 64; ++i)
     {
-        if (use_scientific_notation) 
+        uint64_t bit = (uint64_t) 1 << i;
+        switch (in[i])
         {
-            integer = integer * pow(10, exponent);
+            case '"': block->quote |= bit; break;
+            case '\\': block->backslash |= bit; break;
+            case ' ': case '\t': case '\n': case '\r': block->white_space |= bit; break;
+            case '{': case '}': case '[': case ']': case ':': case ',': block->op |= bit; break;
+            default: break;
         }
-
-        json_int_t json_int;
-        json_int.value = integer;
-
-        json_element->integer = json_int;
-
-        json_parsed->type = JSON_INT;
-        json_parsed->value = json_element;
     }
-
-    return json;
+#endif
 }
 
-
 /**
- * \brief Function to read a json object
+ * \brief Helper function to find the bytes of a 64 byte block that are escaped by an odd length run
+ * of backslashes. Runs may continue from the previous block.
  *
- * \param[in] json input string
- * \param[in] json_parsed resultant json value to store parsed json object
+ * \param[in] backslash backslash bit mask of the block
+ * \param[in] prev_escaped 1 if the first byte of the block is escaped, updated for the next block
  *
- * \return remaining input string after parsing first json object found
+ * \return bit mask of escaped bytes
  */
-static char* read_json_object(char *json, json_value_t *json_parsed)
+static uint64_t json_escaped_bits(uint64_t backslash, uint64_t *prev_escaped)
 {
-    json_element_t *json_element = (json_element_t *) calloc(1, sizeof(json_element_t));
-    json_object_t *json_object = NULL;
-    json++; // skip { character
+    const uint64_t odd_bits = 0xAAAAAAAAAAAAAAAAULL;
 
-    while (*json != '}')
+    if (backslash == 0)
     {
-        json = skip_white_space(json);
-        // read in the value for the string key
-        char *key;
-        if (*json == '"')
+        uint64_t escaped = *prev_escaped;
+        *prev_escaped = 0;
+        return escaped;
+    }
+
+    uint64_t potential_escape = backslash & ~*prev_escaped;
+    uint64_t escape_and_terminal = (((potential_escape << 1) | odd_bits) - potential_escape) ^ odd_bits;
+    uint64_t escaped = escape_and_terminal ^ (backslash | *prev_escaped);
+    *prev_escaped = (escape_and_terminal & backslash) >> 63;
+
+    return escaped;
+}
+
+/**
+ * \brief Stage 1 of the SIMD engine. Classifies the input 64 bytes at a time, resolves escaped
+ * quotes and string interiors with bit tricks and records the position of every token start:
+ * structural characters outside of strings, opening quotes and the first byte of every other scalar
+ * (numbers, true, false, null). The recursive descent then jumps from token to token instead of
+ * skipping white space byte by byte.
+ *
+ * NOTE: only double quoted strings are tracked, input with single quoted strings containing a
+ * double quote is not indexed correctly
+ *
+ * \param[in] json input string
+ * \param[in] size length of input, must be below UINT32_MAX
+ * \param[in] padded true if JSON_PADDING bytes after the input may be read
+ *
+ * \return sorted token start positions followed by a sentinel equal to size, NULL if out of memory
+ */
+static uint32_t* json_build_structural_index(const char *json, size_t size, bool padded)
+{
+    size_t capacity = size / 4 + 128;
+    size_t count = 0;
+    uint32_t *structurals = (uint32_t *) malloc(capacity * sizeof(uint32_t));
+    if (structurals == NULL) return NULL;
+
+    // state carried over from the previous block
+    uint64_t prev_escaped = 0;   // first byte of this block is escaped
+    uint64_t prev_in_string = 0; // all ones if the previous block ended inside a string
+    uint64_t prev_scalar = 0;    // previous block ended in the middle of a scalar
+
+    char tail[64];
+    for (size_t offset = 0; offset < size; offset += 64)
+    {
+        const char *in = json + offset;
+        if (size - offset < 64 && !padded)
         {
-            size_t string_size = find_string_size(json, '"');
-            key = (char *) malloc(string_size);
-            json = read_string(json, key, '"');
-        } else if (*json == '\'')
+            // copy the last block instead of reading past the input
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, in, size - offset);
+            in = tail;
+        }
+
+        json_block_t block;
+        json_classify_block(in, &block);
+
+        if (size - offset < 64)
         {
-            size_t string_size = find_string_size(json, '\'');
-            key = (char *) malloc(string_size);
-            json = read_string(json, key, '\'');
+            // bytes after the input read as white space
+            uint64_t valid = ((uint64_t) 1 << (size - offset)) - 1;
+            block.quote &= valid;
+            block.backslash &= valid;
+            block.op &= valid;
+            block.white_space |= ~valid;
         }
 
-        // printf("json current: %c\n", *json);
+        uint64_t escaped = json_escaped_bits(block.backslash, &prev_escaped);
 
-        // Skip possible space between key and colon
-        json = skip_white_space(json);
-        json++; // skip colon value
-        json = skip_white_space(json);
+        // Bytes between an opening quote (inclusive) and its closing quote (exclusive)
+        uint64_t quote = block.quote & ~escaped;
+        uint64_t in_string = json_prefix_xor(quote) ^ prev_in_string;
+        prev_in_string = (uint64_t) ((int64_t) in_string >> 63);
 
-        json_value_t *value = (json_value_t*) calloc(1, sizeof(json_value_t));
-        json = load_json_helper(json, value);
+        // Scalars are everything outside of strings that is not structural, white space or a quote
+        uint64_t scalar = ~(block.op | block.white_space | block.quote | in_string);
+        uint64_t scalar_start = scalar & ~((scalar << 1) | prev_scalar);
+        prev_scalar = scalar >> 63;
 
-        // Extend json object linked list
-        json_object_t *temp = (json_object_t*) calloc(1, sizeof(json_object_t));
-        temp->key = key;
-        temp->value = value;
-        temp->next = json_object;
+        uint64_t bits = (block.op & ~in_string) | (quote & in_string) | scalar_start;
 
-        json_object = temp;
+        if (count + 64 + 1 > capacity)
+        {
+            capacity *= 2;
+            uint32_t *grown = (uint32_t *) realloc(structurals, capacity * sizeof(uint32_t));
+            if (grown == NULL)
+            {
+                free(structurals);
+                return NULL;
+            }
+            structurals = grown;
+        }
 
-        // Skip possible space between key and comma
-        json = skip_white_space(json);
-        if (*json == ',')
+        while (bits != 0)
         {
-            json++; // skip comma value if it exists
+            structurals[count++] = (uint32_t) (offset + json_ctz64(bits));
+            bits &= bits - 1;
         }
-        json = skip_white_space(json);
     }
-    json++;
-    
-    json_element->object = json_object;
-    json_parsed->value = json_element;
 
-    return json;
+    structurals[count] = (uint32_t) size; // sentinel, stops skip_white_space at the end of the input
+
+    return structurals;
 }
+//===== END STRUCTURAL INDEX IMPLEMENTATION =====
 
+//===== ACCESS JSON IMPLEMENTATION =====
 /**
- * \brief Function to read a json array
+ * \brief Helper function to hash a json object key (64 bit FNV-1a)
  *
- * \param[in] json input string
- * \param[in] json_parsed resultant json value to store parsed json array
+ * \param[in] key key to hash
+ * \param[in] key_size length of key
  *
- * \return remaining input string after parsing first json array found
+ * \return hash of key
  */
-static char* read_json_array(char *json, json_value_t *json_parsed)
+static uint64_t json_hash_key(const char *key, size_t key_size)
 {
-    json_element_t *json_element = (json_element_t *) calloc(1, sizeof(json_element_t));
-    json_array_t *json_array = NULL;
-    json++; // skip [ character
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < key_size; ++i)
+    {
+        hash ^= (unsigned char) key[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash ^ (hash >> 32); // fold high bits in, index slots are picked from the low bits
+}
+
+/**
+ * \brief Helper function to pick the number of hash index slots for an object, keeps the load factor at or below 1/2
+ *
+ * \param[in] size number of members in the object
+ *
+ * \return power of two number of slots
+ */
+static size_t json_object_index_slots(size_t size)
+{
+    size_t index_slots = 16;
+    while (index_slots < size * 2)
+    {
+        index_slots *= 2;
+    }
+
+    return index_slots;
+}
 
-    while (*json != ']')
+/**
+ * \brief Helper function to build the open addressing (linear probing) hash index of a json object
+ *
+ * \param[in] json_object object whose members are indexed
+ * \param[in] index memory for index_slots slots, does not need to be zeroed
+ * \param[in] index_slots power of two number of slots, see json_object_index_slots
+ */
+static void json_object_build_index(json_object_t *json_object, uint32_t *index, size_t index_slots)
+{
+    size_t index_mask = index_slots - 1;
+    memset(index, 0, index_slots * sizeof(uint32_t));
+
+    for (size_t i = 0; i < json_object->size; ++i)
     {
-        json = skip_white_space(json);
+        json_object_entry_t *entry = &json_object->entries[i];
+        size_t slot = (size_t) json_hash_key(entry->key, entry->key_size) & index_mask;
+        while (index[slot] != 0)
+        {
+            slot = (slot + 1) & index_mask;
+        }
+        index[slot] = (uint32_t) (i + 1);
+    }
 
-        json_value_t *value = (json_value_t*) calloc(1, sizeof(json_value_t));
-        json = load_json_helper(json, value);
+    json_object->index = index;
+    json_object->index_mask = index_mask;
+}
+
+/**
+ * \brief Function to look up a member of a json object by key. Objects with a hash index are
+ * searched in O(1), small objects are searched linearly. If a key occurs more than once the first
+ * occurrence is returned.
+ *
+ * \param[in] json_value json object to search
+ * \param[in] key key to look for, does not need to be null terminated
+ * \param[in] key_size length of key
+ *
+ * \return pointer to the member value, NULL if json_value is not an object or does not contain key
+ */
+json_value_t* json_object_get(const json_value_t *json_value, const char *key, size_t key_size)
+{
+    if (json_value == NULL || json_value->type != JSON_OBJECT) return NULL;
+
+    json_object_t *json_object = json_value->value.object;
+    json_object_entry_t *entries = json_object->entries;
 
-        // Extend json object linked list
-        json_array_t *temp = (json_array_t*) calloc(1, sizeof(json_array_t));
-        temp->value = value;
-        temp->next = json_array;
+    if (json_object->index == NULL)
+    {
+        for (size_t i = 0; i < json_object->size; ++i)
+        {
+            if (entries[i].key_size == key_size && (entries[i].key == key || memcmp(entries[i].key, key, key_size) == 0))
+            {
+                return &entries[i].value;
+            }
+        }
 
-        json_array = temp;
+        return NULL;
+    }
 
-        // Skip possible space between key and comma
-        json = skip_white_space(json);
-        if (*json == ',')
+    size_t slot = (size_t) json_hash_key(key, key_size) & json_object->index_mask;
+    while (json_object->index[slot] != 0)
+    {
+        json_object_entry_t *entry = &entries[json_object->index[slot] - 1];
+        if (entry->key_size == key_size && (entry->key == key || memcmp(entry->key, key, key_size) == 0))
         {
-            json++; // skip comma value if it exists
+            return &entry->value;
         }
-        json = skip_white_space(json);
+        slot = (slot + 1) & json_object->index_mask;
     }
-    json++;
-    
-    json_element->array = json_array;
-    json_parsed->value = json_element;
 
-    return json;
+    return NULL;
 }
 
+/**
+ * \brief Function to get the number of members of a json object
+ *
+ * \param[in] json_value json object
+ *
+ * \return number of members, 0 if json_value is not an object
+ */
+size_t json_object_size(const json_value_t *json_value)
+{
+    if (json_value == NULL || json_value->type != JSON_OBJECT) return 0;
+
+    return json_value->value.object->size;
+}
 
 /**
- * \brief Helper function to read a json value
+ * \brief Function to access an element of a json array in O(1)
  *
- * \param[in] json input string
- * \param[in] json_parsed resultant json value to store parsed json value
+ * \param[in] json_value json array
+ * \param[in] i position of the element
+ *
+ * \return pointer to the element, NULL if json_value is not an array or i is out of bounds
+ */
+json_value_t* json_array_get(const json_value_t *json_value, size_t i)
+{
+    if (json_value == NULL || json_value->type != JSON_ARRAY) return NULL;
+
+    json_array_t *json_array = json_value->value.array;
+    if (i >= json_array->size) return NULL;
+
+    return &json_array->values[i];
+}
+
+/**
+ * \brief Function to get the number of elements of a json array
  *
- * \return remaining input string after parsing first json object found
+ * \param[in] json_value json array
+ *
+ * \return number of elements, 0 if json_value is not an array
+ */
+size_t json_array_size(const json_value_t *json_value)
+{
+    if (json_value == NULL || json_value->type != JSON_ARRAY) return 0;
+
+    return json_value->value.array->size;
+}
+
+/**
+ * \brief Function to append an element to a json array built with build_json_array. Storage grows
+ * geometrically so appending is amortized O(1). Arrays owned by a document can not grow.
+ *
+ * NOTE: pointers returned by json_array_get are invalidated when the array grows
+ *
+ * \param[in] json_value json array built with build_json_array
+ * \param[in] element json value to append, the array takes ownership of it
+ *
+ * \return true if the element was appended, false otherwise
  */
-static char* load_json_helper(char *json, json_value_t *json_parsed) 
+bool json_array_append(json_value_t *json_value, json_value_t element)
 {
-    json = skip_white_space(json);
+    if (json_value == NULL || json_value->type != JSON_ARRAY || json_value->flags != JSON_VALUE_HEAP) return false;
 
-    /*
-    Recursive descent parser
-    - ", ' => leads to json string
-    - n => leads to json null
-    - t or f => leads to json bool
-    - 0-9, - => leads to json int or float
-    - { => leads to json object
-    - [ => leads to json array
-    */
-    switch (*json)
+    json_array_t *json_array = json_value->value.array;
+    if (json_array->size == json_array->capacity)
     {
-        case '"':
-            json_parsed->type = JSON_STRING;
-            // parse json string value
-            json = read_json_string(json, json_parsed, '"');
-            break;
+        size_t capacity = json_array->capacity == 0 ? 4 : json_array->capacity * 2;
+        json_value_t *values = (json_value_t *) realloc(json_array->values, capacity * sizeof(json_value_t));
+        if (values == NULL) return false;
 
-        case '\'':
-            json_parsed->type = JSON_STRING;
-            // parse json string value that is enclosed by single quotes
-            json = read_json_string(json, json_parsed, '\'');
-            break;
+        json_array->values = values;
+        json_array->capacity = capacity;
+    }
 
-        case '0':
-        case '1':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-        case '9':
-        case '-':
-            // parse json int / float
-            json = read_json_number(json, json_parsed);
-            break;
+    json_array->values[json_array->size++] = element;
 
-        case '{':
-            json_parsed->type = JSON_OBJECT;
-            // parse json object
-            json = read_json_object(json, json_parsed);
-            break;
+    return true;
+}
 
-        case '[':
-            json_parsed->type = JSON_ARRAY;
-            // parse json_array
-            json = read_json_array(json, json_parsed);
-            break;
+/**
+ * \brief Helper function to store a string in a node: strings of up to JSON_STRING_INLINE_MAX bytes
+ * are copied into the node, longer ones are referenced where they are
+ *
+ * \param[in] json_value node to store the string in, its type and flags are left alone
+ * \param[in] string bytes of the string, null terminated if it is stored out of line
+ * \param[in] size length of string
+ *
+ * \return true if the string was stored, false if it is longer than a node can describe
+ */
+static bool json_string_set(json_value_t *json_value, const char *string, size_t size)
+{
+    if (size > UINT32_MAX) return false;
+
+    if (size <= JSON_STRING_INLINE_MAX)
+    {
+        char *bytes = (char *) json_value; // the string overlays value, size and inline_end
+        memcpy(bytes, string, size);
+        bytes[size] = '\0';
+        json_value->inline_size = (unsigned char) (size + 1);
+    } else
+    {
+        json_value->value.string = string;
+        json_value->size = (uint32_t) size;
+        json_value->inline_size = 0;
+    }
+
+    return true;
+}
+
+/**
+ * \brief Function to get the bytes of a json string, wherever the node keeps them
+ *
+ * \param[in] json_value json string
+ * \param[in] size receives the length of the string, not counting the null termination character,
+ * 0 if json_value is not a string. May be NULL
+ *
+ * \return null terminated string, NULL if json_value is not a string. A short string lives inside
+ * json_value, the pointer is only valid as long as that node is
+ */
+const char* json_string_get(const json_value_t *json_value, size_t *size)
+{
+    if (json_value == NULL || json_value->type != JSON_STRING)
+    {
+        if (size != NULL) *size = 0;
+        return NULL;
+    }
+
+    if (json_value->inline_size != 0)
+    {
+        if (size != NULL) *size = (size_t) json_value->inline_size - 1;
+        return (const char *) json_value;
+    }
+
+    if (size != NULL) *size = json_value->size;
+    return json_value->value.string;
+}
+
+/**
+ * \brief Function to get the length of a json string
+ *
+ * \param[in] json_value json string
+ *
+ * \return length in bytes not counting the null termination character, 0 if json_value is not a string
+ */
+size_t json_string_size(const json_value_t *json_value)
+{
+    size_t size = 0;
+    json_string_get(json_value, &size);
+
+    return size;
+}
+//===== END ACCESS JSON IMPLEMENTATION =====
+
+//===== DUMP JSON IMPLEMENTATION =====
+/**
+ * \brief Number of bytes every input byte of a string takes once escaped: quote, backslash and the
+ * short control escapes take 2, other control characters take 6 (\u00XX), everything else 1.
+ */
+static const unsigned char json_escape_size[256] = {
+    6, 6, 6, 6, 6, 6, 6, 6, 2, 2, 2, 6, 2, 2, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+};
+
+/**
+ * \brief Helper function to find the next byte of a string that needs escaping (quote, backslash or
+ * control character), 32 (AVX2) or 16 (SSE2) bytes at a time. Vector loads never go past the string.
+ *
+ * \param[in] string string to search
+ * \param[in] i position to start searching at
+ * \param[in] size length of string
+ *
+ * \return position of the first byte at or after i that needs escaping, size if there is none
+ */
+static size_t json_find_escape(const char *string, size_t i, size_t size)
+{
+#if defined(JSON_SIMD_AVX2)
+    while (i + 32 <= size)
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *) (string + i));
+        __m256i special = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'))),
+            _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, _mm256_set1_epi8(0x1F)), chunk)); // bytes <= 0x1F
+        uint32_t mask = (uint32_t) _mm256_movemask_epi8(special);
+        if (mask != 0) return i + json_ctz64(mask);
+        i += 32;
+    }
+#elif defined(JSON_SIMD_SSE2)
+    while (i + 16 <= size)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) (string + i));
+        __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))),
+            _mm_cmpeq_epi8(_mm_min_epu8(chunk, _mm_set1_epi8(0x1F)), chunk)); // bytes <= 0x1F
+        uint32_t mask = (uint32_t) _mm_movemask_epi8(special);
+        if (mask != 0) return i + json_ctz64(mask);
+        i += 16;
+    }
+#endif
+
+    while (i < size && json_escape_size[(unsigned char) string[i]] == 1)
+    {
+        i++;
+    }
+
+    return i;
+}
+
+/**
+ * \brief Helper function to write the escape sequence of a single byte
+ *
+ * \param[in] out output buffer with room for 6 bytes
+ * \param[in] c byte that needs escaping, see json_escape_size
+ *
+ * \return output buffer after the escape sequence
+ */
+static char* json_escape_char(char *out, unsigned char c)
+{
+    static const char hex_digits[] = "0123456789abcdef";
+
+    *out++ = '\\';
+    switch (c)
+    {
+        case '"': *out++ = '"'; break;
+        case '\\': *out++ = '\\'; break;
+        case '\b': *out++ = 'b'; break;
+        case '\f': *out++ = 'f'; break;
+        case '\n': *out++ = 'n'; break;
+        case '\r': *out++ = 'r'; break;
+        case '\t': *out++ = 't'; break;
         default:
-            // check for json null
-            // check for json boolean (true and false)
-            if (*json == 't' && *(json + 1) == 'r' && *(json + 2) == 'u' && *(json + 3) == 'e')
-            {
-                json_parsed->type = JSON_BOOL;
-                *json_parsed = build_json_bool(true);
-                json += 4;
-            }
-            else if (*json == 'f' && *(json + 1) == 'a' && *(json + 2) == 'l' && *(json + 3) == 's' && *(json + 4) == 'e')
-            {
-                json_parsed->type = JSON_BOOL;
-                *json_parsed = build_json_bool(false);
-                json += 5;
-            }
-            else if (*json == 'n' && *(json + 1) == 'u' && *(json + 2) == 'l' && *(json + 3) == 'l')
-            {
-                json_parsed->type = JSON_NULL;
-                *json_parsed = build_json_null();
-                json += 4;
-            }
+            *out++ = 'u';
+            *out++ = '0';
+            *out++ = '0';
+            *out++ = hex_digits[c >> 4];
+            *out++ = hex_digits[c & 0xF];
             break;
     }
 
-    return json;
+    return out;
 }
 
 /**
- * \brief json parser (deserializer) in jajson.h
+ * \brief Helper function to compute the length of a string once quoted and escaped. Clean spans
+ * are skipped with json_find_escape.
  *
- * \param[in] json: input string that represents json data
+ * \param[in] string string to measure
+ * \param[in] size length of string
  *
- * \returns json_value_t variable containing json data represented
- * using jajson.h defined json structs, enums, and unions
+ * \return number of bytes json_dump_string writes for string
  */
-json_value_t* load_json(char *json)
+static size_t json_dump_string_size(const char *string, size_t size)
 {
-    // NOTE: only allocates memory to direct descendents
-    json_value_t *json_value = (json_value_t*) calloc(1, sizeof(json_value_t));
+    size_t dump_size = 2 + size; // quotes, then one byte per input byte
+    size_t i = json_find_escape(string, 0, size);
+    while (i < size)
+    {
+        dump_size += json_escape_size[(unsigned char) string[i]] - 1;
+        i = json_find_escape(string, i + 1, size);
+    }
 
-    json = load_json_helper(json, json_value);
-    
-    return json_value;
+    return dump_size;
 }
 
 /**
- * returns true if the freeing succeeded
+ * \brief Helper function to write a string quoted and escaped. Clean spans found by
+ * json_find_escape are copied in bulk.
+ *
+ * \param[in] out output buffer with room for json_dump_string_size bytes
+ * \param[in] string string to write
+ * \param[in] size length of string
+ *
+ * \return output buffer after the closing quote
  */
-void free_json(json_value_t *json_parsed) {
-    if (json_parsed->type == JSON_ARRAY) {
-        json_array_t *p = json_parsed->value->array;
-        while (p != NULL) {
-            json_array_t *temp = p->next;
-            free_json(p->value);
-            p = temp;
-        }
-    } else if ( json_parsed->type == JSON_OBJECT) {
-        json_object_t *p = json_parsed->value->object;
-        while (p != NULL) {
-            json_object_t *temp = p->next;
-            free_json(p->value);
-            p = temp;
-        }       
+static char* json_dump_string(char *out, const char *string, size_t size)
+{
+    *out++ = '"';
+    size_t run_start = 0;
+    for (;;)
+    {
+        size_t i = json_find_escape(string, run_start, size);
+        memcpy(out, string + run_start, i - run_start);
+        out += i - run_start;
+        if (i == size) break;
+
+        out = json_escape_char(out, (unsigned char) string[i]);
+        run_start = i + 1;
     }
+    *out++ = '"';
 
-    free(json_parsed->value);
-    free(json_parsed);
+    return out;
+}
+
+/**
+ * \brief Helper function to count the decimal digits of an unsigned integer. The bit length gives
+ * an estimate that is off by at most one, a comparison against the next power of ten settles it.
+ *
+ * \param[in] value integer to measure
+ *
+ * \return number of decimal digits of value, 1 for 0
+ */
+static size_t json_count_digits(uint64_t value)
+{
+    static const uint64_t powers_of_ten[] = {
+        0, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+        10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+        1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL,
+        10000000000000000000ULL
+    };
+
+    int bits = 64 - json_clz64(value | 1);
+    size_t digits = (size_t) ((bits * 1233) >> 12); // bits * log10(2)
+
+    return digits + (value >= powers_of_ten[digits]);
+}
+
+/**
+ * \brief Helper function to compute the number of characters of an integer in decimal
+ *
+ * \param[in] value integer to measure
+ *
+ * \return number of bytes json_dump_int writes for value
+ */
+static size_t json_dump_int_size(long value)
+{
+    unsigned long magnitude = value < 0 ? 0 - (unsigned long) value : (unsigned long) value;
+    return (value < 0) + json_count_digits(magnitude);
+}
+
+/**
+ * \brief Helper function to write an integer in decimal
+ *
+ * \param[in] out output buffer with room for json_dump_int_size bytes
+ * \param[in] value integer to write
+ *
+ * \return output buffer after the last digit
+ */
+static char* json_dump_int(char *out, long value)
+{
+    if (value < 0) *out++ = '-';
+    unsigned long magnitude = value < 0 ? 0 - (unsigned long) value : (unsigned long) value;
+
+    size_t length = json_count_digits(magnitude);
+    json_write_digits(out, magnitude, length);
+
+    return out + length;
+}
+
+/**
+ * \brief Helper function to write the decimal digits of an integer, two digits per division
+ * through a table of all pairs "00" to "99"
+ *
+ * \param[in] out output buffer with room for length bytes
+ * \param[in] value integer to write
+ * \param[in] length number of decimal digits of value, see json_count_digits
+ */
+static void json_write_digits(char *out, uint64_t value, size_t length)
+{
+    static const char digit_pairs[201] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    // digits come out last to first, write them from the end of the number backwards
+    char *p = out + length;
+    while (value >= 100)
+    {
+        unsigned pair = (unsigned) (value % 100) * 2;
+        value /= 100;
+        p -= 2;
+        memcpy(p, digit_pairs + pair, 2);
+    }
+
+    if (value >= 10)
+    {
+        memcpy(p - 2, digit_pairs + value * 2, 2);
+    } else
+    {
+        p[-1] = (char) ('0' + value);
+    }
+}
+
+/**
+ * \brief Helper function for the first pass of dump_json_ex, computes the exact output length
+ *
+ * \param[in] json_value value to measure
+ * \param[in] flags json_dump_flags_t values or'ed together
+ * \param[in] depth nesting level of json_value
+ *
+ * \return number of bytes json_dump_value writes for json_value
+ */
+static size_t json_dump_size(const json_value_t *json_value, unsigned int flags, size_t depth)
+{
+    bool pretty = (flags & JSON_DUMP_PRETTY) != 0;
+    char buffer[32];
+
+    switch (json_value->type)
+    {
+        case JSON_STRING:
+        {
+            size_t size;
+            const char *string = json_string_get(json_value, &size);
+            return json_dump_string_size(string, size);
+        }
+
+        case JSON_INT:
+            return json_dump_int_size(json_value->value.integer);
+
+        case JSON_FLOAT:
+            return json_format_float(json_value->value.floating, buffer);
+
+        case JSON_BOOL:
+            return json_value->value.boolean ? 4 : 5;
+
+        case JSON_NULL:
+            return 4;
+
+        case JSON_OBJECT:
+        {
+            json_object_t *json_object = json_value->value.object;
+            size_t size = 2; // braces
+            if (json_object->size == 0) return size;
+
+            // separators: ',' between members, ':' per member, pretty adds new lines, indents and a space after ':'
+            size += json_object->size - 1 + json_object->size;
+            if (pretty) size += json_object->size * (1 + (depth + 1) * JSON_DUMP_INDENT + 1) + 1 + depth * JSON_DUMP_INDENT;
+
+            for (size_t i = 0; i < json_object->size; ++i)
+            {
+                size += json_dump_string_size(json_object->entries[i].key, json_object->entries[i].key_size);
+                size += json_dump_size(&json_object->entries[i].value, flags, depth + 1);
+            }
+            return size;
+        }
+
+        case JSON_ARRAY:
+        {
+            json_array_t *json_array = json_value->value.array;
+            size_t size = 2; // brackets
+            if (json_array->size == 0) return size;
+
+            // separators: ',' between elements, pretty adds new lines and indents
+            size += json_array->size - 1;
+            if (pretty) size += json_array->size * (1 + (depth + 1) * JSON_DUMP_INDENT) + 1 + depth * JSON_DUMP_INDENT;
+
+            for (size_t i = 0; i < json_array->size; ++i)
+            {
+                size += json_dump_size(&json_array->values[i], flags, depth + 1);
+            }
+            return size;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Helper function to start a new line indented to depth
+ *
+ * \param[in] out output buffer
+ * \param[in] depth nesting level of the next line
+ *
+ * \return output buffer after the indent
+ */
+static char* json_dump_indent(char *out, size_t depth)
+{
+    *out++ = '\n';
+    memset(out, ' ', depth * JSON_DUMP_INDENT);
+    return out + depth * JSON_DUMP_INDENT;
+}
+
+/**
+ * \brief Helper function for the second pass of dump_json_ex, writes a value into a buffer that
+ * json_dump_size has sized
+ *
+ * \param[in] out output buffer
+ * \param[in] json_value value to write
+ * \param[in] flags json_dump_flags_t values or'ed together
+ * \param[in] depth nesting level of json_value
+ *
+ * \return output buffer after the value
+ */
+static char* json_dump_value(char *out, const json_value_t *json_value, unsigned int flags, size_t depth)
+{
+    bool pretty = (flags & JSON_DUMP_PRETTY) != 0;
+
+    switch (json_value->type)
+    {
+        case JSON_STRING:
+        {
+            size_t size;
+            const char *string = json_string_get(json_value, &size);
+            return json_dump_string(out, string, size);
+        }
+
+        case JSON_INT:
+            return json_dump_int(out, json_value->value.integer);
+
+        case JSON_FLOAT:
+            return out + json_format_float(json_value->value.floating, out);
+
+        case JSON_BOOL:
+            if (json_value->value.boolean)
+            {
+                memcpy(out, "true", 4);
+                return out + 4;
+            }
+            memcpy(out, "false", 5);
+            return out + 5;
+
+        case JSON_NULL:
+            memcpy(out, "null", 4);
+            return out + 4;
+
+        case JSON_OBJECT:
+        {
+            json_object_t *json_object = json_value->value.object;
+            *out++ = '{';
+            for (size_t i = 0; i < json_object->size; ++i)
+            {
+                if (i > 0) *out++ = ',';
+                if (pretty) out = json_dump_indent(out, depth + 1);
+
+                out = json_dump_string(out, json_object->entries[i].key, json_object->entries[i].key_size);
+                *out++ = ':';
+                if (pretty) *out++ = ' ';
+                out = json_dump_value(out, &json_object->entries[i].value, flags, depth + 1);
+            }
+            if (pretty && json_object->size > 0) out = json_dump_indent(out, depth);
+            *out++ = '}';
+            return out;
+        }
+
+        case JSON_ARRAY:
+        {
+            json_array_t *json_array = json_value->value.array;
+            *out++ = '[';
+            for (size_t i = 0; i < json_array->size; ++i)
+            {
+                if (i > 0) *out++ = ',';
+                if (pretty) out = json_dump_indent(out, depth + 1);
+
+                out = json_dump_value(out, &json_array->values[i], flags, depth + 1);
+            }
+            if (pretty && json_array->size > 0) out = json_dump_indent(out, depth);
+            *out++ = ']';
+            return out;
+        }
+    }
+
+    return out;
+}
+
+/**
+ * \brief json serializer in jajson.h, writes minified json
+ *
+ * \param[in] json_value: json_value_t pointer to access json structured data
+ *
+ * \returns null terminated string containing json data in string format, release it with free.
+ * NULL if out of memory
+ */
+char* dump_json(const json_value_t *json_value)
+{
+    return dump_json_ex(json_value, JSON_DUMP_MINIFIED, NULL);
+}
+
+/**
+ * \brief json serializer in jajson.h taking dump flags. The first pass computes the exact output
+ * length (escapes, number widths, indents), the second pass writes into one allocation of exactly
+ * that size.
+ *
+ * \param[in] json_value: json_value_t pointer to access json structured data
+ * \param[in] flags: json_dump_flags_t values or'ed together
+ * \param[in] size: receives the length of the output without the null terminator, may be NULL
+ *
+ * \returns null terminated string containing json data in string format, release it with free.
+ * NULL if out of memory
+ */
+char* dump_json_ex(const json_value_t *json_value, unsigned int flags, size_t *size)
+{
+    size_t dump_size = json_dump_size(json_value, flags, 0);
+
+    char *json = (char *) malloc(dump_size + 1);
+    if (json == NULL) return NULL;
+
+    char *end = json_dump_value(json, json_value, flags, 0);
+    *end = '\0';
+
+    if (size != NULL) *size = dump_size;
+
+    return json;
+}
+//===== END DUMP JSON IMPLEMENTATION =====
+
+/**
+ * \brief Helper function to different types of white space in string. When the parser carries a
+ * structural index the next token start is looked up instead of scanning byte by byte.
+ * 
+ * \param[in] parser parser state, possibly holding a structural index
+ * \param[in] json input string
+*
+ * \return remaining string after skipping white space characters
+ */
+static char* skip_white_space(json_parser_t *parser, char *json) 
+{
+    if (parser->structurals != NULL)
+    {
+        // structural positions are sorted and end with a sentinel at the end of the input
+        size_t offset = (size_t) (json - parser->input);
+        while (parser->structurals[parser->structural_cursor] < offset) {
+            parser->structural_cursor++;
+        }
+
+        // the index only records where scalars start, a byte glued to the end of one (1x, truex) is
+        // not in it: stop there like the byte by byte path does
+        bool indexed = parser->structurals[parser->structural_cursor] == offset;
+        if (!indexed && json < parser->end && *json != ' ' && *json != '\t' && *json != '\n' && *json != '\r') {
+            return json;
+        }
+
+        return parser->input + parser->structurals[parser->structural_cursor];
+    }
+
+    while (json < parser->end && (*json == ' ' || *json == '\t' || *json == '\n' || *json == '\r')) {
+        json++;
+    }
+
+    return json;
+}
+
+/**
+ * \brief Helper function to read four hex digits of a \u escape
+ *
+ * \param[in] in first hex digit
+ * \param[in] end end of input
+ *
+ * \return code unit described by the hex digits, -1 if they are not valid hex digits
+ */
+static long read_hex4(const char *in, const char *end)
+{
+    if (end - in < 4) return -1;
+
+    long code = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        char c = in[i];
+        code <<= 4;
+        if (c >= '0' && c <= '9') code |= c - '0';
+        else if (c >= 'a' && c <= 'f') code |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') code |= c - 'A' + 10;
+        else return -1;
+    }
+
+    return code;
+}
+
+/**
+ * \brief Helper function to decode a single escape sequence of a json string. \uXXXX escapes
+ * (including surrogate pairs) are written as UTF-8. Unknown escapes, malformed \u escapes and
+ * surrogates without their other half are rejected. Writes at most 4 bytes.
+ *
+ * \param[in] parser parser state that records the error
+ * \param[in] in input string pointing at the backslash
+ * \param[in] out address of the output pointer, advanced past the decoded bytes
+ *
+ * \return remaining input string after the escape sequence
+ */
+static char* read_escape(json_parser_t *parser, char *in, char **out)
+{
+    const char *end = parser->end;
+    if (end - in < 2) return (char *) end;
+
+    char *o = *out;
+    switch (in[1])
+    {
+        case '"': case '\\': case '/': case '\'': *o++ = in[1]; in += 2; break;
+        case 'b': *o++ = '\b'; in += 2; break;
+        case 'f': *o++ = '\f'; in += 2; break;
+        case 'n': *o++ = '\n'; in += 2; break;
+        case 'r': *o++ = '\r'; in += 2; break;
+        case 't': *o++ = '\t'; in += 2; break;
+        case 'u':
+        {
+            long code = read_hex4(in + 2, end);
+            if (code < 0 || (code >= 0xDC00 && code <= 0xDFFF)) return json_parser_fail(parser, in, "invalid \\u escape");
+
+            // a high surrogate has to be followed by the low surrogate it pairs with
+            if (code >= 0xD800 && code <= 0xDBFF)
+            {
+                long low = end - in >= 12 && in[6] == '\\' && in[7] == 'u' ? read_hex4(in + 8, end) : -1;
+                if (low < 0xDC00 || low > 0xDFFF) return json_parser_fail(parser, in, "invalid \\u escape");
+
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                in += 6;
+            }
+            in += 6;
+
+            if (code < 0x80)
+            {
+                *o++ = (char) code;
+            } else if (code < 0x800)
+            {
+                *o++ = (char) (0xC0 | (code >> 6));
+                *o++ = (char) (0x80 | (code & 0x3F));
+            } else if (code < 0x10000)
+            {
+                *o++ = (char) (0xE0 | (code >> 12));
+                *o++ = (char) (0x80 | ((code >> 6) & 0x3F));
+                *o++ = (char) (0x80 | (code & 0x3F));
+            } else
+            {
+                *o++ = (char) (0xF0 | (code >> 18));
+                *o++ = (char) (0x80 | ((code >> 12) & 0x3F));
+                *o++ = (char) (0x80 | ((code >> 6) & 0x3F));
+                *o++ = (char) (0x80 | (code & 0x3F));
+            }
+            break;
+        }
+        default:
+            return json_parser_fail(parser, in, "invalid escape sequence");
+    }
+
+    *out = o;
+    return in;
+}
+
+/**
+ * \brief Helper function to read a json string from input in a single pass. Runs without quotes or
+ * backslashes are found 32 (AVX2) or 16 (SSE2) bytes at a time and copied straight into the arena,
+ * escapes are decoded on a slow path.
+ * 
+ * \param[in] parser parser state owning the arena
+ * \param[in] in input string pointing at the opening quote
+ * \param[in] out_string address of a pointer that stores the parsed, null terminated string
+ * \param[in] out_size address of a size that stores the length of the parsed string
+ * \param[in] quote_style quote type the string to be parsed will be enclosed by
+ *
+ * \return remaining input string after reading the first string from the input string
+ */
+static char* read_string(json_parser_t *parser, char *in, const char **out_string, size_t *out_size, char quote_style)
+{
+    if (parser->insitu) return read_string_insitu(parser, in, out_string, out_size, quote_style);
+    if (parser->arena == NULL) return read_string_borrowed(parser, in, out_string, out_size, quote_style);
+
+    size_t available;
+    char *start = json_arena_reserve(parser->arena, JSON_STRING_RESERVE, &available);
+    if (start == NULL)
+    {
+        *out_string = "";
+        *out_size = 0;
+        return json_parser_fail(parser, in, "out of memory");
+    }
+
+    char *out = start;
+    char *limit = start + available;
+
+    // Skip '"' or '\''
+    in++;
+
+    for (;;)
+    {
+        // keep room for one vector store, one decoded escape and the null termination character
+        if ((size_t) (limit - out) < JSON_STRING_RESERVE)
+        {
+            size_t size = (size_t) (out - start);
+            char *moved = json_arena_reserve(parser->arena, size * 2 + JSON_STRING_RESERVE, &available);
+            if (moved == NULL)
+            {
+                // nothing was committed yet, the partial string is simply dropped
+                *out_string = "";
+                *out_size = 0;
+                return json_parser_fail(parser, in, "out of memory");
+            }
+            if (moved != start) memcpy(moved, start, size);
+
+            start = moved;
+            out = moved + size;
+            limit = moved + available;
+        }
+
+#if defined(JSON_SIMD_AVX2)
+        if (parser->readable_end - in >= 32)
+        {
+            // copy speculatively, only the bytes before the first quote or backslash are kept
+            __m256i chunk = _mm256_loadu_si256((const __m256i *) in);
+            _mm256_storeu_si256((__m256i *) out, chunk);
+            uint32_t mask = (uint32_t) _mm256_movemask_epi8(_mm256_or_si256(
+                _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(quote_style)),
+                _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'))));
+            if (parser->end - in < 32) mask |= (uint32_t) 1 << (parser->end - in); // stop at the end of padded input
+            if (mask == 0)
+            {
+                in += 32;
+                out += 32;
+                continue;
+            }
+
+            int clean = json_ctz64(mask);
+            in += clean;
+            out += clean;
+        } else
+#elif defined(JSON_SIMD_SSE2)
+        if (parser->readable_end - in >= 16)
+        {
+            // copy speculatively, only the bytes before the first quote or backslash are kept
+            __m128i chunk = _mm_loadu_si128((const __m128i *) in);
+            _mm_storeu_si128((__m128i *) out, chunk);
+            uint32_t mask = (uint32_t) _mm_movemask_epi8(_mm_or_si128(
+                _mm_cmpeq_epi8(chunk, _mm_set1_epi8(quote_style)),
+                _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))));
+            if (parser->end - in < 16) mask |= (uint32_t) 1 << (parser->end - in); // stop at the end of padded input
+            if (mask == 0)
+            {
+                in += 16;
+                out += 16;
+                continue;
+            }
+
+            int clean = json_ctz64(mask);
+            in += clean;
+            out += clean;
+        } else
+#endif
+        {
+            // scalar fallback, also used for the last bytes of the input
+            while (in < parser->end && *in != quote_style && *in != '\\' && out < limit - 5)
+            {
+                *out++ = *in++;
+            }
+        }
+
+        if (in >= parser->end)
+        {
+            json_parser_fail(parser, in, "unterminated string");
+            break;
+        }
+
+        if (*in == quote_style)
+        {
+            in++;
+            break;
+        }
+
+        if (*in == '\\')
+        {
+            in = read_escape(parser, in, &out);
+            if (parser->error.message != NULL) break;
+        }
+    }
+
+    *out = '\0';
+    json_arena_commit(parser->arena, (size_t) (out - start) + 1);
+
+    *out_string = start;
+    *out_size = (size_t) (out - start);
+
+    return in;
+}
+
+/**
+ * \brief Helper function to find the next quote or backslash, 32 (AVX2) or 16 (SSE2) bytes at a time
+ *
+ * \param[in] parser parser state holding the bounds of the input
+ * \param[in] in input string to search
+ * \param[in] quote_style quote type that ends the current string
+ *
+ * \return first quote or backslash at or after in, end of input if there is none
+ */
+static char* json_find_quote_or_backslash(json_parser_t *parser, char *in, char quote_style)
+{
+    const char *end = parser->end;
+
+#if defined(JSON_SIMD_AVX2)
+    while (parser->readable_end - in >= 32)
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *) in);
+        uint32_t mask = (uint32_t) _mm256_movemask_epi8(_mm256_or_si256(
+            _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(quote_style)),
+            _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'))));
+        if (end - in < 32) mask |= (uint32_t) 1 << (end - in); // stop at the end of padded input
+        if (mask != 0) return in + json_ctz64(mask);
+        in += 32;
+    }
+#elif defined(JSON_SIMD_SSE2)
+    while (parser->readable_end - in >= 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) in);
+        uint32_t mask = (uint32_t) _mm_movemask_epi8(_mm_or_si128(
+            _mm_cmpeq_epi8(chunk, _mm_set1_epi8(quote_style)),
+            _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))));
+        if (end - in < 16) mask |= (uint32_t) 1 << (end - in); // stop at the end of padded input
+        if (mask != 0) return in + json_ctz64(mask);
+        in += 16;
+    }
+#endif
+
+    while (in < end && *in != quote_style && *in != '\\')
+    {
+        in++;
+    }
+
+    return in;
+}
+
+/**
+ * \brief Helper function to read a json string in place. A decoded escape is never longer than the
+ * escape itself, so the string is written back over its own input and null terminated there
+ * (at the latest on the closing quote). Strings without escapes are not moved at all.
+ *
+ * \param[in] parser parser state
+ * \param[in] in input string pointing at the opening quote
+ * \param[in] out_string address of a pointer that stores the parsed, null terminated string
+ * \param[in] out_size address of a size that stores the length of the parsed string
+ * \param[in] quote_style quote type the string to be parsed will be enclosed by
+ *
+ * \return remaining input string after reading the first string from the input string
+ */
+static char* read_string_insitu(json_parser_t *parser, char *in, const char **out_string, size_t *out_size, char quote_style)
+{
+    // Skip '"' or '\''
+    char *start = ++in;
+    char *out = start;
+
+    for (;;)
+    {
+        char *run = in;
+        in = json_find_quote_or_backslash(parser, in, quote_style);
+
+        // shift the run down over the bytes freed by earlier escapes
+        if (out != run) memmove(out, run, (size_t) (in - run));
+        out += in - run;
+
+        if (in >= parser->end)
+        {
+            json_parser_fail(parser, in, "unterminated string");
+            break;
+        }
+
+        if (*in == quote_style)
+        {
+            in++;
+            break;
+        }
+
+        in = read_escape(parser, in, &out);
+        if (parser->error.message != NULL) break;
+    }
+
+    *out = '\0';
+
+    *out_string = start;
+    *out_size = (size_t) (out - start);
+
+    return in;
+}
+
+/**
+ * \brief Helper function to grow the scratch buffer strings with escapes are decoded into when
+ * parsing without an arena
+ *
+ * \param[in] parser parser state owning the scratch buffer
+ * \param[in] size number of bytes the scratch buffer needs to hold
+ *
+ * \return true if the scratch buffer holds at least size bytes, false if out of memory
+ */
+static bool json_parser_grow_scratch(json_parser_t *parser, size_t size)
+{
+    if (size <= parser->scratch_capacity) return true;
+
+    size_t scratch_capacity = parser->scratch_capacity == 0 ? 256 : parser->scratch_capacity;
+    while (scratch_capacity < size)
+    {
+        scratch_capacity *= 2;
+    }
+
+    char *scratch = (char *) realloc(parser->scratch, scratch_capacity);
+    if (scratch == NULL) return false;
+
+    parser->scratch = scratch;
+    parser->scratch_capacity = scratch_capacity;
+
+    return true;
+}
+
+/**
+ * \brief Helper function to read a json string without an arena, for SAX parses. Strings without
+ * escapes are handed out as a pointer into the input, strings with escapes are decoded into the
+ * parser's scratch buffer. Neither is null terminated.
+ *
+ * \param[in] parser parser state owning the scratch buffer
+ * \param[in] in input string pointing at the opening quote
+ * \param[in] out_string address of a pointer that stores the parsed string
+ * \param[in] out_size address of a size that stores the length of the parsed string
+ * \param[in] quote_style quote type the string to be parsed will be enclosed by
+ *
+ * \return remaining input string after reading the first string from the input string
+ */
+static char* read_string_borrowed(json_parser_t *parser, char *in, const char **out_string, size_t *out_size, char quote_style)
+{
+    // Skip '"' or '\''
+    char *start = ++in;
+    in = json_find_quote_or_backslash(parser, in, quote_style);
+    if (in < parser->end && *in == quote_style)
+    {
+        *out_string = start;
+        *out_size = (size_t) (in - start);
+        return in + 1;
+    }
+
+    size_t size = 0;
+    char *run = start;
+    for (;;)
+    {
+        // room for the run and one decoded escape
+        size_t run_size = (size_t) (in - run);
+        if (!json_parser_grow_scratch(parser, size + run_size + 4))
+        {
+            in = json_parser_fail(parser, in, "out of memory");
+            break;
+        }
+        memcpy(parser->scratch + size, run, run_size);
+        size += run_size;
+
+        if (in >= parser->end)
+        {
+            json_parser_fail(parser, in, "unterminated string");
+            break;
+        }
+
+        if (*in == quote_style)
+        {
+            in++;
+            break;
+        }
+
+        char *out = parser->scratch + size;
+        in = read_escape(parser, in, &out);
+        if (parser->error.message != NULL) break;
+        size = (size_t) (out - parser->scratch);
+
+        run = in;
+        in = json_find_quote_or_backslash(parser, in, quote_style);
+    }
+
+    *out_string = parser->scratch;
+    *out_size = size;
+
+    return in;
+}
+
+/**
+ * \brief Helper function to record a parse error. Only the first error is kept, the returned
+ * position is the end of the input so every loop of the parser runs out right away.
+ *
+ * \param[in] parser parser state
+ * \param[in] json position the error was found at
+ * \param[in] message static description of the error
+ *
+ * \return end of the input
+ */
+static char* json_parser_fail(json_parser_t *parser, const char *json, const char *message)
+{
+    if (parser->error.message == NULL)
+    {
+        parser->error.message = message;
+        parser->error.offset = (size_t) (json - parser->input);
+    }
+
+    return (char *) parser->end;
+}
+
+/**
+ * \brief Helper function to look at the character at json without reading past the input
+ *
+ * \param[in] parser parser state holding the bounds of the input
+ * \param[in] json position to look at
+ *
+ * \return character at json, '\0' at the end of the input
+ */
+static char json_peek(json_parser_t *parser, const char *json)
+{
+    return json < parser->end ? *json : '\0';
+}
+
+/**
+ * \brief Helper function to check for a literal (true, false, null) without reading past the input
+ *
+ * \param[in] parser parser state holding the bounds of the input
+ * \param[in] json position the literal should start at
+ * \param[in] literal literal to look for
+ * \param[in] size length of literal
+ *
+ * \return true if the input continues with literal, false otherwise
+ */
+static bool json_match_literal(json_parser_t *parser, const char *json, const char *literal, size_t size)
+{
+    return (size_t) (parser->end - json) >= size && memcmp(json, literal, size) == 0;
+}
+
+/**
+ * \brief Function to read a json string
+ *
+ * \param[in] parser parser state holding the handler
+ * \param[in] json input string
+ * \param[in] quote_style quote type the string to be parsed will be enclosed by
+ *
+ * \return remaining input string after parsing first json string found
+ */
+static char* read_json_string(json_parser_t *parser, char *json, char quote_style)
+{
+    const char *string;
+    size_t size;
+    json = read_string(parser, json, &string, &size, quote_style);
+    if (parser->error.message != NULL) return json;
+
+    if (parser->handler->on_string != NULL && !parser->handler->on_string(parser->user, string, size))
+    {
+        return json_parser_fail(parser, json, "stopped by handler");
+    }
+
+    return json; // return json to continue parsing
+}
+
+/**
+ * \brief 128 bit truncations of 5^q for q in [JSON_SMALLEST_POWER_OF_TEN, JSON_LARGEST_POWER_OF_FIVE],
+ * normalized so the most significant bit is set. Stored as (high, low) pairs. Values for q < 0 are
+ * 2^b / 5^-q rounded up before truncating, the same table fast_float uses.
+ */
+static const uint64_t json_power_of_five_128[] = {
+    0xeef453d6923bd65aULL, 0x113faa2906a13b3fULL,
+    0x9558b4661b6565f8ULL, 0x4ac7ca59a424c507ULL,
+    0xbaaee17fa23ebf76ULL, 0x5d79bcf00d2df649ULL,
+    0xe95a99df8ace6f53ULL, 0xf4d82c2c107973dcULL,
+    0x91d8a02bb6c10594ULL, 0x79071b9b8a4be869ULL,
+    0xb64ec836a47146f9ULL, 0x9748e2826cdee284ULL,
+    0xe3e27a444d8d98b7ULL, 0xfd1b1b2308169b25ULL,
+    0x8e6d8c6ab0787f72ULL, 0xfe30f0f5e50e20f7ULL,
+    0xb208ef855c969f4fULL, 0xbdbd2d335e51a935ULL,
+    0xde8b2b66b3bc4723ULL, 0xad2c788035e61382ULL,
+    0x8b16fb203055ac76ULL, 0x4c3bcb5021afcc31ULL,
+    0xaddcb9e83c6b1793ULL, 0xdf4abe242a1bbf3dULL,
+    0xd953e8624b85dd78ULL, 0xd71d6dad34a2af0dULL,
+    0x87d4713d6f33aa6bULL, 0x8672648c40e5ad68ULL,
+    0xa9c98d8ccb009506ULL, 0x680efdaf511f18c2ULL,
+    0xd43bf0effdc0ba48ULL, 0x0212bd1b2566def2ULL,
+    0x84a57695fe98746dULL, 0x014bb630f7604b57ULL,
+    0xa5ced43b7e3e9188ULL, 0x419ea3bd35385e2dULL,
+    0xcf42894a5dce35eaULL, 0x52064cac828675b9ULL,
+    0x818995ce7aa0e1b2ULL, 0x7343efebd1940993ULL,
+    0xa1ebfb4219491a1fULL, 0x1014ebe6c5f90bf8ULL,
+    0xca66fa129f9b60a6ULL, 0xd41a26e077774ef6ULL,
+    0xfd00b897478238d0ULL, 0x8920b098955522b4ULL,
+    0x9e20735e8cb16382ULL, 0x55b46e5f5d5535b0ULL,
+    0xc5a890362fddbc62ULL, 0xeb2189f734aa831dULL,
+    0xf712b443bbd52b7bULL, 0xa5e9ec7501d523e4ULL,
+    0x9a6bb0aa55653b2dULL, 0x47b233c92125366eULL,
+    0xc1069cd4eabe89f8ULL, 0x999ec0bb696e840aULL,
+    0xf148440a256e2c76ULL, 0xc00670ea43ca250dULL,
+    0x96cd2a865764dbcaULL, 0x380406926a5e5728ULL,
+    0xbc807527ed3e12bcULL, 0xc605083704f5ecf2ULL,
+    0xeba09271e88d976bULL, 0xf7864a44c633682eULL,
+    0x93445b8731587ea3ULL, 0x7ab3ee6afbe0211dULL,
+    0xb8157268fdae9e4cULL, 0x5960ea05bad82964ULL,
+    0xe61acf033d1a45dfULL, 0x6fb92487298e33bdULL,
+    0x8fd0c16206306babULL, 0xa5d3b6d479f8e056ULL,
+    0xb3c4f1ba87bc8696ULL, 0x8f48a4899877186cULL,
+    0xe0b62e2929aba83cULL, 0x331acdabfe94de87ULL,
+    0x8c71dcd9ba0b4925ULL, 0x9ff0c08b7f1d0b14ULL,
+    0xaf8e5410288e1b6fULL, 0x07ecf0ae5ee44dd9ULL,
+    0xdb71e91432b1a24aULL, 0xc9e82cd9f69d6150ULL,
+    0x892731ac9faf056eULL, 0xbe311c083a225cd2ULL,
+    0xab70fe17c79ac6caULL, 0x6dbd630a48aaf406ULL,
+    0xd64d3d9db981787dULL, 0x092cbbccdad5b108ULL,
+    0x85f0468293f0eb4eULL, 0x25bbf56008c58ea5ULL,
+    0xa76c582338ed2621ULL, 0xaf2af2b80af6f24eULL,
+    0xd1476e2c07286faaULL, 0x1af5af660db4aee1ULL,
+    0x82cca4db847945caULL, 0x50d98d9fc890ed4dULL,
+    0xa37fce126597973cULL, 0xe50ff107bab528a0ULL,
+    0xcc5fc196fefd7d0cULL, 0x1e53ed49a96272c8ULL,
+    0xff77b1fcbebcdc4fULL, 0x25e8e89c13bb0f7aULL,
+    0x9faacf3df73609b1ULL, 0x77b191618c54e9acULL,
+    0xc795830d75038c1dULL, 0xd59df5b9ef6a2417ULL,
+    0xf97ae3d0d2446f25ULL, 0x4b0573286b44ad1dULL,
+    0x9becce62836ac577ULL, 0x4ee367f9430aec32ULL,
+    0xc2e801fb244576d5ULL, 0x229c41f793cda73fULL,
+    0xf3a20279ed56d48aULL, 0x6b43527578c1110fULL,
+    0x9845418c345644d6ULL, 0x830a13896b78aaa9ULL,
+    0xbe5691ef416bd60cULL, 0x23cc986bc656d553ULL,
+    0xedec366b11c6cb8fULL, 0x2cbfbe86b7ec8aa8ULL,
+    0x94b3a202eb1c3f39ULL, 0x7bf7d71432f3d6a9ULL,
+    0xb9e08a83a5e34f07ULL, 0xdaf5ccd93fb0cc53ULL,
+    0xe858ad248f5c22c9ULL, 0xd1b3400f8f9cff68ULL,
+    0x91376c36d99995beULL, 0x23100809b9c21fa1ULL,
+    0xb58547448ffffb2dULL, 0xabd40a0c2832a78aULL,
+    0xe2e69915b3fff9f9ULL, 0x16c90c8f323f516cULL,
+    0x8dd01fad907ffc3bULL, 0xae3da7d97f6792e3ULL,
+    0xb1442798f49ffb4aULL, 0x99cd11cfdf41779cULL,
+    0xdd95317f31c7fa1dULL, 0x40405643d711d583ULL,
+    0x8a7d3eef7f1cfc52ULL, 0x482835ea666b2572ULL,
+    0xad1c8eab5ee43b66ULL, 0xda3243650005eecfULL,
+    0xd863b256369d4a40ULL, 0x90bed43e40076a82ULL,
+    0x873e4f75e2224e68ULL, 0x5a7744a6e804a291ULL,
+    0xa90de3535aaae202ULL, 0x711515d0a205cb36ULL,
+    0xd3515c2831559a83ULL, 0x0d5a5b44ca873e03ULL,
+    0x8412d9991ed58091ULL, 0xe858790afe9486c2ULL,
+    0xa5178fff668ae0b6ULL, 0x626e974dbe39a872ULL,
+    0xce5d73ff402d98e3ULL, 0xfb0a3d212dc8128fULL,
+    0x80fa687f881c7f8eULL, 0x7ce66634bc9d0b99ULL,
+    0xa139029f6a239f72ULL, 0x1c1fffc1ebc44e80ULL,
+    0xc987434744ac874eULL, 0xa327ffb266b56220ULL,
+    0xfbe9141915d7a922ULL, 0x4bf1ff9f0062baa8ULL,
+    0x9d71ac8fada6c9b5ULL, 0x6f773fc3603db4a9ULL,
+    0xc4ce17b399107c22ULL, 0xcb550fb4384d21d3ULL,
+    0xf6019da07f549b2bULL, 0x7e2a53a146606a48ULL,
+    0x99c102844f94e0fbULL, 0x2eda7444cbfc426dULL,
+    0xc0314325637a1939ULL, 0xfa911155fefb5308ULL,
+    0xf03d93eebc589f88ULL, 0x793555ab7eba27caULL,
+    0x96267c7535b763b5ULL, 0x4bc1558b2f3458deULL,
+    0xbbb01b9283253ca2ULL, 0x9eb1aaedfb016f16ULL,
+    0xea9c227723ee8bcbULL, 0x465e15a979c1cadcULL,
+    0x92a1958a7675175fULL, 0x0bfacd89ec191ec9ULL,
+    0xb749faed14125d36ULL, 0xcef980ec671f667bULL,
+    0xe51c79a85916f484ULL, 0x82b7e12780e7401aULL,
+    0x8f31cc0937ae58d2ULL, 0xd1b2ecb8b0908810ULL,
+    0xb2fe3f0b8599ef07ULL, 0x861fa7e6dcb4aa15ULL,
+    0xdfbdcece67006ac9ULL, 0x67a791e093e1d49aULL,
+    0x8bd6a141006042bdULL, 0xe0c8bb2c5c6d24e0ULL,
+    0xaecc49914078536dULL, 0x58fae9f773886e18ULL,
+    0xda7f5bf590966848ULL, 0xaf39a475506a899eULL,
+    0x888f99797a5e012dULL, 0x6d8406c952429603ULL,
+    0xaab37fd7d8f58178ULL, 0xc8e5087ba6d33b83ULL,
+    0xd5605fcdcf32e1d6ULL, 0xfb1e4a9a90880a64ULL,
+    0x855c3be0a17fcd26ULL, 0x5cf2eea09a55067fULL,
+    0xa6b34ad8c9dfc06fULL, 0xf42faa48c0ea481eULL,
+    0xd0601d8efc57b08bULL, 0xf13b94daf124da26ULL,
+    0x823c12795db6ce57ULL, 0x76c53d08d6b70858ULL,
+    0xa2cb1717b52481edULL, 0x54768c4b0c64ca6eULL,
+    0xcb7ddcdda26da268ULL, 0xa9942f5dcf7dfd09ULL,
+    0xfe5d54150b090b02ULL, 0xd3f93b35435d7c4cULL,
+    0x9efa548d26e5a6e1ULL, 0xc47bc5014a1a6dafULL,
+    0xc6b8e9b0709f109aULL, 0x359ab6419ca1091bULL,
+    0xf867241c8cc6d4c0ULL, 0xc30163d203c94b62ULL,
+    0x9b407691d7fc44f8ULL, 0x79e0de63425dcf1dULL,
+    0xc21094364dfb5636ULL, 0x985915fc12f542e4ULL,
+    0xf294b943e17a2bc4ULL, 0x3e6f5b7b17b2939dULL,
+    0x979cf3ca6cec5b5aULL, 0xa705992ceecf9c42ULL,
+    0xbd8430bd08277231ULL, 0x50c6ff782a838353ULL,
+    0xece53cec4a314ebdULL, 0xa4f8bf5635246428ULL,
+    0x940f4613ae5ed136ULL, 0x871b7795e136be99ULL,
+    0xb913179899f68584ULL, 0x28e2557b59846e3fULL,
+    0xe757dd7ec07426e5ULL, 0x331aeada2fe589cfULL,
+    0x9096ea6f3848984fULL, 0x3ff0d2c85def7621ULL,
+    0xb4bca50b065abe63ULL, 0x0fed077a756b53a9ULL,
+    0xe1ebce4dc7f16dfbULL, 0xd3e8495912c62894ULL,
+    0x8d3360f09cf6e4bdULL, 0x64712dd7abbbd95cULL,
+    0xb080392cc4349decULL, 0xbd8d794d96aacfb3ULL,
+    0xdca04777f541c567ULL, 0xecf0d7a0fc5583a0ULL,
+    0x89e42caaf9491b60ULL, 0xf41686c49db57244ULL,
+    0xac5d37d5b79b6239ULL, 0x311c2875c522ced5ULL,
+    0xd77485cb25823ac7ULL, 0x7d633293366b828bULL,
+    0x86a8d39ef77164bcULL, 0xae5dff9c02033197ULL,
+    0xa8530886b54dbdebULL, 0xd9f57f830283fdfcULL,
+    0xd267caa862a12d66ULL, 0xd072df63c324fd7bULL,
+    0x8380dea93da4bc60ULL, 0x4247cb9e59f71e6dULL,
+    0xa46116538d0deb78ULL, 0x52d9be85f074e608ULL,
+    0xcd795be870516656ULL, 0x67902e276c921f8bULL,
+    0x806bd9714632dff6ULL, 0x00ba1cd8a3db53b6ULL,
+    0xa086cfcd97bf97f3ULL, 0x80e8a40eccd228a4ULL,
+    0xc8a883c0fdaf7df0ULL, 0x6122cd128006b2cdULL,
+    0xfad2a4b13d1b5d6cULL, 0x796b805720085f81ULL,
+    0x9cc3a6eec6311a63ULL, 0xcbe3303674053bb0ULL,
+    0xc3f490aa77bd60fcULL, 0xbedbfc4411068a9cULL,
+    0xf4f1b4d515acb93bULL, 0xee92fb5515482d44ULL,
+    0x991711052d8bf3c5ULL, 0x751bdd152d4d1c4aULL,
+    0xbf5cd54678eef0b6ULL, 0xd262d45a78a0635dULL,
+    0xef340a98172aace4ULL, 0x86fb897116c87c34ULL,
+    0x9580869f0e7aac0eULL, 0xd45d35e6ae3d4da0ULL,
+    0xbae0a846d2195712ULL, 0x8974836059cca109ULL,
+    0xe998d258869facd7ULL, 0x2bd1a438703fc94bULL,
+    0x91ff83775423cc06ULL, 0x7b6306a34627ddcfULL,
+    0xb67f6455292cbf08ULL, 0x1a3bc84c17b1d542ULL,
+    0xe41f3d6a7377eecaULL, 0x20caba5f1d9e4a93ULL,
+    0x8e938662882af53eULL, 0x547eb47b7282ee9cULL,
+    0xb23867fb2a35b28dULL, 0xe99e619a4f23aa43ULL,
+    0xdec681f9f4c31f31ULL, 0x6405fa00e2ec94d4ULL,
+    0x8b3c113c38f9f37eULL, 0xde83bc408dd3dd04ULL,
+    0xae0b158b4738705eULL, 0x9624ab50b148d445ULL,
+    0xd98ddaee19068c76ULL, 0x3badd624dd9b0957ULL,
+    0x87f8a8d4cfa417c9ULL, 0xe54ca5d70a80e5d6ULL,
+    0xa9f6d30a038d1dbcULL, 0x5e9fcf4ccd211f4cULL,
+    0xd47487cc8470652bULL, 0x7647c3200069671fULL,
+    0x84c8d4dfd2c63f3bULL, 0x29ecd9f40041e073ULL,
+    0xa5fb0a17c777cf09ULL, 0xf468107100525890ULL,
+    0xcf79cc9db955c2ccULL, 0x7182148d4066eeb4ULL,
+    0x81ac1fe293d599bfULL, 0xc6f14cd848405530ULL,
+    0xa21727db38cb002fULL, 0xb8ada00e5a506a7cULL,
+    0xca9cf1d206fdc03bULL, 0xa6d90811f0e4851cULL,
+    0xfd442e4688bd304aULL, 0x908f4a166d1da663ULL,
+    0x9e4a9cec15763e2eULL, 0x9a598e4e043287feULL,
+    0xc5dd44271ad3cdbaULL, 0x40eff1e1853f29fdULL,
+    0xf7549530e188c128ULL, 0xd12bee59e68ef47cULL,
+    0x9a94dd3e8cf578b9ULL, 0x82bb74f8301958ceULL,
+    0xc13a148e3032d6e7ULL, 0xe36a52363c1faf01ULL,
+    0xf18899b1bc3f8ca1ULL, 0xdc44e6c3cb279ac1ULL,
+    0x96f5600f15a7b7e5ULL, 0x29ab103a5ef8c0b9ULL,
+    0xbcb2b812db11a5deULL, 0x7415d448f6b6f0e7ULL,
+    0xebdf661791d60f56ULL, 0x111b495b3464ad21ULL,
+    0x936b9fcebb25c995ULL, 0xcab10dd900beec34ULL,
+    0xb84687c269ef3bfbULL, 0x3d5d514f40eea742ULL,
+    0xe65829b3046b0afaULL, 0x0cb4a5a3112a5112ULL,
+    0x8ff71a0fe2c2e6dcULL, 0x47f0e785eaba72abULL,
+    0xb3f4e093db73a093ULL, 0x59ed216765690f56ULL,
+    0xe0f218b8d25088b8ULL, 0x306869c13ec3532cULL,
+    0x8c974f7383725573ULL, 0x1e414218c73a13fbULL,
+    0xafbd2350644eeacfULL, 0xe5d1929ef90898faULL,
+    0xdbac6c247d62a583ULL, 0xdf45f746b74abf39ULL,
+    0x894bc396ce5da772ULL, 0x6b8bba8c328eb783ULL,
+    0xab9eb47c81f5114fULL, 0x066ea92f3f326564ULL,
+    0xd686619ba27255a2ULL, 0xc80a537b0efefebdULL,
+    0x8613fd0145877585ULL, 0xbd06742ce95f5f36ULL,
+    0xa798fc4196e952e7ULL, 0x2c48113823b73704ULL,
+    0xd17f3b51fca3a7a0ULL, 0xf75a15862ca504c5ULL,
+    0x82ef85133de648c4ULL, 0x9a984d73dbe722fbULL,
+    0xa3ab66580d5fdaf5ULL, 0xc13e60d0d2e0ebbaULL,
+    0xcc963fee10b7d1b3ULL, 0x318df905079926a8ULL,
+    0xffbbcfe994e5c61fULL, 0xfdf17746497f7052ULL,
+    0x9fd561f1fd0f9bd3ULL, 0xfeb6ea8bedefa633ULL,
+    0xc7caba6e7c5382c8ULL, 0xfe64a52ee96b8fc0ULL,
+    0xf9bd690a1b68637bULL, 0x3dfdce7aa3c673b0ULL,
+    0x9c1661a651213e2dULL, 0x06bea10ca65c084eULL,
+    0xc31bfa0fe5698db8ULL, 0x486e494fcff30a62ULL,
+    0xf3e2f893dec3f126ULL, 0x5a89dba3c3efccfaULL,
+    0x986ddb5c6b3a76b7ULL, 0xf89629465a75e01cULL,
+    0xbe89523386091465ULL, 0xf6bbb397f1135823ULL,
+    0xee2ba6c0678b597fULL, 0x746aa07ded582e2cULL,
+    0x94db483840b717efULL, 0xa8c2a44eb4571cdcULL,
+    0xba121a4650e4ddebULL, 0x92f34d62616ce413ULL,
+    0xe896a0d7e51e1566ULL, 0x77b020baf9c81d17ULL,
+    0x915e2486ef32cd60ULL, 0x0ace1474dc1d122eULL,
+    0xb5b5ada8aaff80b8ULL, 0x0d819992132456baULL,
+    0xe3231912d5bf60e6ULL, 0x10e1fff697ed6c69ULL,
+    0x8df5efabc5979c8fULL, 0xca8d3ffa1ef463c1ULL,
+    0xb1736b96b6fd83b3ULL, 0xbd308ff8a6b17cb2ULL,
+    0xddd0467c64bce4a0ULL, 0xac7cb3f6d05ddbdeULL,
+    0x8aa22c0dbef60ee4ULL, 0x6bcdf07a423aa96bULL,
+    0xad4ab7112eb3929dULL, 0x86c16c98d2c953c6ULL,
+    0xd89d64d57a607744ULL, 0xe871c7bf077ba8b7ULL,
+    0x87625f056c7c4a8bULL, 0x11471cd764ad4972ULL,
+    0xa93af6c6c79b5d2dULL, 0xd598e40d3dd89bcfULL,
+    0xd389b47879823479ULL, 0x4aff1d108d4ec2c3ULL,
+    0x843610cb4bf160cbULL, 0xcedf722a585139baULL,
+    0xa54394fe1eedb8feULL, 0xc2974eb4ee658828ULL,
+    0xce947a3da6a9273eULL, 0x733d226229feea32ULL,
+    0x811ccc668829b887ULL, 0x0806357d5a3f525fULL,
+    0xa163ff802a3426a8ULL, 0xca07c2dcb0cf26f7ULL,
+    0xc9bcff6034c13052ULL, 0xfc89b393dd02f0b5ULL,
+    0xfc2c3f3841f17c67ULL, 0xbbac2078d443ace2ULL,
+    0x9d9ba7832936edc0ULL, 0xd54b944b84aa4c0dULL,
+    0xc5029163f384a931ULL, 0x0a9e795e65d4df11ULL,
+    0xf64335bcf065d37dULL, 0x4d4617b5ff4a16d5ULL,
+    0x99ea0196163fa42eULL, 0x504bced1bf8e4e45ULL,
+    0xc06481fb9bcf8d39ULL, 0xe45ec2862f71e1d6ULL,
+    0xf07da27a82c37088ULL, 0x5d767327bb4e5a4cULL,
+    0x964e858c91ba2655ULL, 0x3a6a07f8d510f86fULL,
+    0xbbe226efb628afeaULL, 0x890489f70a55368bULL,
+    0xeadab0aba3b2dbe5ULL, 0x2b45ac74ccea842eULL,
+    0x92c8ae6b464fc96fULL, 0x3b0b8bc90012929dULL,
+    0xb77ada0617e3bbcbULL, 0x09ce6ebb40173744ULL,
+    0xe55990879ddcaabdULL, 0xcc420a6a101d0515ULL,
+    0x8f57fa54c2a9eab6ULL, 0x9fa946824a12232dULL,
+    0xb32df8e9f3546564ULL, 0x47939822dc96abf9ULL,
+    0xdff9772470297ebdULL, 0x59787e2b93bc56f7ULL,
+    0x8bfbea76c619ef36ULL, 0x57eb4edb3c55b65aULL,
+    0xaefae51477a06b03ULL, 0xede622920b6b23f1ULL,
+    0xdab99e59958885c4ULL, 0xe95fab368e45ecedULL,
+    0x88b402f7fd75539bULL, 0x11dbcb0218ebb414ULL,
+    0xaae103b5fcd2a881ULL, 0xd652bdc29f26a119ULL,
+    0xd59944a37c0752a2ULL, 0x4be76d3346f0495fULL,
+    0x857fcae62d8493a5ULL, 0x6f70a4400c562ddbULL,
+    0xa6dfbd9fb8e5b88eULL, 0xcb4ccd500f6bb952ULL,
+    0xd097ad07a71f26b2ULL, 0x7e2000a41346a7a7ULL,
+    0x825ecc24c873782fULL, 0x8ed400668c0c28c8ULL,
+    0xa2f67f2dfa90563bULL, 0x728900802f0f32faULL,
+    0xcbb41ef979346bcaULL, 0x4f2b40a03ad2ffb9ULL,
+    0xfea126b7d78186bcULL, 0xe2f610c84987bfa8ULL,
+    0x9f24b832e6b0f436ULL, 0x0dd9ca7d2df4d7c9ULL,
+    0xc6ede63fa05d3143ULL, 0x91503d1c79720dbbULL,
+    0xf8a95fcf88747d94ULL, 0x75a44c6397ce912aULL,
+    0x9b69dbe1b548ce7cULL, 0xc986afbe3ee11abaULL,
+    0xc24452da229b021bULL, 0xfbe85badce996168ULL,
+    0xf2d56790ab41c2a2ULL, 0xfae27299423fb9c3ULL,
+    0x97c560ba6b0919a5ULL, 0xdccd879fc967d41aULL,
+    0xbdb6b8e905cb600fULL, 0x5400e987bbc1c920ULL,
+    0xed246723473e3813ULL, 0x290123e9aab23b68ULL,
+    0x9436c0760c86e30bULL, 0xf9a0b6720aaf6521ULL,
+    0xb94470938fa89bceULL, 0xf808e40e8d5b3e69ULL,
+    0xe7958cb87392c2c2ULL, 0xb60b1d1230b20e04ULL,
+    0x90bd77f3483bb9b9ULL, 0xb1c6f22b5e6f48c2ULL,
+    0xb4ecd5f01a4aa828ULL, 0x1e38aeb6360b1af3ULL,
+    0xe2280b6c20dd5232ULL, 0x25c6da63c38de1b0ULL,
+    0x8d590723948a535fULL, 0x579c487e5a38ad0eULL,
+    0xb0af48ec79ace837ULL, 0x2d835a9df0c6d851ULL,
+    0xdcdb1b2798182244ULL, 0xf8e431456cf88e65ULL,
+    0x8a08f0f8bf0f156bULL, 0x1b8e9ecb641b58ffULL,
+    0xac8b2d36eed2dac5ULL, 0xe272467e3d222f3fULL,
+    0xd7adf884aa879177ULL, 0x5b0ed81dcc6abb0fULL,
+    0x86ccbb52ea94baeaULL, 0x98e947129fc2b4e9ULL,
+    0xa87fea27a539e9a5ULL, 0x3f2398d747b36224ULL,
+    0xd29fe4b18e88640eULL, 0x8eec7f0d19a03aadULL,
+    0x83a3eeeef9153e89ULL, 0x1953cf68300424acULL,
+    0xa48ceaaab75a8e2bULL, 0x5fa8c3423c052dd7ULL,
+    0xcdb02555653131b6ULL, 0x3792f412cb06794dULL,
+    0x808e17555f3ebf11ULL, 0xe2bbd88bbee40bd0ULL,
+    0xa0b19d2ab70e6ed6ULL, 0x5b6aceaeae9d0ec4ULL,
+    0xc8de047564d20a8bULL, 0xf245825a5a445275ULL,
+    0xfb158592be068d2eULL, 0xeed6e2f0f0d56712ULL,
+    0x9ced737bb6c4183dULL, 0x55464dd69685606bULL,
+    0xc428d05aa4751e4cULL, 0xaa97e14c3c26b886ULL,
+    0xf53304714d9265dfULL, 0xd53dd99f4b3066a8ULL,
+    0x993fe2c6d07b7fabULL, 0xe546a8038efe4029ULL,
+    0xbf8fdb78849a5f96ULL, 0xde98520472bdd033ULL,
+    0xef73d256a5c0f77cULL, 0x963e66858f6d4440ULL,
+    0x95a8637627989aadULL, 0xdde7001379a44aa8ULL,
+    0xbb127c53b17ec159ULL, 0x5560c018580d5d52ULL,
+    0xe9d71b689dde71afULL, 0xaab8f01e6e10b4a6ULL,
+    0x9226712162ab070dULL, 0xcab3961304ca70e8ULL,
+    0xb6b00d69bb55c8d1ULL, 0x3d607b97c5fd0d22ULL,
+    0xe45c10c42a2b3b05ULL, 0x8cb89a7db77c506aULL,
+    0x8eb98a7a9a5b04e3ULL, 0x77f3608e92adb242ULL,
+    0xb267ed1940f1c61cULL, 0x55f038b237591ed3ULL,
+    0xdf01e85f912e37a3ULL, 0x6b6c46dec52f6688ULL,
+    0x8b61313bbabce2c6ULL, 0x2323ac4b3b3da015ULL,
+    0xae397d8aa96c1b77ULL, 0xabec975e0a0d081aULL,
+    0xd9c7dced53c72255ULL, 0x96e7bd358c904a21ULL,
+    0x881cea14545c7575ULL, 0x7e50d64177da2e54ULL,
+    0xaa242499697392d2ULL, 0xdde50bd1d5d0b9e9ULL,
+    0xd4ad2dbfc3d07787ULL, 0x955e4ec64b44e864ULL,
+    0x84ec3c97da624ab4ULL, 0xbd5af13bef0b113eULL,
+    0xa6274bbdd0fadd61ULL, 0xecb1ad8aeacdd58eULL,
+    0xcfb11ead453994baULL, 0x67de18eda5814af2ULL,
+    0x81ceb32c4b43fcf4ULL, 0x80eacf948770ced7ULL,
+    0xa2425ff75e14fc31ULL, 0xa1258379a94d028dULL,
+    0xcad2f7f5359a3b3eULL, 0x096ee45813a04330ULL,
+    0xfd87b5f28300ca0dULL, 0x8bca9d6e188853fcULL,
+    0x9e74d1b791e07e48ULL, 0x775ea264cf55347eULL,
+    0xc612062576589ddaULL, 0x95364afe032a819eULL,
+    0xf79687aed3eec551ULL, 0x3a83ddbd83f52205ULL,
+    0x9abe14cd44753b52ULL, 0xc4926a9672793543ULL,
+    0xc16d9a0095928a27ULL, 0x75b7053c0f178294ULL,
+    0xf1c90080baf72cb1ULL, 0x5324c68b12dd6339ULL,
+    0x971da05074da7beeULL, 0xd3f6fc16ebca5e04ULL,
+    0xbce5086492111aeaULL, 0x88f4bb1ca6bcf585ULL,
+    0xec1e4a7db69561a5ULL, 0x2b31e9e3d06c32e6ULL,
+    0x9392ee8e921d5d07ULL, 0x3aff322e62439fd0ULL,
+    0xb877aa3236a4b449ULL, 0x09befeb9fad487c3ULL,
+    0xe69594bec44de15bULL, 0x4c2ebe687989a9b4ULL,
+    0x901d7cf73ab0acd9ULL, 0x0f9d37014bf60a11ULL,
+    0xb424dc35095cd80fULL, 0x538484c19ef38c95ULL,
+    0xe12e13424bb40e13ULL, 0x2865a5f206b06fbaULL,
+    0x8cbccc096f5088cbULL, 0xf93f87b7442e45d4ULL,
+    0xafebff0bcb24aafeULL, 0xf78f69a51539d749ULL,
+    0xdbe6fecebdedd5beULL, 0xb573440e5a884d1cULL,
+    0x89705f4136b4a597ULL, 0x31680a88f8953031ULL,
+    0xabcc77118461cefcULL, 0xfdc20d2b36ba7c3eULL,
+    0xd6bf94d5e57a42bcULL, 0x3d32907604691b4dULL,
+    0x8637bd05af6c69b5ULL, 0xa63f9a49c2c1b110ULL,
+    0xa7c5ac471b478423ULL, 0x0fcf80dc33721d54ULL,
+    0xd1b71758e219652bULL, 0xd3c36113404ea4a9ULL,
+    0x83126e978d4fdf3bULL, 0x645a1cac083126eaULL,
+    0xa3d70a3d70a3d70aULL, 0x3d70a3d70a3d70a4ULL,
+    0xccccccccccccccccULL, 0xcccccccccccccccdULL,
+    0x8000000000000000ULL, 0x0000000000000000ULL,
+    0xa000000000000000ULL, 0x0000000000000000ULL,
+    0xc800000000000000ULL, 0x0000000000000000ULL,
+    0xfa00000000000000ULL, 0x0000000000000000ULL,
+    0x9c40000000000000ULL, 0x0000000000000000ULL,
+    0xc350000000000000ULL, 0x0000000000000000ULL,
+    0xf424000000000000ULL, 0x0000000000000000ULL,
+    0x9896800000000000ULL, 0x0000000000000000ULL,
+    0xbebc200000000000ULL, 0x0000000000000000ULL,
+    0xee6b280000000000ULL, 0x0000000000000000ULL,
+    0x9502f90000000000ULL, 0x0000000000000000ULL,
+    0xba43b74000000000ULL, 0x0000000000000000ULL,
+    0xe8d4a51000000000ULL, 0x0000000000000000ULL,
+    0x9184e72a00000000ULL, 0x0000000000000000ULL,
+    0xb5e620f480000000ULL, 0x0000000000000000ULL,
+    0xe35fa931a0000000ULL, 0x0000000000000000ULL,
+    0x8e1bc9bf04000000ULL, 0x0000000000000000ULL,
+    0xb1a2bc2ec5000000ULL, 0x0000000000000000ULL,
+    0xde0b6b3a76400000ULL, 0x0000000000000000ULL,
+    0x8ac7230489e80000ULL, 0x0000000000000000ULL,
+    0xad78ebc5ac620000ULL, 0x0000000000000000ULL,
+    0xd8d726b7177a8000ULL, 0x0000000000000000ULL,
+    0x878678326eac9000ULL, 0x0000000000000000ULL,
+    0xa968163f0a57b400ULL, 0x0000000000000000ULL,
+    0xd3c21bcecceda100ULL, 0x0000000000000000ULL,
+    0x84595161401484a0ULL, 0x0000000000000000ULL,
+    0xa56fa5b99019a5c8ULL, 0x0000000000000000ULL,
+    0xcecb8f27f4200f3aULL, 0x0000000000000000ULL,
+    0x813f3978f8940984ULL, 0x4000000000000000ULL,
+    0xa18f07d736b90be5ULL, 0x5000000000000000ULL,
+    0xc9f2c9cd04674edeULL, 0xa400000000000000ULL,
+    0xfc6f7c4045812296ULL, 0x4d00000000000000ULL,
+    0x9dc5ada82b70b59dULL, 0xf020000000000000ULL,
+    0xc5371912364ce305ULL, 0x6c28000000000000ULL,
+    0xf684df56c3e01bc6ULL, 0xc732000000000000ULL,
+    0x9a130b963a6c115cULL, 0x3c7f400000000000ULL,
+    0xc097ce7bc90715b3ULL, 0x4b9f100000000000ULL,
+    0xf0bdc21abb48db20ULL, 0x1e86d40000000000ULL,
+    0x96769950b50d88f4ULL, 0x1314448000000000ULL,
+    0xbc143fa4e250eb31ULL, 0x17d955a000000000ULL,
+    0xeb194f8e1ae525fdULL, 0x5dcfab0800000000ULL,
+    0x92efd1b8d0cf37beULL, 0x5aa1cae500000000ULL,
+    0xb7abc627050305adULL, 0xf14a3d9e40000000ULL,
+    0xe596b7b0c643c719ULL, 0x6d9ccd05d0000000ULL,
+    0x8f7e32ce7bea5c6fULL, 0xe4820023a2000000ULL,
+    0xb35dbf821ae4f38bULL, 0xdda2802c8a800000ULL,
+    0xe0352f62a19e306eULL, 0xd50b2037ad200000ULL,
+    0x8c213d9da502de45ULL, 0x4526f422cc340000ULL,
+    0xaf298d050e4395d6ULL, 0x9670b12b7f410000ULL,
+    0xdaf3f04651d47b4cULL, 0x3c0cdd765f114000ULL,
+    0x88d8762bf324cd0fULL, 0xa5880a69fb6ac800ULL,
+    0xab0e93b6efee0053ULL, 0x8eea0d047a457a00ULL,
+    0xd5d238a4abe98068ULL, 0x72a4904598d6d880ULL,
+    0x85a36366eb71f041ULL, 0x47a6da2b7f864750ULL,
+    0xa70c3c40a64e6c51ULL, 0x999090b65f67d924ULL,
+    0xd0cf4b50cfe20765ULL, 0xfff4b4e3f741cf6dULL,
+    0x82818f1281ed449fULL, 0xbff8f10e7a8921a4ULL,
+    0xa321f2d7226895c7ULL, 0xaff72d52192b6a0dULL,
+    0xcbea6f8ceb02bb39ULL, 0x9bf4f8a69f764490ULL,
+    0xfee50b7025c36a08ULL, 0x02f236d04753d5b4ULL,
+    0x9f4f2726179a2245ULL, 0x01d762422c946590ULL,
+    0xc722f0ef9d80aad6ULL, 0x424d3ad2b7b97ef5ULL,
+    0xf8ebad2b84e0d58bULL, 0xd2e0898765a7deb2ULL,
+    0x9b934c3b330c8577ULL, 0x63cc55f49f88eb2fULL,
+    0xc2781f49ffcfa6d5ULL, 0x3cbf6b71c76b25fbULL,
+    0xf316271c7fc3908aULL, 0x8bef464e3945ef7aULL,
+    0x97edd871cfda3a56ULL, 0x97758bf0e3cbb5acULL,
+    0xbde94e8e43d0c8ecULL, 0x3d52eeed1cbea317ULL,
+    0xed63a231d4c4fb27ULL, 0x4ca7aaa863ee4bddULL,
+    0x945e455f24fb1cf8ULL, 0x8fe8caa93e74ef6aULL,
+    0xb975d6b6ee39e436ULL, 0xb3e2fd538e122b44ULL,
+    0xe7d34c64a9c85d44ULL, 0x60dbbca87196b616ULL,
+    0x90e40fbeea1d3a4aULL, 0xbc8955e946fe31cdULL,
+    0xb51d13aea4a488ddULL, 0x6babab6398bdbe41ULL,
+    0xe264589a4dcdab14ULL, 0xc696963c7eed2dd1ULL,
+    0x8d7eb76070a08aecULL, 0xfc1e1de5cf543ca2ULL,
+    0xb0de65388cc8ada8ULL, 0x3b25a55f43294bcbULL,
+    0xdd15fe86affad912ULL, 0x49ef0eb713f39ebeULL,
+    0x8a2dbf142dfcc7abULL, 0x6e3569326c784337ULL,
+    0xacb92ed9397bf996ULL, 0x49c2c37f07965404ULL,
+    0xd7e77a8f87daf7fbULL, 0xdc33745ec97be906ULL,
+    0x86f0ac99b4e8dafdULL, 0x69a028bb3ded71a3ULL,
+    0xa8acd7c0222311bcULL, 0xc40832ea0d68ce0cULL,
+    0xd2d80db02aabd62bULL, 0xf50a3fa490c30190ULL,
+    0x83c7088e1aab65dbULL, 0x792667c6da79e0faULL,
+    0xa4b8cab1a1563f52ULL, 0x577001b891185938ULL,
+    0xcde6fd5e09abcf26ULL, 0xed4c0226b55e6f86ULL,
+    0x80b05e5ac60b6178ULL, 0x544f8158315b05b4ULL,
+    0xa0dc75f1778e39d6ULL, 0x696361ae3db1c721ULL,
+    0xc913936dd571c84cULL, 0x03bc3a19cd1e38e9ULL,
+    0xfb5878494ace3a5fULL, 0x04ab48a04065c723ULL,
+    0x9d174b2dcec0e47bULL, 0x62eb0d64283f9c76ULL,
+    0xc45d1df942711d9aULL, 0x3ba5d0bd324f8394ULL,
+    0xf5746577930d6500ULL, 0xca8f44ec7ee36479ULL,
+    0x9968bf6abbe85f20ULL, 0x7e998b13cf4e1ecbULL,
+    0xbfc2ef456ae276e8ULL, 0x9e3fedd8c321a67eULL,
+    0xefb3ab16c59b14a2ULL, 0xc5cfe94ef3ea101eULL,
+    0x95d04aee3b80ece5ULL, 0xbba1f1d158724a12ULL,
+    0xbb445da9ca61281fULL, 0x2a8a6e45ae8edc97ULL,
+    0xea1575143cf97226ULL, 0xf52d09d71a3293bdULL,
+    0x924d692ca61be758ULL, 0x593c2626705f9c56ULL,
+    0xb6e0c377cfa2e12eULL, 0x6f8b2fb00c77836cULL,
+    0xe498f455c38b997aULL, 0x0b6dfb9c0f956447ULL,
+    0x8edf98b59a373fecULL, 0x4724bd4189bd5eacULL,
+    0xb2977ee300c50fe7ULL, 0x58edec91ec2cb657ULL,
+    0xdf3d5e9bc0f653e1ULL, 0x2f2967b66737e3edULL,
+    0x8b865b215899f46cULL, 0xbd79e0d20082ee74ULL,
+    0xae67f1e9aec07187ULL, 0xecd8590680a3aa11ULL,
+    0xda01ee641a708de9ULL, 0xe80e6f4820cc9495ULL,
+    0x884134fe908658b2ULL, 0x3109058d147fdcddULL,
+    0xaa51823e34a7eedeULL, 0xbd4b46f0599fd415ULL,
+    0xd4e5e2cdc1d1ea96ULL, 0x6c9e18ac7007c91aULL,
+    0x850fadc09923329eULL, 0x03e2cf6bc604ddb0ULL,
+    0xa6539930bf6bff45ULL, 0x84db8346b786151cULL,
+    0xcfe87f7cef46ff16ULL, 0xe612641865679a63ULL,
+    0x81f14fae158c5f6eULL, 0x4fcb7e8f3f60c07eULL,
+    0xa26da3999aef7749ULL, 0xe3be5e330f38f09dULL,
+    0xcb090c8001ab551cULL, 0x5cadf5bfd3072cc5ULL,
+    0xfdcb4fa002162a63ULL, 0x73d9732fc7c8f7f6ULL,
+    0x9e9f11c4014dda7eULL, 0x2867e7fddcdd9afaULL,
+    0xc646d63501a1511dULL, 0xb281e1fd541501b8ULL,
+    0xf7d88bc24209a565ULL, 0x1f225a7ca91a4226ULL,
+    0x9ae757596946075fULL, 0x3375788de9b06958ULL,
+    0xc1a12d2fc3978937ULL, 0x0052d6b1641c83aeULL,
+    0xf209787bb47d6b84ULL, 0xc0678c5dbd23a49aULL,
+    0x9745eb4d50ce6332ULL, 0xf840b7ba963646e0ULL,
+    0xbd176620a501fbffULL, 0xb650e5a93bc3d898ULL,
+    0xec5d3fa8ce427affULL, 0xa3e51f138ab4cebeULL,
+    0x93ba47c980e98cdfULL, 0xc66f336c36b10137ULL,
+    0xb8a8d9bbe123f017ULL, 0xb80b0047445d4184ULL,
+    0xe6d3102ad96cec1dULL, 0xa60dc059157491e5ULL,
+    0x9043ea1ac7e41392ULL, 0x87c89837ad68db2fULL,
+    0xb454e4a179dd1877ULL, 0x29babe4598c311fbULL,
+    0xe16a1dc9d8545e94ULL, 0xf4296dd6fef3d67aULL,
+    0x8ce2529e2734bb1dULL, 0x1899e4a65f58660cULL,
+    0xb01ae745b101e9e4ULL, 0x5ec05dcff72e7f8fULL,
+    0xdc21a1171d42645dULL, 0x76707543f4fa1f73ULL,
+    0x899504ae72497ebaULL, 0x6a06494a791c53a8ULL,
+    0xabfa45da0edbde69ULL, 0x0487db9d17636892ULL,
+    0xd6f8d7509292d603ULL, 0x45a9d2845d3c42b6ULL,
+    0x865b86925b9bc5c2ULL, 0x0b8a2392ba45a9b2ULL,
+    0xa7f26836f282b732ULL, 0x8e6cac7768d7141eULL,
+    0xd1ef0244af2364ffULL, 0x3207d795430cd926ULL,
+    0x8335616aed761f1fULL, 0x7f44e6bd49e807b8ULL,
+    0xa402b9c5a8d3a6e7ULL, 0x5f16206c9c6209a6ULL,
+    0xcd036837130890a1ULL, 0x36dba887c37a8c0fULL,
+    0x802221226be55a64ULL, 0xc2494954da2c9789ULL,
+    0xa02aa96b06deb0fdULL, 0xf2db9baa10b7bd6cULL,
+    0xc83553c5c8965d3dULL, 0x6f92829494e5acc7ULL,
+    0xfa42a8b73abbf48cULL, 0xcb772339ba1f17f9ULL,
+    0x9c69a97284b578d7ULL, 0xff2a760414536efbULL,
+    0xc38413cf25e2d70dULL, 0xfef5138519684abaULL,
+    0xf46518c2ef5b8cd1ULL, 0x7eb258665fc25d69ULL,
+    0x98bf2f79d5993802ULL, 0xef2f773ffbd97a61ULL,
+    0xbeeefb584aff8603ULL, 0xaafb550ffacfd8faULL,
+    0xeeaaba2e5dbf6784ULL, 0x95ba2a53f983cf38ULL,
+    0x952ab45cfa97a0b2ULL, 0xdd945a747bf26183ULL,
+    0xba756174393d88dfULL, 0x94f971119aeef9e4ULL,
+    0xe912b9d1478ceb17ULL, 0x7a37cd5601aab85dULL,
+    0x91abb422ccb812eeULL, 0xac62e055c10ab33aULL,
+    0xb616a12b7fe617aaULL, 0x577b986b314d6009ULL,
+    0xe39c49765fdf9d94ULL, 0xed5a7e85fda0b80bULL,
+    0x8e41ade9fbebc27dULL, 0x14588f13be847307ULL,
+    0xb1d219647ae6b31cULL, 0x596eb2d8ae258fc8ULL,
+    0xde469fbd99a05fe3ULL, 0x6fca5f8ed9aef3bbULL,
+    0x8aec23d680043beeULL, 0x25de7bb9480d5854ULL,
+    0xada72ccc20054ae9ULL, 0xaf561aa79a10ae6aULL,
+    0xd910f7ff28069da4ULL, 0x1b2ba1518094da04ULL,
+    0x87aa9aff79042286ULL, 0x90fb44d2f05d0842ULL,
+    0xa99541bf57452b28ULL, 0x353a1607ac744a53ULL,
+    0xd3fa922f2d1675f2ULL, 0x42889b8997915ce8ULL,
+    0x847c9b5d7c2e09b7ULL, 0x69956135febada11ULL,
+    0xa59bc234db398c25ULL, 0x43fab9837e699095ULL,
+    0xcf02b2c21207ef2eULL, 0x94f967e45e03f4bbULL,
+    0x8161afb94b44f57dULL, 0x1d1be0eebac278f5ULL,
+    0xa1ba1ba79e1632dcULL, 0x6462d92a69731732ULL,
+    0xca28a291859bbf93ULL, 0x7d7b8f7503cfdcfeULL,
+    0xfcb2cb35e702af78ULL, 0x5cda735244c3d43eULL,
+    0x9defbf01b061adabULL, 0x3a0888136afa64a7ULL,
+    0xc56baec21c7a1916ULL, 0x088aaa1845b8fdd0ULL,
+    0xf6c69a72a3989f5bULL, 0x8aad549e57273d45ULL,
+    0x9a3c2087a63f6399ULL, 0x36ac54e2f678864bULL,
+    0xc0cb28a98fcf3c7fULL, 0x84576a1bb416a7ddULL,
+    0xf0fdf2d3f3c30b9fULL, 0x656d44a2a11c51d5ULL,
+    0x969eb7c47859e743ULL, 0x9f644ae5a4b1b325ULL,
+    0xbc4665b596706114ULL, 0x873d5d9f0dde1feeULL,
+    0xeb57ff22fc0c7959ULL, 0xa90cb506d155a7eaULL,
+    0x9316ff75dd87cbd8ULL, 0x09a7f12442d588f2ULL,
+    0xb7dcbf5354e9beceULL, 0x0c11ed6d538aeb2fULL,
+    0xe5d3ef282a242e81ULL, 0x8f1668c8a86da5faULL,
+    0x8fa475791a569d10ULL, 0xf96e017d694487bcULL,
+    0xb38d92d760ec4455ULL, 0x37c981dcc395a9acULL,
+    0xe070f78d3927556aULL, 0x85bbe253f47b1417ULL,
+    0x8c469ab843b89562ULL, 0x93956d7478ccec8eULL,
+    0xaf58416654a6babbULL, 0x387ac8d1970027b2ULL,
+    0xdb2e51bfe9d0696aULL, 0x06997b05fcc0319eULL,
+    0x88fcf317f22241e2ULL, 0x441fece3bdf81f03ULL,
+    0xab3c2fddeeaad25aULL, 0xd527e81cad7626c3ULL,
+    0xd60b3bd56a5586f1ULL, 0x8a71e223d8d3b074ULL,
+    0x85c7056562757456ULL, 0xf6872d5667844e49ULL,
+    0xa738c6bebb12d16cULL, 0xb428f8ac016561dbULL,
+    0xd106f86e69d785c7ULL, 0xe13336d701beba52ULL,
+    0x82a45b450226b39cULL, 0xecc0024661173473ULL,
+    0xa34d721642b06084ULL, 0x27f002d7f95d0190ULL,
+    0xcc20ce9bd35c78a5ULL, 0x31ec038df7b441f4ULL,
+    0xff290242c83396ceULL, 0x7e67047175a15271ULL,
+    0x9f79a169bd203e41ULL, 0x0f0062c6e984d386ULL,
+    0xc75809c42c684dd1ULL, 0x52c07b78a3e60868ULL,
+    0xf92e0c3537826145ULL, 0xa7709a56ccdf8a82ULL,
+    0x9bbcc7a142b17ccbULL, 0x88a66076400bb691ULL,
+    0xc2abf989935ddbfeULL, 0x6acff893d00ea435ULL,
+    0xf356f7ebf83552feULL, 0x0583f6b8c4124d43ULL,
+    0x98165af37b2153deULL, 0xc3727a337a8b704aULL,
+    0xbe1bf1b059e9a8d6ULL, 0x744f18c0592e4c5cULL,
+    0xeda2ee1c7064130cULL, 0x1162def06f79df73ULL,
+    0x9485d4d1c63e8be7ULL, 0x8addcb5645ac2ba8ULL,
+    0xb9a74a0637ce2ee1ULL, 0x6d953e2bd7173692ULL,
+    0xe8111c87c5c1ba99ULL, 0xc8fa8db6ccdd0437ULL,
+    0x910ab1d4db9914a0ULL, 0x1d9c9892400a22a2ULL,
+    0xb54d5e4a127f59c8ULL, 0x2503beb6d00cab4bULL,
+    0xe2a0b5dc971f303aULL, 0x2e44ae64840fd61dULL,
+    0x8da471a9de737e24ULL, 0x5ceaecfed289e5d2ULL,
+    0xb10d8e1456105dadULL, 0x7425a83e872c5f47ULL,
+    0xdd50f1996b947518ULL, 0xd12f124e28f77719ULL,
+    0x8a5296ffe33cc92fULL, 0x82bd6b70d99aaa6fULL,
+    0xace73cbfdc0bfb7bULL, 0x636cc64d1001550bULL,
+    0xd8210befd30efa5aULL, 0x3c47f7e05401aa4eULL,
+    0x8714a775e3e95c78ULL, 0x65acfaec34810a71ULL,
+    0xa8d9d1535ce3b396ULL, 0x7f1839a741a14d0dULL,
+    0xd31045a8341ca07cULL, 0x1ede48111209a050ULL,
+    0x83ea2b892091e44dULL, 0x934aed0aab460432ULL,
+    0xa4e4b66b68b65d60ULL, 0xf81da84d5617853fULL,
+    0xce1de40642e3f4b9ULL, 0x36251260ab9d668eULL,
+    0x80d2ae83e9ce78f3ULL, 0xc1d72b7c6b426019ULL,
+    0xa1075a24e4421730ULL, 0xb24cf65b8612f81fULL,
+    0xc94930ae1d529cfcULL, 0xdee033f26797b627ULL,
+    0xfb9b7cd9a4a7443cULL, 0x169840ef017da3b1ULL,
+    0x9d412e0806e88aa5ULL, 0x8e1f289560ee864eULL,
+    0xc491798a08a2ad4eULL, 0xf1a6f2bab92a27e2ULL,
+    0xf5b5d7ec8acb58a2ULL, 0xae10af696774b1dbULL,
+    0x9991a6f3d6bf1765ULL, 0xacca6da1e0a8ef29ULL,
+    0xbff610b0cc6edd3fULL, 0x17fd090a58d32af3ULL,
+    0xeff394dcff8a948eULL, 0xddfc4b4cef07f5b0ULL,
+    0x95f83d0a1fb69cd9ULL, 0x4abdaf101564f98eULL,
+    0xbb764c4ca7a4440fULL, 0x9d6d1ad41abe37f1ULL,
+    0xea53df5fd18d5513ULL, 0x84c86189216dc5edULL,
+    0x92746b9be2f8552cULL, 0x32fd3cf5b4e49bb4ULL,
+    0xb7118682dbb66a77ULL, 0x3fbc8c33221dc2a1ULL,
+    0xe4d5e82392a40515ULL, 0x0fabaf3feaa5334aULL,
+    0x8f05b1163ba6832dULL, 0x29cb4d87f2a7400eULL,
+    0xb2c71d5bca9023f8ULL, 0x743e20e9ef511012ULL,
+    0xdf78e4b2bd342cf6ULL, 0x914da9246b255416ULL,
+    0x8bab8eefb6409c1aULL, 0x1ad089b6c2f7548eULL,
+    0xae9672aba3d0c320ULL, 0xa184ac2473b529b1ULL,
+    0xda3c0f568cc4f3e8ULL, 0xc9e5d72d90a2741eULL,
+    0x8865899617fb1871ULL, 0x7e2fa67c7a658892ULL,
+    0xaa7eebfb9df9de8dULL, 0xddbb901b98feeab7ULL,
+    0xd51ea6fa85785631ULL, 0x552a74227f3ea565ULL,
+    0x8533285c936b35deULL, 0xd53a88958f87275fULL,
+    0xa67ff273b8460356ULL, 0x8a892abaf368f137ULL,
+    0xd01fef10a657842cULL, 0x2d2b7569b0432d85ULL,
+    0x8213f56a67f6b29bULL, 0x9c3b29620e29fc73ULL,
+    0xa298f2c501f45f42ULL, 0x8349f3ba91b47b8fULL,
+    0xcb3f2f7642717713ULL, 0x241c70a936219a73ULL,
+    0xfe0efb53d30dd4d7ULL, 0xed238cd383aa0110ULL,
+    0x9ec95d1463e8a506ULL, 0xf4363804324a40aaULL,
+    0xc67bb4597ce2ce48ULL, 0xb143c6053edcd0d5ULL,
+    0xf81aa16fdc1b81daULL, 0xdd94b7868e94050aULL,
+    0x9b10a4e5e9913128ULL, 0xca7cf2b4191c8326ULL,
+    0xc1d4ce1f63f57d72ULL, 0xfd1c2f611f63a3f0ULL,
+    0xf24a01a73cf2dccfULL, 0xbc633b39673c8cecULL,
+    0x976e41088617ca01ULL, 0xd5be0503e085d813ULL,
+    0xbd49d14aa79dbc82ULL, 0x4b2d8644d8a74e18ULL,
+    0xec9c459d51852ba2ULL, 0xddf8e7d60ed1219eULL,
+    0x93e1ab8252f33b45ULL, 0xcabb90e5c942b503ULL,
+    0xb8da1662e7b00a17ULL, 0x3d6a751f3b936243ULL,
+    0xe7109bfba19c0c9dULL, 0x0cc512670a783ad4ULL,
+    0x906a617d450187e2ULL, 0x27fb2b80668b24c5ULL,
+    0xb484f9dc9641e9daULL, 0xb1f9f660802dedf6ULL,
+    0xe1a63853bbd26451ULL, 0x5e7873f8a0396973ULL,
+    0x8d07e33455637eb2ULL, 0xdb0b487b6423e1e8ULL,
+    0xb049dc016abc5e5fULL, 0x91ce1a9a3d2cda62ULL,
+    0xdc5c5301c56b75f7ULL, 0x7641a140cc7810fbULL,
+    0x89b9b3e11b6329baULL, 0xa9e904c87fcb0a9dULL,
+    0xac2820d9623bf429ULL, 0x546345fa9fbdcd44ULL,
+    0xd732290fbacaf133ULL, 0xa97c177947ad4095ULL,
+    0x867f59a9d4bed6c0ULL, 0x49ed8eabcccc485dULL,
+    0xa81f301449ee8c70ULL, 0x5c68f256bfff5a74ULL,
+    0xd226fc195c6a2f8cULL, 0x73832eec6fff3111ULL,
+    0x83585d8fd9c25db7ULL, 0xc831fd53c5ff7eabULL,
+    0xa42e74f3d032f525ULL, 0xba3e7ca8b77f5e55ULL,
+    0xcd3a1230c43fb26fULL, 0x28ce1bd2e55f35ebULL,
+    0x80444b5e7aa7cf85ULL, 0x7980d163cf5b81b3ULL,
+    0xa0555e361951c366ULL, 0xd7e105bcc332621fULL,
+    0xc86ab5c39fa63440ULL, 0x8dd9472bf3fefaa7ULL,
+    0xfa856334878fc150ULL, 0xb14f98f6f0feb951ULL,
+    0x9c935e00d4b9d8d2ULL, 0x6ed1bf9a569f33d3ULL,
+    0xc3b8358109e84f07ULL, 0x0a862f80ec4700c8ULL,
+    0xf4a642e14c6262c8ULL, 0xcd27bb612758c0faULL,
+    0x98e7e9cccfbd7dbdULL, 0x8038d51cb897789cULL,
+    0xbf21e44003acdd2cULL, 0xe0470a63e6bd56c3ULL,
+    0xeeea5d5004981478ULL, 0x1858ccfce06cac74ULL,
+    0x95527a5202df0ccbULL, 0x0f37801e0c43ebc8ULL,
+    0xbaa718e68396cffdULL, 0xd30560258f54e6baULL,
+    0xe950df20247c83fdULL, 0x47c6b82ef32a2069ULL,
+    0x91d28b7416cdd27eULL, 0x4cdc331d57fa5441ULL,
+    0xb6472e511c81471dULL, 0xe0133fe4adf8e952ULL,
+    0xe3d8f9e563a198e5ULL, 0x58180fddd97723a6ULL,
+    0x8e679c2f5e44ff8fULL, 0x570f09eaa7ea7648ULL,
+    // q in [JSON_LARGEST_POWER_OF_TEN + 1, JSON_LARGEST_POWER_OF_FIVE], only read by json_shortest_decimal
+    0xb201833b35d63f73ULL, 0x2cd2cc6551e513daULL,
+    0xde81e40a034bcf4fULL, 0xf8077f7ea65e58d1ULL,
+    0x8b112e86420f6191ULL, 0xfb04afaf27faf782ULL,
+    0xadd57a27d29339f6ULL, 0x79c5db9af1f9b563ULL,
+    0xd94ad8b1c7380874ULL, 0x18375281ae7822bcULL,
+    0x87cec76f1c830548ULL, 0x8f2293910d0b15b5ULL,
+    0xa9c2794ae3a3c69aULL, 0xb2eb3875504ddb22ULL,
+    0xd433179d9c8cb841ULL, 0x5fa60692a46151ebULL,
+    0x849feec281d7f328ULL, 0xdbc7c41ba6bcd333ULL,
+    0xa5c7ea73224deff3ULL, 0x12b9b522906c0800ULL,
+    0xcf39e50feae16befULL, 0xd768226b34870a00ULL,
+    0x81842f29f2cce375ULL, 0xe6a1158300d46640ULL,
+    0xa1e53af46f801c53ULL, 0x60495ae3c1097fd0ULL,
+    0xca5e89b18b602368ULL, 0x385bb19cb14bdfc4ULL,
+    0xfcf62c1dee382c42ULL, 0x46729e03dd9ed7b5ULL,
+    0x9e19db92b4e31ba9ULL, 0x6c07a2c26a8346d1ULL,
+    0xc5a05277621be293ULL, 0xc7098b7305241885ULL
+};
+
+/**
+ * \brief Exactly representable powers of ten used by the Clinger fast path
+ */
+static const double json_exact_powers_of_ten[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * \brief Helper function to determine if a character is a decimal digit, without the locale lookup of isdigit
+ *
+ * \param[in] c character in question
+ *
+ * \return true if c is one of 0-9, false otherwise
+ */
+static bool is_json_digit(char c)
+{
+    return (unsigned char) (c - '0') < 10;
+}
+
+/**
+ * \brief Helper function to load 8 characters into an integer so that the first character ends up
+ * in the lowest byte, whatever the byte order of the machine
+ *
+ * \param[in] in input string with at least 8 readable characters
+ *
+ * \return the 8 characters packed into an integer
+ */
+static uint64_t json_load_eight_bytes(const char *in)
+{
+    uint64_t chunk;
+    memcpy(&chunk, in, sizeof(chunk));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    chunk = __builtin_bswap64(chunk);
+#endif
+    return chunk;
+}
+
+/**
+ * \brief Helper function to check 8 packed characters for digits at once (SWAR). Adding 0x46 to a
+ * byte sets its top bit for anything above '9' and subtracting 0x30 sets it for anything below '0'.
+ *
+ * \param[in] chunk 8 characters loaded with json_load_eight_bytes
+ *
+ * \return true if all 8 characters are digits, false otherwise
+ */
+static bool json_is_eight_digits(uint64_t chunk)
+{
+    return (((chunk + UINT64_C(0x4646464646464646)) | (chunk - UINT64_C(0x3030303030303030))) & UINT64_C(0x8080808080808080)) == 0;
+}
+
+/**
+ * \brief Helper function to convert 8 packed digits into their value with three multiplies,
+ * combining neighbouring digits into pairs, pairs into quads and quads into the final value.
+ *
+ * \param[in] chunk 8 digits loaded with json_load_eight_bytes
+ *
+ * \return value of the 8 digits, 0 to 99999999
+ */
+static uint64_t json_parse_eight_digits(uint64_t chunk)
+{
+    const uint64_t mask = UINT64_C(0x000000FF000000FF);
+    const uint64_t mul1 = UINT64_C(0x000F424000000064); // 100 + (1000000 << 32)
+    const uint64_t mul2 = UINT64_C(0x0000271000000001); // 1 + (10000 << 32)
+
+    chunk -= UINT64_C(0x3030303030303030);
+    chunk = (chunk * 10) + (chunk >> 8); // pairs of digits in every other byte
+    chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+    return chunk;
+}
+
+/**
+ * \brief Helper function to append a run of digits to a decimal mantissa. Runs of 8 digits go through
+ * the SWAR path, the remaining few one at a time. The mantissa silently wraps on more than 19
+ * digits, read_json_number counts digits and handles that case on its own.
+ *
+ * \param[in] json first character of the run
+ * \param[in] end end of the input
+ * \param[in] mantissa address of the mantissa to extend
+ *
+ * \return first character after the run of digits
+ */
+static char* json_read_digits(char *json, const char *end, uint64_t *mantissa)
+{
+    uint64_t value = *mantissa;
+
+    while (end - json >= 8)
+    {
+        uint64_t chunk = json_load_eight_bytes(json);
+        if (!json_is_eight_digits(chunk)) break;
+
+        value = value * 100000000 + json_parse_eight_digits(chunk);
+        json += 8;
+    }
+
+    while (json < end && is_json_digit(*json))
+    {
+        value = value * 10 + (uint64_t) (*json++ - '0');
+    }
+
+    *mantissa = value;
+    return json;
+}
+
+/**
+ * \brief Helper function to multiply two 64 bit integers into a 128 bit result
+ *
+ * \param[in] a first factor
+ * \param[in] b second factor
+ * \param[in] high address of an integer that stores the upper 64 bits of the product
+ *
+ * \return lower 64 bits of the product
+ */
+static uint64_t json_mul128(uint64_t a, uint64_t b, uint64_t *high)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = (unsigned __int128) a * b;
+    *high = (uint64_t) (product >> 64);
+    return (uint64_t) product;
+#else
+    uint64_t a_lo = (uint32_t) a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t) b, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (uint32_t) hi_lo + lo_hi;
+    *high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    return (cross << 32) | (uint32_t) lo_lo;
+#endif
+}
+
+/**
+ * \brief Helper function implementing the Eisel-Lemire algorithm: converts w * 10^q to the nearest
+ * double using a 128 bit approximation of 5^q. The 128 bit product is always precise enough to
+ * round correctly (Mushtak and Lemire, "Fast Number Parsing Without Fallback").
+ *
+ * \param[in] q decimal exponent
+ * \param[in] w decimal mantissa
+ *
+ * \return IEEE 754 bits of the result without the sign bit
+ */
+static uint64_t json_eisel_lemire(int64_t q, uint64_t w)
+{
+    if (w == 0 || q < JSON_SMALLEST_POWER_OF_TEN) return 0;
+    if (q > JSON_LARGEST_POWER_OF_TEN) return (uint64_t) 0x7FF << 52; // infinity
+
+    // normalize the mantissa so its most significant bit is set
+    int leading_zeros = 0;
+    while ((w & ((uint64_t) 1 << 63)) == 0)
+    {
+        w <<= 1;
+        leading_zeros++;
+    }
+
+    const uint64_t *power = &json_power_of_five_128[2 * (q - JSON_SMALLEST_POWER_OF_TEN)];
+    uint64_t high;
+    uint64_t low = json_mul128(w, power[0], &high);
+
+    // only the upper 55 bits are needed, widen the product if the lower bits of them might carry
+    const uint64_t precision_mask = UINT64_C(0xFFFFFFFFFFFFFFFF) >> 55;
+    if ((high & precision_mask) == precision_mask)
+    {
+        uint64_t second_high;
+        json_mul128(w, power[1], &second_high);
+        low += second_high;
+        if (second_high > low) high++;
+    }
+
+    int upper_bit = (int) (high >> 63);
+    int shift = upper_bit + 64 - 52 - 3;
+    uint64_t mantissa = high >> shift;
+    int64_t power2 = ((((152170 + 65536) * q) >> 16) + 63) + upper_bit - leading_zeros + 1023;
+
+    if (power2 <= 0)
+    {
+        // subnormal result
+        if (-power2 + 1 >= 64) return 0;
+
+        mantissa >>= -power2 + 1;
+        mantissa += (mantissa & 1);
+        mantissa >>= 1;
+        power2 = mantissa < ((uint64_t) 1 << 52) ? 0 : 1;
+
+        return ((uint64_t) power2 << 52) | (mantissa & (((uint64_t) 1 << 52) - 1));
+    }
+
+    // exactly halfway between two doubles, round to even instead of up
+    if (low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << shift) == high)
+    {
+        mantissa &= ~(uint64_t) 1;
+    }
+
+    mantissa += (mantissa & 1);
+    mantissa >>= 1;
+    if (mantissa >= ((uint64_t) 2 << 52))
+    {
+        mantissa = (uint64_t) 1 << 52;
+        power2++;
+    }
+    mantissa &= ~((uint64_t) 1 << 52);
+
+    if (power2 >= 0x7FF) return (uint64_t) 0x7FF << 52; // infinity
+
+    return ((uint64_t) power2 << 52) | mantissa;
+}
+
+/**
+ * \brief Helper function computing ceil(log2(5^e)), the bit length of 5^e, for e in [1, 3528].
+ * Returns 1 for e = 0.
+ *
+ * \param[in] e power of five
+ *
+ * \return bit length of 5^e
+ */
+static int32_t json_pow5_bits(int32_t e)
+{
+    return (int32_t) (((uint32_t) e * 1217359) >> 19) + 1;
+}
+
+/**
+ * \brief Helper function computing floor(log10(2^e)) for e in [0, 1650]
+ *
+ * \param[in] e power of two
+ *
+ * \return floor(log10(2^e))
+ */
+static int32_t json_log10_pow2(int32_t e)
+{
+    return (int32_t) (((uint32_t) e * 78913) >> 18);
+}
+
+/**
+ * \brief Helper function computing floor(log10(5^e)) for e in [0, 2620]
+ *
+ * \param[in] e power of five
+ *
+ * \return floor(log10(5^e))
+ */
+static int32_t json_log10_pow5(int32_t e)
+{
+    return (int32_t) (((uint32_t) e * 732923) >> 20);
+}
+
+/**
+ * \brief Helper function to check if 5^p divides value
+ *
+ * \param[in] value non zero integer
+ * \param[in] p power of five
+ *
+ * \return true if value is a multiple of 5^p
+ */
+static bool json_multiple_of_power_of_five(uint64_t value, int32_t p)
+{
+    int32_t count = 0;
+    while (value % 5 == 0)
+    {
+        value /= 5;
+        count++;
+    }
+
+    return count >= p;
+}
+
+/**
+ * \brief Helper function to compute (m * factor) >> j for a 128 bit factor, 64 < j < 128
+ *
+ * \param[in] m integer of at most 55 bits
+ * \param[in] factor (high, low) pair of the 128 bit factor
+ * \param[in] j number of bits to shift the 192 bit product by
+ *
+ * \return lower 64 bits of the shifted product
+ */
+static uint64_t json_mul_shift(uint64_t m, const uint64_t *factor, int32_t j)
+{
+    uint64_t low_high;
+    json_mul128(m, factor[1], &low_high);
+
+    uint64_t high_high;
+    uint64_t high_low = json_mul128(m, factor[0], &high_high);
+
+    uint64_t sum = high_low + low_high;
+    high_high += sum < high_low;
+
+    int32_t shift = j - 64;
+    return (high_high << (64 - shift)) | (sum >> shift);
+}
+
+/**
+ * \brief Helper function to find the shortest decimal that reads back as a given double (Ryu,
+ * Adams 2018). The powers of five come from json_power_of_five_128, shifted down to the 125 bit
+ * precision Ryu needs: 5^q directly, 2^k / 5^q + 1 from the entry of -q, which is the ceiling of
+ * the 128 bit value for q <= 27 and its floor above.
+ *
+ * \param[in] ieee_mantissa stored mantissa bits of a finite, non zero double
+ * \param[in] ieee_exponent stored exponent bits of the double
+ * \param[in] digits address of an integer that stores the decimal digits
+ *
+ * \return decimal exponent, the double is closest to digits * 10^exponent
+ */
+static int32_t json_shortest_decimal(uint64_t ieee_mantissa, uint32_t ieee_exponent, uint64_t *digits)
+{
+    int32_t e2;
+    uint64_t m2;
+    if (ieee_exponent == 0)
+    {
+        e2 = 1 - 1023 - 52 - 2;
+        m2 = ieee_mantissa;
+    } else
+    {
+        e2 = (int32_t) ieee_exponent - 1023 - 52 - 2;
+        m2 = ((uint64_t) 1 << 52) | ieee_mantissa;
+    }
+    bool accept_bounds = (m2 & 1) == 0; // round to even: halfway points read back as this double
+
+    // Step 1: the interval of decimals that round to this double is (mm, mp) around mv, scaled by 4
+    uint64_t mv = 4 * m2;
+    uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1; // the interval below powers of two is half as wide
+
+    // Step 2: scale the interval by a power of ten so its bounds become integers vm, vr, vp
+    uint64_t vr, vp, vm;
+    int32_t e10;
+    bool vm_is_trailing_zeros = false;
+    bool vr_is_trailing_zeros = false;
+    if (e2 >= 0)
+    {
+        int32_t q = json_log10_pow2(e2) - (e2 > 3);
+        e10 = q;
+        int32_t k = 125 + json_pow5_bits(q) - 1;
+        int32_t i = -e2 + q + k;
+
+        // 2^k / 5^q + 1 at 125 bits
+        uint64_t factor[2] = { (uint64_t) 1 << 61, 1 };
+        if (q > 0)
+        {
+            const uint64_t *power = &json_power_of_five_128[2 * (-q - JSON_SMALLEST_POWER_OF_TEN)];
+            uint64_t high = power[0], low = power[1];
+            if (q <= 27)
+            {
+                high -= low == 0;
+                low -= 1;
+            }
+            factor[1] = ((low >> 3) | (high << 61)) + 1;
+            factor[0] = (high >> 3) + (factor[1] == 0);
+        }
+
+        vr = json_mul_shift(4 * m2, factor, i);
+        vp = json_mul_shift(4 * m2 + 2, factor, i);
+        vm = json_mul_shift(4 * m2 - 1 - mm_shift, factor, i);
+
+        if (q <= 21)
+        {
+            // only one of mp, mv and mm can be a multiple of 5, if any
+            if (mv % 5 == 0) vr_is_trailing_zeros = json_multiple_of_power_of_five(mv, q);
+            else if (accept_bounds) vm_is_trailing_zeros = json_multiple_of_power_of_five(mv - 1 - mm_shift, q);
+            else vp -= json_multiple_of_power_of_five(mv + 2, q);
+        }
+    } else
+    {
+        int32_t q = json_log10_pow5(-e2) - (-e2 > 1);
+        e10 = q + e2;
+        int32_t i = -e2 - q;
+        int32_t k = json_pow5_bits(i) - 125;
+        int32_t j = q - k;
+
+        // 5^i at 125 bits
+        const uint64_t *power = &json_power_of_five_128[2 * (i - JSON_SMALLEST_POWER_OF_TEN)];
+        uint64_t factor[2] = { power[0] >> 3, (power[1] >> 3) | (power[0] << 61) };
+
+        vr = json_mul_shift(4 * m2, factor, j);
+        vp = json_mul_shift(4 * m2 + 2, factor, j);
+        vm = json_mul_shift(4 * m2 - 1 - mm_shift, factor, j);
+
+        if (q <= 1)
+        {
+            // mv has at least q trailing zero bits, so vr is exact
+            vr_is_trailing_zeros = true;
+            if (accept_bounds) vm_is_trailing_zeros = mm_shift == 1;
+            else --vp;
+        } else if (q < 63)
+        {
+            vr_is_trailing_zeros = (mv & (((uint64_t) 1 << q) - 1)) == 0;
+        }
+    }
+
+    // Step 3: drop digits while vm and vp still differ, keeping track of how to round vr
+    int32_t removed = 0;
+    uint8_t last_removed_digit = 0;
+    uint64_t output;
+    if (vm_is_trailing_zeros || vr_is_trailing_zeros)
+    {
+        // rare: exact decimal bounds, ties need the removed digits
+        while (vp / 10 > vm / 10)
+        {
+            vm_is_trailing_zeros &= vm % 10 == 0;
+            vr_is_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = (uint8_t) (vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        if (vm_is_trailing_zeros)
+        {
+            while (vm % 10 == 0)
+            {
+                vr_is_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = (uint8_t) (vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+        if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0) last_removed_digit = 4; // round half to even
+        output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) || last_removed_digit >= 5);
+    } else
+    {
+        // common case: two digits at a time first, then one at a time
+        bool round_up = false;
+        if (vp / 100 > vm / 100)
+        {
+            round_up = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        while (vp / 10 > vm / 10)
+        {
+            round_up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        output = vr + (vr == vm || round_up);
+    }
+
+    *digits = output;
+    return e10 + removed;
+}
+
+/**
+ * \brief Helper function to format a double as the shortest json number that reads back as the
+ * same double. Digits come from json_shortest_decimal, the point is placed the way JavaScript does:
+ * plain decimals for magnitudes in [1e-6, 1e21), exponent notation outside. Integral values get a
+ * ".0" so they read back as floats. The output does not depend on the locale. Infinity and NaN
+ * have no json representation and are written as null.
+ *
+ * \param[in] value double to format
+ * \param[in] buffer output buffer of at least 32 bytes
+ *
+ * \return number of characters written to buffer
+ */
+static size_t json_format_float(double value, char *buffer)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint64_t ieee_mantissa = bits & (((uint64_t) 1 << 52) - 1);
+    uint32_t ieee_exponent = (uint32_t) (bits >> 52) & 0x7FF;
+
+    if (ieee_exponent == 0x7FF)
+    {
+        memcpy(buffer, "null", 4);
+        return 4;
+    }
+
+    char *out = buffer;
+    if (bits >> 63) *out++ = '-';
+
+    if (ieee_exponent == 0 && ieee_mantissa == 0)
+    {
+        memcpy(out, "0.0", 3);
+        return (size_t) (out + 3 - buffer);
+    }
+
+    uint64_t digits;
+    int32_t exponent = json_shortest_decimal(ieee_mantissa, ieee_exponent, &digits);
+    while (digits % 10 == 0)
+    {
+        digits /= 10;
+        exponent++;
+    }
+
+    int32_t length = (int32_t) json_count_digits(digits);
+    int32_t point = length + exponent; // digits before the decimal point
+
+    if (point > 0 && point <= 21)
+    {
+        json_write_digits(out, digits, (size_t) length);
+        if (exponent >= 0)
+        {
+            // integral: pad with zeros
+            memset(out + length, '0', (size_t) exponent);
+            out += point;
+            *out++ = '.';
+            *out++ = '0';
+        } else
+        {
+            memmove(out + point + 1, out + point, (size_t) (length - point));
+            out[point] = '.';
+            out += length + 1;
+        }
+    } else if (point <= 0 && point > -6)
+    {
+        *out++ = '0';
+        *out++ = '.';
+        memset(out, '0', (size_t) -point);
+        out += -point;
+        json_write_digits(out, digits, (size_t) length);
+        out += length;
+    } else
+    {
+        // d.ddde[-]x
+        json_write_digits(out + 1, digits, (size_t) length);
+        out[0] = out[1];
+        if (length > 1)
+        {
+            out[1] = '.';
+            out += length + 1;
+        } else
+        {
+            out += 1;
+        }
+
+        int32_t scientific_exponent = point - 1;
+        *out++ = 'e';
+        if (scientific_exponent < 0)
+        {
+            *out++ = '-';
+            scientific_exponent = -scientific_exponent;
+        }
+        size_t exponent_length = json_count_digits((uint64_t) scientific_exponent);
+        json_write_digits(out, (uint64_t) scientific_exponent, exponent_length);
+        out += exponent_length;
+    }
+
+    return (size_t) (out - buffer);
+}
+
+/**
+ * \brief Helper function for numbers the fast paths can not round correctly, hands the digits to
+ * strtod. The decimal point is folded into the exponent so strtod never sees a character that
+ * depends on LC_NUMERIC, without reading the locale of another thread.
+ *
+ * \param[in] start first character of the number
+ * \param[in] end one past the last character of the number
+ * \param[in] value address of a double that stores the correctly rounded result
+ *
+ * \return true on success, false if the copy can not be allocated
+ */
+static bool json_slow_to_double(const char *start, const char *end, double *value)
+{
+    char buffer[128];
+    size_t size = (size_t) (end - start);
+    char *copy = size + 24 <= sizeof(buffer) ? buffer : (char *) malloc(size + 24);
+    if (copy == NULL) return false;
+
+    // copy sign and digits without the '.', every fraction digit lowers the exponent by one
+    size_t copy_size = 0;
+    int64_t exponent = 0;
+    bool in_fraction = false;
+    const char *in = start;
+    for (; in < end && *in != 'e' && *in != 'E'; ++in)
+    {
+        if (*in == '.')
+        {
+            in_fraction = true;
+            continue;
+        }
+        if (in_fraction) exponent--;
+        copy[copy_size++] = *in;
+    }
+
+    // the explicit exponent saturates like in read_json_number, strtod rounds to 0 or inf long before
+    if (in < end)
+    {
+        bool negative_exponent = ++in < end && *in == '-';
+        if (in < end && (*in == '-' || *in == '+')) in++;
+
+        int64_t explicit_exponent = 0;
+        for (; in < end; ++in)
+        {
+            if (explicit_exponent < 0x10000000) explicit_exponent = explicit_exponent * 10 + (*in - '0');
+        }
+        exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+    }
+    snprintf(copy + copy_size, 24, "e%lld", (long long) exponent);
+
+    *value = strtod(copy, NULL);
+    if (copy != buffer) free(copy);
+
+    return true;
+}
+
+/**
+ * \brief Function to read a json number. Integers that fit into a long become JSON_INT, everything
+ * else becomes a correctly rounded JSON_FLOAT: the Clinger fast path handles short mantissas with
+ * small exponents, Eisel-Lemire handles the rest and strtod only sees mantissas of more than 19
+ * significant digits that Eisel-Lemire can not settle.
+ *
+ * \param[in] parser parser state holding the handler
+ * \param[in] json input string
+ *
+ * \return remaining input string after parsing first json number found
+ */
+static char* read_json_number(json_parser_t *parser, char *json)
+{
+    const char *end = parser->end;
+    char *start = json;
+
+    // negative check
+    bool is_negative = false;
+    if (json < end && *json == '-')
+    {
+        is_negative = true;
+        json++;
+    }
+
+    // Collect the digits of the integer and fraction part into one decimal mantissa
+    uint64_t mantissa = 0;
+    char *integer_start = json;
+    json = json_read_digits(json, end, &mantissa);
+    char *integer_end = json;
+    if (integer_end == integer_start) return json_parser_fail(parser, json, "expected a digit");
+
+    bool is_float = false;
+    int64_t exponent = 0;
+    char *fraction_start = json;
+    char *fraction_end = json;
+    if (json < end && *json == '.')
+    {
+        is_float = true;
+        fraction_start = ++json;
+        json = json_read_digits(json, end, &mantissa);
+        fraction_end = json;
+        if (fraction_end == fraction_start) return json_parser_fail(parser, json, "expected a digit after the decimal point");
+        exponent = -(int64_t) (fraction_end - fraction_start);
+    }
+
+    int64_t explicit_exponent = 0;
+    if (json < end && (*json == 'e' || *json == 'E'))
+    {
+        json++;
+        bool negative_exponent = false;
+        if (json < end && (*json == '-' || *json == '+'))
+        {
+            negative_exponent = *json == '-';
+            json++;
+        }
+        if (json >= end || !is_json_digit(*json)) return json_parser_fail(parser, json, "expected a digit in the exponent");
+        while (json < end && is_json_digit(*json))
+        {
+            if (explicit_exponent < 0x10000000) explicit_exponent = explicit_exponent * 10 + (*json - '0');
+            json++;
+        }
+        if (negative_exponent) explicit_exponent = -explicit_exponent;
+    }
+    exponent += explicit_exponent;
+
+    // More than 19 digits overflow the mantissa, keep the first 19 significant digits instead
+    size_t digit_count = (size_t) (integer_end - integer_start) + (size_t) (fraction_end - fraction_start);
+    bool truncated = false;
+    if (digit_count > 19)
+    {
+        char *p = integer_start;
+        while (p < fraction_end && (*p == '0' || *p == '.'))
+        {
+            if (*p == '0') digit_count--;
+            p++;
+        }
+
+        if (digit_count > 19)
+        {
+            const uint64_t minimal_nineteen_digit_integer = UINT64_C(1000000000000000000);
+            truncated = true;
+            mantissa = 0;
+
+            p = integer_start;
+            while (mantissa < minimal_nineteen_digit_integer && p < integer_end)
+            {
+                mantissa = mantissa * 10 + (uint64_t) (*p++ - '0');
+            }
+
+            if (mantissa >= minimal_nineteen_digit_integer)
+            {
+                exponent = (integer_end - p) + explicit_exponent;
+            } else
+            {
+                p = fraction_start;
+                while (mantissa < minimal_nineteen_digit_integer && p < fraction_end)
+                {
+                    mantissa = mantissa * 10 + (uint64_t) (*p++ - '0');
+                }
+                exponent = (fraction_start - p) + explicit_exponent;
+            }
+        }
+    }
+
+    if (!is_float && !truncated && explicit_exponent >= 0)
+    {
+        // Integers that still fit into a long after applying a positive exponent stay integers
+        uint64_t integer = mantissa;
+        bool fits = true;
+        for (int64_t i = 0; i < explicit_exponent && integer != 0 && fits; ++i)
+        {
+            fits = integer <= UINT64_MAX / 10;
+            integer *= 10;
+        }
+
+        uint64_t limit = is_negative ? (uint64_t) LONG_MAX + 1 : (uint64_t) LONG_MAX;
+        if (fits && integer <= limit)
+        {
+            long value = is_negative ? (long) (0 - integer) : (long) integer;
+            if (parser->handler->on_int != NULL && !parser->handler->on_int(parser->user, value))
+            {
+                return json_parser_fail(parser, json, "stopped by handler");
+            }
+
+            return json;
+        }
+    }
+
+    double float_value;
+    if (!truncated && exponent >= -22 && exponent <= 22 && mantissa <= ((uint64_t) 1 << 53))
+    {
+        // Clinger fast path: both operands are exact so a single rounding gives the right answer
+        float_value = (double) mantissa;
+        if (exponent < 0) float_value /= json_exact_powers_of_ten[-exponent];
+        else float_value *= json_exact_powers_of_ten[exponent];
+        if (is_negative) float_value = -float_value;
+    } else
+    {
+        uint64_t bits = json_eisel_lemire(exponent, mantissa);
+
+        // A truncated mantissa lies between mantissa and mantissa + 1, if both round the same way we are done
+        if (truncated && bits != json_eisel_lemire(exponent, mantissa + 1))
+        {
+            if (!json_slow_to_double(start, json, &float_value)) return json_parser_fail(parser, start, "out of memory");
+        } else
+        {
+            bits |= (uint64_t) is_negative << 63;
+            memcpy(&float_value, &bits, sizeof(float_value));
+        }
+    }
+
+    if (parser->handler->on_float != NULL && !parser->handler->on_float(parser->user, float_value))
+    {
+        return json_parser_fail(parser, json, "stopped by handler");
+    }
+
+    return json;
+}
+
+
+/**
+ * \brief json_value_class_t of every byte a value can start with, the parser dispatches on it
+ * with a single table load instead of a chain of comparisons.
+ */
+static const unsigned char json_value_classes[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 1, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 3, 0, 0,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 7, 0, 0, 0, 0, 0, 0, 0, 8, 0,
+    0, 0, 0, 0, 6, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+/**
+ * \brief Helper function to open a container on the parser stack. The stack starts out in the
+ * caller's frames buffer and moves to the heap once it is full, up to parser->max_depth entries.
+ *
+ * \param[in] parser parser state holding the depth limit
+ * \param[in] json position of the opening bracket, for errors
+ * \param[in] frames parser stack, replaced by a larger heap copy when it is full
+ * \param[in] capacity number of entries frames holds, updated when it grows
+ * \param[in] depth number of containers already open
+ * \param[in] is_object true for an object, false for an array
+ *
+ * \return true if the container was opened, false if it nests too deep or memory ran out
+ */
+static bool json_parser_push(json_parser_t *parser, const char *json, json_parser_frame_t **frames, size_t *capacity, size_t depth, bool is_object)
+{
+    if (depth >= parser->max_depth)
+    {
+        json_parser_fail(parser, json, "nesting too deep");
+        return false;
+    }
+
+    if (depth == *capacity)
+    {
+        size_t new_capacity = *capacity * 2 < parser->max_depth ? *capacity * 2 : parser->max_depth;
+        json_parser_frame_t *new_frames = (json_parser_frame_t *) malloc(new_capacity * sizeof(json_parser_frame_t));
+        if (new_frames == NULL)
+        {
+            json_parser_fail(parser, json, "out of memory");
+            return false;
+        }
+
+        memcpy(new_frames, *frames, depth * sizeof(json_parser_frame_t));
+        if (*capacity > JSON_PARSER_STACK_SIZE) free(*frames); // the first frames buffer belongs to the caller
+        *frames = new_frames;
+        *capacity = new_capacity;
+    }
+
+    (*frames)[depth].size = 0;
+    (*frames)[depth].is_object = is_object;
+
+    return true;
+}
+
+/**
+ * \brief Helper function to read a json value, every token is reported to the parser's handler.
+ * Objects and arrays are tracked on an explicit stack rather than by recursion, so the C stack
+ * use does not depend on the input and nesting beyond parser->max_depth fails right at the
+ * bracket that crosses the limit.
+ *
+ * \param[in] parser parser state holding the handler
+ * \param[in] json input string
+ *
+ * \return remaining input string after parsing first json value found
+ */
+static char* load_json_helper(json_parser_t *parser, char *json)
+{
+    const json_sax_handler_t *handler = parser->handler;
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE];
+    json_parser_frame_t *frames = stack;
+    size_t capacity = JSON_PARSER_STACK_SIZE;
+    size_t depth = 0;
+
+    while (parser->error.message == NULL)
+    {
+        bool opened = false; // the value read below opened a container, its first member comes next
+        json = skip_white_space(parser, json);
+
+        switch (json_value_classes[(unsigned char) json_peek(parser, json)])
+        {
+            case JSON_VALUE_CLASS_STRING:
+                json = read_json_string(parser, json, '"');
+                break;
+
+            case JSON_VALUE_CLASS_SINGLE_QUOTED_STRING:
+                json = read_json_string(parser, json, '\'');
+                break;
+
+            case JSON_VALUE_CLASS_NUMBER:
+                json = read_json_number(parser, json);
+                break;
+
+            case JSON_VALUE_CLASS_OBJECT:
+            case JSON_VALUE_CLASS_ARRAY:
+            {
+                bool is_object = *json == '{';
+                if (!json_parser_push(parser, json, &frames, &capacity, depth, is_object)) break;
+                depth++;
+
+                bool (*on_begin)(void *user) = is_object ? handler->on_object_begin : handler->on_array_begin;
+                if (on_begin != NULL && !on_begin(parser->user))
+                {
+                    json = json_parser_fail(parser, json, "stopped by handler");
+                    break;
+                }
+
+                json++;
+                opened = true;
+                break;
+            }
+
+            case JSON_VALUE_CLASS_TRUE:
+                if (!json_match_literal(parser, json, "true", 4))
+                {
+                    json = json_parser_fail(parser, json, "unexpected character");
+                    break;
+                }
+                json += 4;
+                if (handler->on_bool != NULL && !handler->on_bool(parser->user, true)) json = json_parser_fail(parser, json, "stopped by handler");
+                break;
+
+            case JSON_VALUE_CLASS_FALSE:
+                if (!json_match_literal(parser, json, "false", 5))
+                {
+                    json = json_parser_fail(parser, json, "unexpected character");
+                    break;
+                }
+                json += 5;
+                if (handler->on_bool != NULL && !handler->on_bool(parser->user, false)) json = json_parser_fail(parser, json, "stopped by handler");
+                break;
+
+            case JSON_VALUE_CLASS_NULL:
+                if (!json_match_literal(parser, json, "null", 4))
+                {
+                    json = json_parser_fail(parser, json, "unexpected character");
+                    break;
+                }
+                json += 4;
+                if (handler->on_null != NULL && !handler->on_null(parser->user)) json = json_parser_fail(parser, json, "stopped by handler");
+                break;
+
+            default:
+                json = json_parser_fail(parser, json, json < parser->end ? "unexpected character" : "unexpected end of input");
+                break;
+        }
+
+        // step past the value: count it in its container, then close every container it completes
+        while (parser->error.message == NULL && depth > 0)
+        {
+            json_parser_frame_t *frame = &frames[depth - 1];
+            char close = frame->is_object ? '}' : ']';
+            json = skip_white_space(parser, json);
+
+            if (!opened)
+            {
+                frame->size++;
+                if (json_peek(parser, json) == ',')
+                {
+                    json = skip_white_space(parser, json + 1); // skip comma value if it exists
+                } else if (json_peek(parser, json) != close)
+                {
+                    const char *message = frame->is_object ? "expected ',' or '}' in object" : "expected ',' or ']' in array";
+                    json = json_parser_fail(parser, json, json < parser->end ? message : (frame->is_object ? "unterminated object" : "unterminated array"));
+                    break;
+                }
+            }
+            opened = false;
+
+            if (json_peek(parser, json) != close) break; // another member follows
+            json++;
+            depth--;
+
+            bool (*on_end)(void *user, size_t size) = frame->is_object ? handler->on_object_end : handler->on_array_end;
+            if (on_end != NULL && !on_end(parser->user, frame->size)) json = json_parser_fail(parser, json, "stopped by handler");
+        }
+
+        if (parser->error.message != NULL || depth == 0) break;
+        if (!frames[depth - 1].is_object) continue;
+
+        // read in the key of the next object member
+        const char *key = NULL;
+        size_t key_size = 0;
+        if (parser->intern != NULL && (json_peek(parser, json) == '"' || json_peek(parser, json) == '\''))
+        {
+            // only keys seen for the first time are copied, by the intern table
+            char *key_start = json;
+            json = read_string_borrowed(parser, json, &key, &key_size, *json);
+            if (parser->error.message != NULL) break;
+
+            key = json_intern(parser->intern, key, key_size);
+            if (key == NULL)
+            {
+                json = json_parser_fail(parser, key_start, "out of memory");
+                break;
+            }
+        } else if (json_peek(parser, json) == '"' || json_peek(parser, json) == '\'')
+        {
+            json = read_string(parser, json, &key, &key_size, *json);
+            if (parser->error.message != NULL) break;
+        } else
+        {
+            json = json_parser_fail(parser, json, json < parser->end ? "expected a string key" : "unterminated object");
+            break;
+        }
+
+        if (handler->on_key != NULL && !handler->on_key(parser->user, key, key_size))
+        {
+            json = json_parser_fail(parser, json, "stopped by handler");
+            break;
+        }
+
+        // Skip possible space between key and colon
+        json = skip_white_space(parser, json);
+        if (json_peek(parser, json) != ':')
+        {
+            json = json_parser_fail(parser, json, "expected ':' after object key");
+            break;
+        }
+        json++; // skip colon value
+    }
+
+    if (frames != stack) free(frames);
+
+    return json;
+}
+
+/**
+ * \brief Helper function to set up a parser for exactly size bytes of json
+ *
+ * \param[in] parser parser state to initialize, strings are borrowed from the input until an arena is set
+ * \param[in] json input that represents json data
+ * \param[in] size length of the input in bytes
+ * \param[in] flags json_parse_flags_t values or'ed together
+ * \param[in] handler callbacks receiving the tokens
+ * \param[in] user pointer passed through to every callback
+ */
+static void json_parser_init(json_parser_t *parser, char *json, size_t size, unsigned int flags, const json_sax_handler_t *handler, void *user)
+{
+    parser->handler = handler;
+    parser->user = user;
+    parser->arena = NULL;
+    parser->scratch = NULL;
+    parser->scratch_capacity = 0;
+    parser->input = json;
+    parser->end = json + size;
+    parser->readable_end = (flags & JSON_PARSE_PADDED) ? parser->end + JSON_PADDING : parser->end;
+    parser->structurals = NULL;
+    parser->structural_cursor = 0;
+    parser->insitu = (flags & JSON_PARSE_INSITU) != 0;
+    parser->intern = NULL;
+    parser->max_depth = JSON_MAX_DEPTH;
+    parser->error.message = NULL;
+    parser->error.offset = 0;
+
+    if (flags & JSON_PARSE_STRUCTURAL_INDEX)
+    {
+        // falls back to skipping white space byte by byte if the index can not be built
+        if (size < UINT32_MAX) parser->structurals = json_build_structural_index(json, size, (flags & JSON_PARSE_PADDED) != 0);
+    }
+}
+
+/**
+ * \brief Helper function to read the nesting limit out of parse options
+ *
+ * \param[in] options parse options, may be NULL
+ *
+ * \return deepest nesting of objects and arrays the parse accepts
+ */
+static size_t json_parse_max_depth(const json_parse_options_t *options)
+{
+    return options != NULL && options->max_depth != 0 ? options->max_depth : JSON_MAX_DEPTH;
+}
+
+/**
+ * \brief Helper function to parse the single root value of the input and release the parser's
+ * temporary memory
+ *
+ * \param[in] parser parser state set up with json_parser_init
+ * \param[in] error receives the reason and byte offset if the input is rejected, may be NULL
+ *
+ * \return true if the input was parsed, false if it is malformed or a callback stopped the parse
+ */
+static bool json_parser_run(json_parser_t *parser, json_parse_error_t *error)
+{
+    char *json = load_json_helper(parser, parser->input);
+
+    // only white space may follow the root value
+    json = skip_white_space(parser, json);
+    if (json < parser->end) json_parser_fail(parser, json, "unexpected characters after the root value");
+
+    free(parser->scratch);
+    free(parser->structurals);
+
+    if (error != NULL) *error = parser->error;
+
+    return parser->error.message == NULL;
+}
+
+/**
+ * \brief SAX style json parser in jajson.h. Walks exactly size bytes of json and reports every token
+ * to handler instead of building a document; nothing is allocated except a scratch buffer for strings
+ * with escapes. Objects and arrays report begin and end events around their members, object members
+ * report their key right before their value. The input is never written to, JSON_PARSE_INSITU is
+ * ignored, JSON_PARSE_PADDED and JSON_PARSE_STRUCTURAL_INDEX work as for load_json_n. With a shared
+ * intern table in options keys are handed out as the table's copy, which outlives the callback and
+ * can be compared by pointer; JSON_PARSE_INTERN_KEYS alone has no effect here.
+ *
+ * \param[in] json: input that represents json data
+ * \param[in] size: length of the input in bytes
+ * \param[in] options: parse options, NULL for defaults
+ * \param[in] handler: callbacks receiving the tokens, see json_sax_handler_t
+ * \param[in] user: pointer passed through to every callback
+ * \param[in] error: receives the reason and byte offset if the input is rejected, may be NULL
+ *
+ * \returns true if the whole input was parsed, false if it is malformed or a callback returned false.
+ * Events already delivered before an error are not taken back.
+ */
+bool json_sax_parse(const char *json, size_t size, const json_parse_options_t *options, const json_sax_handler_t *handler, void *user, json_parse_error_t *error)
+{
+    unsigned int flags = options != NULL ? options->flags : JSON_PARSE_DEFAULT;
+
+    json_parser_t parser;
+    json_parser_init(&parser, (char *) json, size, flags & ~(unsigned int) JSON_PARSE_INSITU, handler, user);
+    parser.max_depth = json_parse_max_depth(options);
+    parser.intern = options != NULL ? options->intern : NULL;
+
+    return json_parser_run(&parser, error);
+}
+
+//===== DOM BUILDER IMPLEMENTATION =====
+/**
+ * \brief Helper function to set up a builder with an empty scratch stack and no open containers
+ *
+ * \param[in] builder builder state to initialize
+ * \param[in] document document whose arena receives the nodes, may be NULL until the first value
+ */
+static void json_builder_init(json_builder_t *builder, json_document_t *document)
+{
+    builder->document = document;
+    builder->stack = NULL;
+    builder->stack_size = 0;
+    builder->stack_capacity = 0;
+    builder->frames = NULL;
+    builder->depth = 0;
+    builder->frames_capacity = 0;
+    builder->key = NULL;
+    builder->key_size = 0;
+    builder->failure = NULL;
+}
+
+/**
+ * \brief Helper function to reserve space on the builder's scratch stack. Members of open containers
+ * are collected here and copied into the arena in one piece once the container is closed.
+ *
+ * NOTE: the stack may move when it grows, only hold on to offsets across events
+ *
+ * \param[in] builder builder owning the scratch stack
+ * \param[in] size number of bytes to reserve
+ *
+ * \return pointer to reserved space on top of the stack, NULL if out of memory
+ */
+static void* json_builder_push(json_builder_t *builder, size_t size)
+{
+    if (builder->stack_size + size > builder->stack_capacity)
+    {
+        size_t stack_capacity = builder->stack_capacity == 0 ? 4096 : builder->stack_capacity;
+        while (stack_capacity < builder->stack_size + size)
+        {
+            stack_capacity *= 2;
+        }
+
+        char *stack = (char *) realloc(builder->stack, stack_capacity);
+        if (stack == NULL)
+        {
+            builder->failure = "out of memory";
+            return NULL;
+        }
+
+        builder->stack = stack;
+        builder->stack_capacity = stack_capacity;
+    }
+
+    void *memory = builder->stack + builder->stack_size;
+    builder->stack_size += size;
+
+    return memory;
+}
+
+/**
+ * \brief Helper function to add a value to the innermost open container, or make it the root of
+ * the document if no container is open
+ *
+ * \param[in] builder builder state
+ * \param[in] type type of the value
+ *
+ * \return the new value, its payload is not filled in yet. NULL if out of memory
+ */
+static json_value_t* json_builder_add(json_builder_t *builder, json_types_t type)
+{
+    json_value_t *value;
+    if (builder->depth == 0)
+    {
+        value = &builder->document->root;
+    } else if (builder->frames[builder->depth - 1].is_object)
+    {
+        json_object_entry_t *entry = (json_object_entry_t *) json_builder_push(builder, sizeof(json_object_entry_t));
+        if (entry == NULL) return NULL;
+
+        entry->key = builder->key;
+        entry->key_size = builder->key_size;
+        value = &entry->value;
+    } else
+    {
+        value = (json_value_t *) json_builder_push(builder, sizeof(json_value_t));
+        if (value == NULL) return NULL;
+    }
+
+    value->type = type;
+    value->flags = JSON_VALUE_ARENA;
+    value->size = 0;
+
+    return value;
+}
+
+/**
+ * \brief Helper function to open a container. Its members are collected on the scratch stack until
+ * it is closed, the key it is stored under is kept aside until then.
+ *
+ * \param[in] builder builder state
+ * \param[in] is_object true for an object, false for an array
+ *
+ * \return true if the container was opened, false if out of memory
+ */
+static bool json_builder_begin(json_builder_t *builder, bool is_object)
+{
+    if (builder->depth == builder->frames_capacity)
+    {
+        size_t frames_capacity = builder->frames_capacity == 0 ? 32 : builder->frames_capacity * 2;
+        json_builder_frame_t *frames = (json_builder_frame_t *) realloc(builder->frames, frames_capacity * sizeof(json_builder_frame_t));
+        if (frames == NULL)
+        {
+            builder->failure = "out of memory";
+            return false;
+        }
+
+        builder->frames = frames;
+        builder->frames_capacity = frames_capacity;
+    }
+
+    json_builder_frame_t *frame = &builder->frames[builder->depth++];
+    frame->stack_start = builder->stack_size;
+    frame->is_object = is_object;
+    frame->key = builder->key;
+    frame->key_size = builder->key_size;
+
+    return true;
+}
+
+/**
+ * \brief Callback opening an object, see json_builder_begin
+ */
+static bool json_builder_on_object_begin(void *user)
+{
+    return json_builder_begin((json_builder_t *) user, true);
+}
+
+/**
+ * \brief Callback opening an array, see json_builder_begin
+ */
+static bool json_builder_on_array_begin(void *user)
+{
+    return json_builder_begin((json_builder_t *) user, false);
+}
+
+/**
+ * \brief Callback storing the key of the next member. load_json hands the parser the document's
+ * arena, so keys already live in the document and are not copied again.
+ */
+static bool json_builder_on_key(void *user, const char *key, size_t size)
+{
+    json_builder_t *builder = (json_builder_t *) user;
+    builder->key = key;
+    builder->key_size = size;
+
+    return true;
+}
+
+/**
+ * \brief Callback closing an object: its members move from the scratch stack into one contiguous
+ * block in the arena, objects with at least JSON_OBJECT_INDEX_THRESHOLD members get a hash index.
+ */
+static bool json_builder_on_object_end(void *user, size_t size)
+{
+    json_builder_t *builder = (json_builder_t *) user;
+    json_arena_t *arena = &builder->document->arena;
+    json_builder_frame_t *frame = &builder->frames[--builder->depth];
+
+    json_object_t *json_object = (json_object_t *) json_arena_alloc(arena, sizeof(json_object_t));
+    json_object_entry_t *entries = size > 0 ? (json_object_entry_t *) json_arena_alloc(arena, size * sizeof(json_object_entry_t)) : NULL;
+    if (json_object == NULL || (entries == NULL && size > 0))
+    {
+        builder->failure = "out of memory";
+        return false;
+    }
+
+    json_object->size = size;
+    json_object->entries = entries;
+    if (size > 0) memcpy(entries, builder->stack + frame->stack_start, size * sizeof(json_object_entry_t));
+    builder->stack_size = frame->stack_start;
+
+    json_object->index = NULL;
+    json_object->index_mask = 0;
+    if (size >= JSON_OBJECT_INDEX_THRESHOLD)
+    {
+        size_t index_slots = json_object_index_slots(size);
+        uint32_t *index = (uint32_t *) json_arena_alloc(arena, index_slots * sizeof(uint32_t));
+        if (index == NULL)
+        {
+            builder->failure = "out of memory";
+            return false;
+        }
+        json_object_build_index(json_object, index, index_slots);
+    }
+
+    // the object is a member of its parent under the key it was opened with
+    builder->key = frame->key;
+    builder->key_size = frame->key_size;
+    json_value_t *json_value = json_builder_add(builder, JSON_OBJECT);
+    if (json_value == NULL) return false;
+
+    json_value->value.object = json_object;
+
+    return true;
+}
+
+/**
+ * \brief Callback closing an array: its elements move from the scratch stack into one contiguous
+ * block in the arena.
+ */
+static bool json_builder_on_array_end(void *user, size_t size)
+{
+    json_builder_t *builder = (json_builder_t *) user;
+    json_arena_t *arena = &builder->document->arena;
+    json_builder_frame_t *frame = &builder->frames[--builder->depth];
+
+    json_array_t *json_array = (json_array_t *) json_arena_alloc(arena, sizeof(json_array_t));
+    json_value_t *values = size > 0 ? (json_value_t *) json_arena_alloc(arena, size * sizeof(json_value_t)) : NULL;
+    if (json_array == NULL || (values == NULL && size > 0))
+    {
+        builder->failure = "out of memory";
+        return false;
+    }
+
+    json_array->size = size;
+    json_array->capacity = size;
+    json_array->values = values;
+    if (size > 0) memcpy(values, builder->stack + frame->stack_start, size * sizeof(json_value_t));
+    builder->stack_size = frame->stack_start;
+
+    builder->key = frame->key;
+    builder->key_size = frame->key_size;
+    json_value_t *json_value = json_builder_add(builder, JSON_ARRAY);
+    if (json_value == NULL) return false;
+
+    json_value->value.array = json_array;
+
+    return true;
+}
+
+/**
+ * \brief Callback adding a string, decoded by the parser straight into the document's arena
+ * (or in place for JSON_PARSE_INSITU) and null terminated there. Short strings move into their
+ * node and the arena space they were decoded into is handed back.
+ */
+static bool json_builder_on_string(void *user, const char *string, size_t size)
+{
+    json_builder_t *builder = (json_builder_t *) user;
+    json_value_t *json_value = json_builder_add(builder, JSON_STRING);
+    if (json_value == NULL) return false;
+    if (!json_string_set(json_value, string, size))
+    {
+        builder->failure = "string too long";
+        return false;
+    }
+
+    if (json_value->inline_size != 0) json_arena_unwind(&builder->document->arena, string, size + 1);
+
+    return true;
+}
+
+/**
+ * \brief Callback adding an integer
+ */
+static bool json_builder_on_int(void *user, long value)
+{
+    json_value_t *json_value = json_builder_add((json_builder_t *) user, JSON_INT);
+    if (json_value == NULL) return false;
+
+    json_value->value.integer = value;
+
+    return true;
+}
+
+/**
+ * \brief Callback adding a floating point value
+ */
+static bool json_builder_on_float(void *user, double value)
+{
+    json_value_t *json_value = json_builder_add((json_builder_t *) user, JSON_FLOAT);
+    if (json_value == NULL) return false;
+
+    json_value->value.floating = value;
+
+    return true;
+}
+
+/**
+ * \brief Callback adding a boolean
+ */
+static bool json_builder_on_bool(void *user, bool value)
+{
+    json_value_t *json_value = json_builder_add((json_builder_t *) user, JSON_BOOL);
+    if (json_value == NULL) return false;
+
+    json_value->value.boolean = value;
+
+    return true;
+}
+
+/**
+ * \brief Callback adding a null
+ */
+static bool json_builder_on_null(void *user)
+{
+    json_value_t *json_value = json_builder_add((json_builder_t *) user, JSON_NULL);
+    if (json_value == NULL) return false;
+
+    json_value->value.integer = JSON_NULL_VALUE;
+
+    return true;
+}
+
+/**
+ * \brief Callbacks of the DOM builder, load_json is a SAX parse with these
+ */
+static const json_sax_handler_t json_builder_handler = {
+    json_builder_on_object_begin,
+    json_builder_on_key,
+    json_builder_on_object_end,
+    json_builder_on_array_begin,
+    json_builder_on_array_end,
+    json_builder_on_string,
+    json_builder_on_int,
+    json_builder_on_float,
+    json_builder_on_bool,
+    json_builder_on_null
+};
+//===== END DOM BUILDER IMPLEMENTATION =====
+
+/**
+ * \brief json parser (deserializer) in jajson.h. Every node and string of the parsed document is
+ * bump allocated from an arena owned by the returned document, so the whole document is released
+ * by a single free_json call on the returned root.
+ *
+ * \param[in] json: null terminated input string that represents json data
+ *
+ * \returns json_value_t variable containing json data represented
+ * using jajson.h defined json structs, enums, and unions, NULL if json is malformed
+ */
+json_value_t* load_json(char *json)
+{
+    return load_json_ex(json, NULL);
+}
+
+/**
+ * \brief json parser (deserializer) in jajson.h taking parse options, see load_json
+ *
+ * \param[in] json: null terminated input string that represents json data
+ * \param[in] options: parse options, NULL for defaults
+ *
+ * \returns json_value_t variable containing json data represented
+ * using jajson.h defined json structs, enums, and unions, NULL if json is malformed
+ */
+json_value_t* load_json_ex(char *json, const json_parse_options_t *options)
+{
+    unsigned int flags = options != NULL ? options->flags : JSON_PARSE_DEFAULT;
+
+    return load_json_bounded(json, strlen(json), flags, options, NULL);
+}
+
+/**
+ * \brief json parser (deserializer) in jajson.h for input that is not null terminated, such as a
+ * slice of a network buffer or a mapped file. Nothing at or after json + size is read, unless
+ * options carry JSON_PARSE_PADDED: the caller then guarantees JSON_PADDING readable bytes after
+ * the input (their values do not matter) and the SIMD paths use full width loads up to the end.
+ * The input is never written to, JSON_PARSE_INSITU is ignored.
+ *
+ * \param[in] json: input that represents json data
+ * \param[in] size: length of the input in bytes
+ * \param[in] options: parse options, NULL for defaults
+ * \param[in] error: receives the reason and byte offset if the input is rejected, may be NULL
+ *
+ * \returns json_value_t variable containing json data represented
+ * using jajson.h defined json structs, enums, and unions, NULL if json is malformed
+ */
+json_value_t* load_json_n(const char *json, size_t size, const json_parse_options_t *options, json_parse_error_t *error)
+{
+    unsigned int flags = options != NULL ? options->flags : JSON_PARSE_DEFAULT;
+
+    // only in situ parsing writes to the input, so handing out a mutable pointer is fine without it
+    return load_json_bounded((char *) json, size, flags & ~(unsigned int) JSON_PARSE_INSITU, options, error);
+}
+
+/**
+ * \brief Helper function behind every load_json_* entry point, parses exactly size bytes of json
+ *
+ * \param[in] json: input that represents json data
+ * \param[in] size: length of the input in bytes
+ * \param[in] flags: json_parse_flags_t values or'ed together, used instead of the flags of options
+ * \param[in] options: parse options supplying the depth limit and intern table, NULL for defaults
+ * \param[in] error: receives the reason and byte offset if the input is rejected, may be NULL
+ *
+ * \returns parsed document, NULL if json is malformed or out of memory
+ */
+static json_value_t* load_json_bounded(char *json, size_t size, unsigned int flags, const json_parse_options_t *options, json_parse_error_t *error)
+{
+    json_document_t *document = (json_document_t *) malloc(sizeof(json_document_t));
+    if (document == NULL)
+    {
+        json_parse_error_t memory_error = { "out of memory", 0 };
+        if (error != NULL) *error = memory_error;
+        return NULL;
+    }
+    json_arena_init(&document->arena, JSON_ARENA_MIN_BLOCK_SIZE);
+
+    json_builder_t builder;
+    json_builder_init(&builder, document);
+
+    json_parser_t parser;
+    json_parser_init(&parser, json, size, flags, &json_builder_handler, &builder);
+    parser.arena = &document->arena; // strings are decoded straight into the document
+    parser.max_depth = json_parse_max_depth(options);
+
+    json_intern_t intern; // per-parse table, its keys live in the document like any other string
+    json_intern_init(&intern, &document->arena);
+    if (options != NULL && options->intern != NULL) parser.intern = options->intern;
+    else if (flags & JSON_PARSE_INTERN_KEYS) parser.intern = &intern;
+
+    bool parsed = json_parser_run(&parser, error);
+    if (!parsed && builder.failure != NULL && error != NULL) error->message = builder.failure;
+
+    free(builder.stack);
+    free(builder.frames);
+    free(intern.entries);
+
+    if (!parsed)
+    {
+        json_arena_free(&document->arena);
+        free(document);
+        return NULL;
+    }
+
+    document->root.flags = JSON_VALUE_DOCUMENT;
+
+    return &document->root;
+}
+
+/**
+ * \brief json parser (deserializer) in jajson.h that parses destructively. Strings and object keys
+ * are decoded in place and point straight into json instead of being copied into the document's
+ * arena, so json is modified and must outlive the returned document.
+ *
+ * \param[in] json: input string that represents json data, overwritten while parsing
+ *
+ * \returns json_value_t variable containing json data represented
+ * using jajson.h defined json structs, enums, and unions
+ */
+json_value_t* load_json_insitu(char *json)
+{
+    json_parse_options_t options = { JSON_PARSE_INSITU, 0, NULL };
+    return load_json_ex(json, &options);
+}
+
+/**
+ * \brief json parser (deserializer) in jajson.h reading straight from a file, see load_json_file_ex
+ *
+ * \param[in] path: path of the file holding json data
+ *
+ * \returns json_value_t variable containing json data represented
+ * using jajson.h defined json structs, enums, and unions, NULL if the file can not be read or is malformed
+ */
+json_value_t* load_json_file(const char *path)
+{
+    return load_json_file_ex(path, NULL, NULL);
+}
+
+/**
+ * \brief json parser (deserializer) in jajson.h reading straight from a file. Regular files are
+ * memory mapped read only and parsed in place through load_json_n, so the file is never copied into
+ * a heap buffer first. Pipes, character devices and systems without mmap fall back to buffered reads.
+ * The returned document does not reference the file, it is unmapped before returning.
+ *
+ * \param[in] path: path of the file holding json data
+ * \param[in] options: parse options, NULL for defaults (JSON_PARSE_INSITU is ignored)
+ * \param[in] error: receives the reason and byte offset if the file is rejected, may be NULL
+ *
+ * \returns json_value_t variable containing json data represented
+ * using jajson.h defined json structs, enums, and unions, NULL if the file can not be read or is malformed
+ */
+json_value_t* load_json_file_ex(const char *path, const json_parse_options_t *options, json_parse_error_t *error)
+{
+    json_parse_options_t file_options = { options != NULL ? options->flags : JSON_PARSE_DEFAULT, json_parse_max_depth(options), options != NULL ? options->intern : NULL };
+    file_options.flags &= ~(unsigned int) (JSON_PARSE_INSITU | JSON_PARSE_PADDED);
+
+    json_parse_error_t open_error = { "could not open file", 0 };
+    json_parse_error_t read_error = { "could not read file", 0 };
+    FILE *file = NULL;
+
+#if defined(JSON_HAS_MMAP)
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        if (error != NULL) *error = open_error;
+        return NULL;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0)
+    {
+        size_t size = (size_t) file_stat.st_size;
+        void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED)
+        {
+            close(fd);
+
+            // the input is read once front to back
+            madvise(mapping, size, MADV_SEQUENTIAL);
+#if defined(MADV_HUGEPAGE)
+            madvise(mapping, size, MADV_HUGEPAGE); // only a hint, fails quietly on file systems without huge page support
+#endif
+
+            // the rest of the last page reads as zeros, use it as padding when there is enough of it
+            size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+            size_t tail = size % page_size;
+            if (tail != 0 && page_size - tail >= JSON_PADDING) file_options.flags |= JSON_PARSE_PADDED;
+
+            json_value_t *json_parsed = load_json_n((const char *) mapping, size, &file_options, error);
+            munmap(mapping, size);
+
+            return json_parsed;
+        }
+    }
+
+    // pipes, sockets, empty or unmappable files are read through stdio
+    file = fdopen(fd, "rb");
+    if (file == NULL) close(fd);
+#else
+    file = fopen(path, "rb");
+#endif
+
+    if (file == NULL)
+    {
+        if (error != NULL) *error = open_error;
+        return NULL;
+    }
+
+    size_t size;
+    char *buffer = json_read_stream(file, &size);
+    fclose(file);
+
+    if (buffer == NULL)
+    {
+        if (error != NULL) *error = read_error;
+        return NULL;
+    }
+
+    // json_read_stream leaves JSON_PADDING bytes after the data
+    file_options.flags |= JSON_PARSE_PADDED;
+    json_value_t *json_parsed = load_json_n(buffer, size, &file_options, error);
+    free(buffer);
+
+    return json_parsed;
+}
+
+/**
+ * \brief Helper function to read a stream of unknown length into one growing buffer
+ *
+ * \param[in] file stream to read until its end
+ * \param[in] size address of a size that stores the number of bytes read
+ *
+ * \return buffer holding the data followed by JSON_PADDING zero bytes, NULL if reading failed
+ */
+static char* json_read_stream(FILE *file, size_t *size)
+{
+    size_t capacity = 1 << 16;
+    size_t used = 0;
+    char *buffer = (char *) malloc(capacity + JSON_PADDING);
+    if (buffer == NULL) return NULL;
+
+    for (;;)
+    {
+        used += fread(buffer + used, 1, capacity - used, file);
+        if (used < capacity) break; // end of stream or error
+
+        capacity *= 2;
+        char *grown = (char *) realloc(buffer, capacity + JSON_PADDING);
+        if (grown == NULL)
+        {
+            free(buffer);
+            return NULL;
+        }
+        buffer = grown;
+    }
+
+    if (ferror(file))
+    {
+        free(buffer);
+        return NULL;
+    }
+
+    memset(buffer + used, 0, JSON_PADDING);
+    *size = used;
+
+    return buffer;
+}
+
+/**
+ * \brief Function to free a json value. Documents returned by load_json release their whole arena
+ * in one pass, values built with build_json_* are freed node by node. Values that live inside
+ * a document are owned by it and are left untouched.
+ *
+ * \param[in] json_parsed json value to free
+ */
+void free_json(json_value_t *json_parsed) {
+    if (json_parsed->flags == JSON_VALUE_DOCUMENT) {
+        json_document_t *document = (json_document_t *) json_parsed; // root is the first member of its document
+        json_arena_free(&document->arena);
+        free(document);
+        return;
+    } else if (json_parsed->flags == JSON_VALUE_ARENA) {
+        return;
+    }
+
+    free_json_children(json_parsed);
+    free(json_parsed);
+}
+
+/**
+ * \brief Helper function to free everything a heap built json value owns, without freeing the
+ * value itself. Keys of objects are borrowed from the caller of build_json_object and are not freed.
+ *
+ * \param[in] json_parsed json value whose contents are freed
+ */
+static void free_json_children(json_value_t *json_parsed) {
+    if (json_parsed->type == JSON_ARRAY) {
+        json_array_t *json_array = json_parsed->value.array;
+        for (size_t i = 0; i < json_array->size; ++i) {
+            free_json_children(&json_array->values[i]);
+        }
+        free(json_array->values);
+        free(json_array);
+    } else if ( json_parsed->type == JSON_OBJECT) {
+        json_object_t *json_object = json_parsed->value.object;
+        for (size_t i = 0; i < json_object->size; ++i) {
+            free_json_children(&json_object->entries[i].value);
+        }
+        free(json_object->entries);
+        free(json_object->index);
+        free(json_object);
+    } else if (json_parsed->type == JSON_STRING && json_parsed->inline_size == 0) {
+        free((char *) json_parsed->value.string);
+    }
+}
+
+//===== LAZY JSON IMPLEMENTATION =====
+/**
+ * \brief Helper function to look at the first byte of a token of a lazy document
+ *
+ * \param[in] document lazy document holding the input and its structural index
+ * \param[in] token position in the structural index
+ *
+ * \return first byte of the token, '\0' for the sentinel at the end of the input
+ */
+static char json_lazy_char(json_lazy_t *document, size_t token)
+{
+    json_parser_t *parser = &document->parser;
+
+    return json_peek(parser, parser->input + parser->structurals[token]);
+}
+
+/**
+ * \brief Helper function to step over a value without decoding it. Scalars are a single token,
+ * containers are skipped by matching brackets over the structural index: bytes inside strings are
+ * never looked at, so a skipped subtree costs one pass over its tokens.
+ *
+ * NOTE: only the nesting is checked, a skipped subtree is not validated
+ *
+ * \param[in] document lazy document
+ * \param[in] token position of the first token of the value
+ *
+ * \return position of the first token after the value, JSON_LAZY_INVALID if the input ends first
+ */
+static size_t json_lazy_skip(json_lazy_t *document, size_t token)
+{
+    char c = json_lazy_char(document, token);
+    if (c != '{' && c != '[') return c != '\0' ? token + 1 : JSON_LAZY_INVALID;
+
+    size_t depth = 0;
+    for (;;)
+    {
+        switch (json_lazy_char(document, token++))
+        {
+            case '{':
+            case '[':
+                depth++;
+                break;
+
+            case '}':
+            case ']':
+                if (--depth == 0) return token;
+                break;
+
+            case '\0':
+                return JSON_LAZY_INVALID; // unbalanced brackets, the sentinel was reached
+
+            default:
+                break;
+        }
+    }
+}
+
+/**
+ * \brief Helper function to step from the key of an object member to its value
+ *
+ * \param[in] document lazy document
+ * \param[in] token position of the key
+ *
+ * \return position of the value, JSON_LAZY_INVALID if token is not followed by a colon
+ */
+static size_t json_lazy_member(json_lazy_t *document, size_t token)
+{
+    if (json_lazy_char(document, token) != '"' || json_lazy_char(document, token + 1) != ':') return JSON_LAZY_INVALID;
+
+    return token + 2;
+}
+
+/**
+ * \brief Helper function to find the first element of an array or the value of the first member
+ * of an object
+ *
+ * \param[in] document lazy document
+ * \param[in] token position of the opening bracket
+ *
+ * \return position of the first value, JSON_LAZY_INVALID if the container is empty or not a container
+ */
+static size_t json_lazy_first(json_lazy_t *document, size_t token)
+{
+    char c = json_lazy_char(document, token);
+    if (c == '[') return json_lazy_char(document, token + 1) != ']' ? token + 1 : JSON_LAZY_INVALID;
+    if (c == '{') return json_lazy_char(document, token + 1) != '}' ? json_lazy_member(document, token + 1) : JSON_LAZY_INVALID;
+
+    return JSON_LAZY_INVALID;
+}
+
+/**
+ * \brief Helper function to find the value after the one at token inside the same container. Values
+ * of object members are preceded by a colon, that is how the container type is told apart.
+ *
+ * \param[in] document lazy document
+ * \param[in] token position of a value inside an object or array
+ *
+ * \return position of the next value, JSON_LAZY_INVALID after the last one
+ */
+static size_t json_lazy_next(json_lazy_t *document, size_t token)
+{
+    if (token == 0) return JSON_LAZY_INVALID; // the root has no siblings
+
+    bool in_object = json_lazy_char(document, token - 1) == ':';
+    token = json_lazy_skip(document, token);
+    if (token == JSON_LAZY_INVALID || json_lazy_char(document, token) != ',') return JSON_LAZY_INVALID;
+
+    return in_object ? json_lazy_member(document, token + 1) : token + 1;
+}
+
+/**
+ * \brief Helper function to compare the key at token with key. Keys without escapes are compared
+ * where they are in the input, keys with escapes are decoded into the parser's scratch buffer.
+ *
+ * \param[in] document lazy document
+ * \param[in] token position of the key
+ * \param[in] key key to compare with
+ * \param[in] key_size length of key
+ *
+ * \return true if the decoded key equals key, false otherwise or if the key is malformed
+ */
+static bool json_lazy_key_equals(json_lazy_t *document, size_t token, const char *key, size_t key_size)
+{
+    json_parser_t *parser = &document->parser;
+    parser->error.message = NULL;
+
+    const char *string;
+    size_t size;
+    read_string(parser, parser->input + parser->structurals[token], &string, &size, '"');
+
+    return parser->error.message == NULL && size == key_size && memcmp(string, key, key_size) == 0;
+}
+
+/**
+ * \brief Callback recording that a number is an integer, see json_cursor_type
+ */
+static bool json_lazy_on_int(void *user, long value)
+{
+    (void) value;
+    *(json_types_t *) user = JSON_INT;
+
+    return true;
+}
+
+/**
+ * \brief Callback recording that a number is a floating point value, see json_cursor_type
+ */
+static bool json_lazy_on_float(void *user, double value)
+{
+    (void) value;
+    *(json_types_t *) user = JSON_FLOAT;
+
+    return true;
+}
+
+/**
+ * \brief Callbacks telling integers from floating point values, every other event is not needed
+ */
+static const json_sax_handler_t json_lazy_number_handler = {
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    json_lazy_on_int,
+    json_lazy_on_float,
+    NULL,
+    NULL
+};
+
+/**
+ * \brief Lazy json parser in jajson.h. Only runs the SIMD structural index stage over exactly size
+ * bytes of json and returns a document whose values are reached through cursors. Nothing is
+ * decoded until json_cursor_value is called on a cursor, subtrees that are stepped over on the
+ * way cost a bracket matching scan over their tokens. The input is borrowed, it must stay alive and
+ * unchanged until free_json_lazy. JSON_PARSE_PADDED works as for load_json_n, the structural index
+ * is always built and JSON_PARSE_INSITU is ignored.
+ *
+ * NOTE: only materialized values are validated, malformed input elsewhere in the document is not
+ * reported. Single quoted strings are not indexed, see json_build_structural_index.
+ *
+ * \param[in] json: input that represents json data
+ * \param[in] size: length of the input in bytes, must be below UINT32_MAX
+ * \param[in] options: parse options, NULL for defaults
+ * \param[in] error: receives the reason if the input can not be indexed, may be NULL
+ *
+ * \returns lazy document to be released with free_json_lazy, NULL if the input can not be indexed
+ */
+json_lazy_t* load_json_lazy(const char *json, size_t size, const json_parse_options_t *options, json_parse_error_t *error)
+{
+    unsigned int flags = options != NULL ? options->flags : JSON_PARSE_DEFAULT;
+    flags = (flags & ~(unsigned int) JSON_PARSE_INSITU) | JSON_PARSE_STRUCTURAL_INDEX;
+
+    json_lazy_t *document = (json_lazy_t *) malloc(sizeof(json_lazy_t));
+    if (document == NULL)
+    {
+        json_parse_error_t memory_error = { "out of memory", 0 };
+        if (error != NULL) *error = memory_error;
+        return NULL;
+    }
+
+    // the input is never written to without JSON_PARSE_INSITU
+    json_parser_init(&document->parser, (char *) json, size, flags, &json_builder_handler, &document->builder);
+    document->parser.max_depth = json_parse_max_depth(options);
+    if (document->parser.structurals == NULL)
+    {
+        json_parse_error_t index_error = { size < UINT32_MAX ? "out of memory" : "input too large for lazy parsing", 0 };
+        if (error != NULL) *error = index_error;
+        free(document);
+        return NULL;
+    }
+
+    json_arena_init(&document->document.arena, JSON_ARENA_MIN_BLOCK_SIZE);
+
+    json_builder_init(&document->builder, &document->document);
+
+    if (error != NULL)
+    {
+        error->message = NULL;
+        error->offset = 0;
+    }
+
+    return document;
+}
+
+/**
+ * \brief Function to free a lazy document together with every value materialized from it
+ *
+ * \param[in] document lazy document returned by load_json_lazy
+ */
+void free_json_lazy(json_lazy_t *document)
+{
+    json_arena_free(&document->document.arena);
+    free(document->builder.stack);
+    free(document->builder.frames);
+    free(document->parser.scratch);
+    free(document->parser.structurals);
+    free(document);
+}
+
+/**
+ * \brief Function to get a cursor to the root value of a lazy document
+ *
+ * \param[in] document lazy document returned by load_json_lazy
+ *
+ * \return cursor pointing at the root value
+ */
+json_cursor_t json_lazy_root(json_lazy_t *document)
+{
+    json_cursor_t cursor = { document, 0 };
+    return cursor;
+}
+
+/**
+ * \brief Function to get the type of the value behind a cursor without materializing it. Numbers
+ * are parsed to tell integers from floating point values the same way load_json does.
+ *
+ * \param[in] cursor cursor pointing at a value
+ * \param[in] type address of a type that stores the type of the value
+ *
+ * \return true if the type is known, false if the value is malformed
+ */
+bool json_cursor_type(json_cursor_t cursor, json_types_t *type)
+{
+    json_parser_t *parser = &cursor.document->parser;
+
+    switch (json_lazy_char(cursor.document, cursor.token))
+    {
+        case '{': *type = JSON_OBJECT; return true;
+        case '[': *type = JSON_ARRAY; return true;
+        case '"': *type = JSON_STRING; return true;
+        case 't':
+        case 'f': *type = JSON_BOOL; return true;
+        case 'n': *type = JSON_NULL; return true;
+        case '-':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+        {
+            const json_sax_handler_t *handler = parser->handler;
+            void *user = parser->user;
+            parser->handler = &json_lazy_number_handler;
+            parser->user = type;
+            parser->error.message = NULL;
+
+            read_json_number(parser, parser->input + parser->structurals[cursor.token]);
+
+            parser->handler = handler;
+            parser->user = user;
+            return parser->error.message == NULL;
+        }
+        default: return false;
+    }
+}
+
+/**
+ * \brief Function to find the member of an object behind a cursor without materializing it. Members
+ * are compared in document order, the values of members before it are skipped.
+ *
+ * \param[in] cursor cursor pointing at an object
+ * \param[in] key key to look for
+ * \param[in] key_size length of key, not counting a null termination character
+ * \param[in] out address of a cursor that stores the position of the member's value
+ *
+ * \return true if the member was found, false if it is missing or cursor is not an object
+ */
+bool json_cursor_object_get(json_cursor_t cursor, const char *key, size_t key_size, json_cursor_t *out)
+{
+    if (json_lazy_char(cursor.document, cursor.token) != '{') return false;
+
+    for (size_t token = json_lazy_first(cursor.document, cursor.token); token != JSON_LAZY_INVALID; token = json_lazy_next(cursor.document, token))
+    {
+        if (json_lazy_key_equals(cursor.document, token - 2, key, key_size))
+        {
+            out->document = cursor.document;
+            out->token = token;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * \brief Function to find the i-th element of an array behind a cursor without materializing it,
+ * the i elements before it are skipped
+ *
+ * \param[in] cursor cursor pointing at an array
+ * \param[in] i position of the element
+ * \param[in] out address of a cursor that stores the position of the element
+ *
+ * \return true if the element exists, false if i is out of bounds or cursor is not an array
+ */
+bool json_cursor_array_get(json_cursor_t cursor, size_t i, json_cursor_t *out)
+{
+    if (json_lazy_char(cursor.document, cursor.token) != '[') return false;
+
+    size_t token = json_lazy_first(cursor.document, cursor.token);
+    for (; token != JSON_LAZY_INVALID && i > 0; --i)
+    {
+        token = json_lazy_next(cursor.document, token);
+    }
+    if (token == JSON_LAZY_INVALID) return false;
+
+    out->document = cursor.document;
+    out->token = token;
+    return true;
+}
+
+/**
+ * \brief Function to count the members of an object or the elements of an array behind a cursor
+ *
+ * \param[in] cursor cursor pointing at an object or array
+ *
+ * \return number of values in the container, 0 for scalars
+ */
+size_t json_cursor_size(json_cursor_t cursor)
+{
+    size_t size = 0;
+    for (size_t token = json_lazy_first(cursor.document, cursor.token); token != JSON_LAZY_INVALID; token = json_lazy_next(cursor.document, token))
+    {
+        size++;
+    }
+
+    return size;
+}
+
+/**
+ * \brief Function to move to the first value inside an object or array. Together with
+ * json_cursor_next this walks a container in document order.
+ *
+ * \param[in] cursor cursor pointing at an object or array
+ * \param[in] out address of a cursor that stores the position of the first value
+ *
+ * \return true if the container has a value, false if it is empty or cursor is not a container
+ */
+bool json_cursor_child(json_cursor_t cursor, json_cursor_t *out)
+{
+    size_t token = json_lazy_first(cursor.document, cursor.token);
+    if (token == JSON_LAZY_INVALID) return false;
+
+    out->document = cursor.document;
+    out->token = token;
+    return true;
+}
+
+/**
+ * \brief Function to move a cursor to the next value of its object or array, skipping the value
+ * it points at
+ *
+ * \param[in] cursor cursor pointing at a value inside an object or array, moved in place
+ *
+ * \return true if the cursor was moved, false if it pointed at the last value
+ */
+bool json_cursor_next(json_cursor_t *cursor)
+{
+    size_t token = json_lazy_next(cursor->document, cursor->token);
+    if (token == JSON_LAZY_INVALID) return false;
+
+    cursor->token = token;
+    return true;
+}
+
+/**
+ * \brief Function to get the key of the object member a cursor points at. The key is decoded into
+ * the arena of the document on every call.
+ *
+ * \param[in] cursor cursor pointing at the value of an object member
+ * \param[in] size address of a size that stores the length of the key, may be NULL
+ *
+ * \return null terminated key, NULL if cursor does not point into an object or the key is malformed
+ */
+const char* json_cursor_key(json_cursor_t cursor, size_t *size)
+{
+    json_lazy_t *document = cursor.document;
+    json_parser_t *parser = &document->parser;
+    if (cursor.token < 2 || json_lazy_char(document, cursor.token - 1) != ':') return NULL;
+
+    const char *key;
+    size_t key_size;
+    parser->error.message = NULL;
+    parser->arena = &document->document.arena;
+    read_string(parser, parser->input + parser->structurals[cursor.token - 2], &key, &key_size, '"');
+    parser->arena = NULL;
+    if (parser->error.message != NULL) return NULL;
+
+    if (size != NULL) *size = key_size;
+    return key;
+}
+
+/**
+ * \brief Function to materialize the value behind a cursor. The value and everything below it is
+ * decoded by the recursive descent parser into the arena of the lazy document, so it looks exactly
+ * like the same value in a document returned by load_json. A root cursor also rejects anything but
+ * white space after the root value, as load_json does. Every call decodes again, keep the returned
+ * pointer instead of materializing the same cursor twice.
+ *
+ * \param[in] cursor cursor pointing at a value
+ * \param[in] error receives the reason and byte offset if the value is malformed, may be NULL
+ *
+ * \return materialized value owned by the lazy document (free_json leaves it alone), NULL if it is malformed
+ */
+json_value_t* json_cursor_value(json_cursor_t cursor, json_parse_error_t *error)
+{
+    json_lazy_t *document = cursor.document;
+    json_parser_t *parser = &document->parser;
+    json_builder_t *builder = &document->builder;
+
+    // a previous materialization may have stopped with containers still open
+    builder->stack_size = 0;
+    builder->depth = 0;
+    builder->key = NULL;
+    builder->key_size = 0;
+    builder->failure = NULL;
+
+    parser->error.message = NULL;
+    parser->error.offset = 0;
+    parser->structural_cursor = cursor.token;
+    parser->arena = &document->document.arena; // strings are decoded straight into the document
+    char *json = load_json_helper(parser, parser->input + parser->structurals[cursor.token]);
+    parser->arena = NULL;
+    if (builder->failure != NULL) parser->error.message = builder->failure;
+
+    if (parser->error.message == NULL)
+    {
+        // the value has to end at the next token or at white space, not in the middle of 1x or truex,
+        // and only white space may follow the root value
+        char *next = skip_white_space(parser, json);
+        if (next < parser->end && cursor.token == 0)
+        {
+            json_parser_fail(parser, next, "unexpected characters after the root value");
+        } else if (next < parser->end && (size_t) (next - parser->input) != parser->structurals[parser->structural_cursor])
+        {
+            json_parser_fail(parser, next, "unexpected characters after the value");
+        }
+    }
+
+    json_value_t *json_value = NULL;
+    if (parser->error.message == NULL)
+    {
+        json_value = (json_value_t *) json_arena_alloc(&document->document.arena, sizeof(json_value_t));
+        if (json_value == NULL) json_parser_fail(parser, json, "out of memory");
+    }
+
+    if (error != NULL) *error = parser->error;
+    if (parser->error.message != NULL) return NULL;
+
+    *json_value = document->document.root;
+
+    return json_value;
+}
+//===== END LAZY JSON IMPLEMENTATION =====
+
+//===== STREAM JSON IMPLEMENTATION =====
+/**
+ * \brief Callbacks of a stream for values above emit_depth, none of their events are reported
+ */
+static const json_sax_handler_t json_stream_skip_handler = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+
+/**
+ * \brief Helper function to set up a stream, see json_stream_init and json_stream_init_values
+ *
+ * \param[in] stream stream state to initialize
+ * \param[in] flags json_stream_flags_t values or'ed together
+ * \param[in] handler callbacks receiving the events
+ * \param[in] user pointer passed through to every callback
+ */
+static void json_stream_setup(json_stream_t *stream, unsigned int flags, const json_sax_handler_t *handler, void *user)
+{
+    json_parser_init(&stream->parser, NULL, 0, JSON_PARSE_DEFAULT, handler, user);
+    stream->handler = handler;
+    stream->user = user;
+    stream->flags = flags;
+    stream->state = JSON_STREAM_VALUE;
+    stream->frames = NULL;
+    stream->depth = 0;
+    stream->frames_capacity = 0;
+    stream->max_depth = JSON_MAX_DEPTH;
+    stream->token = JSON_STREAM_TOKEN_NONE;
+    stream->token_buffer = NULL;
+    stream->token_size = 0;
+    stream->token_capacity = 0;
+    stream->token_offset = 0;
+    stream->quote = '"';
+    stream->escaped = false;
+    stream->offset = 0;
+    stream->base = 0;
+    stream->emit_depth = 0;
+    stream->on_value = NULL;
+    stream->value_user = NULL;
+    json_builder_init(&stream->builder, NULL);
+    stream->error.message = NULL;
+    stream->error.offset = 0;
+}
+
+/**
+ * \brief Function to set up an incremental SAX parser. Every token is reported to handler as soon
+ * as the chunk completing it is fed, see json_sax_handler_t for the events and the lifetime of strings.
+ * Nesting deeper than JSON_MAX_DEPTH fails the stream, set stream->max_depth before the first chunk
+ * to change the limit.
+ *
+ * \param[in] stream stream state to initialize, released with json_stream_close
+ * \param[in] flags json_stream_flags_t values or'ed together
+ * \param[in] handler callbacks receiving the events
+ * \param[in] user pointer passed through to every callback
+ */
+void json_stream_init(json_stream_t *stream, unsigned int flags, const json_sax_handler_t *handler, void *user)
+{
+    json_stream_setup(stream, flags, handler, user);
+}
+
+/**
+ * \brief Function to set up an incremental parser handing out complete values. Every value nested
+ * depth containers deep is built as its own document and handed to on_value as soon as it closes, so
+ * memory stays bounded by the largest such value: depth 0 hands out root values (one per line of
+ * NDJSON with JSON_STREAM_MULTIPLE_VALUES), depth 1 the elements of a huge root array. Keys of handed
+ * out object members and values nested less deeply are not reported. The depth limit works as for
+ * json_stream_init.
+ *
+ * \param[in] stream stream state to initialize, released with json_stream_close
+ * \param[in] flags json_stream_flags_t values or'ed together
+ * \param[in] depth nesting depth of the values handed to on_value
+ * \param[in] on_value callback receiving the values
+ * \param[in] user pointer passed through to on_value
+ */
+void json_stream_init_values(json_stream_t *stream, unsigned int flags, size_t depth, json_stream_value_callback_t on_value, void *user)
+{
+    json_stream_setup(stream, flags, &json_builder_handler, &stream->builder);
+    stream->emit_depth = depth;
+    stream->on_value = on_value;
+    stream->value_user = user;
+}
+
+/**
+ * \brief Helper function to point the stream's parser at the buffer complete tokens are read from
+ *
+ * \param[in] stream stream state
+ * \param[in] buffer current chunk or token buffer
+ * \param[in] size length of buffer
+ * \param[in] base stream offset of the first byte of buffer
+ */
+static void json_stream_bind(json_stream_t *stream, char *buffer, size_t size, size_t base)
+{
+    stream->parser.input = buffer;
+    stream->parser.end = buffer + size;
+    stream->parser.readable_end = buffer + size;
+    stream->base = base;
+}
+
+/**
+ * \brief Helper function to record a stream error. Only the first error is kept.
+ *
+ * \param[in] stream stream state
+ * \param[in] offset stream offset the error was found at
+ * \param[in] message static description of the error
+ *
+ * \return false
+ */
+static bool json_stream_fail(json_stream_t *stream, size_t offset, const char *message)
+{
+    if (stream->error.message == NULL)
+    {
+        // a values stream whose builder failed reports why instead of the handler stopping it
+        stream->error.message = stream->builder.failure != NULL ? stream->builder.failure : message;
+        stream->error.offset = offset;
+    }
+
+    return false;
+}
+
+/**
+ * \brief Helper function to move an error of the stream's parser into the stream
+ *
+ * \param[in] stream stream state
+ *
+ * \return true if the parser did not fail, false otherwise
+ */
+static bool json_stream_check(json_stream_t *stream)
+{
+    json_parser_t *parser = &stream->parser;
+    if (parser->error.message == NULL) return true;
+
+    json_stream_fail(stream, stream->base + parser->error.offset, parser->error.message);
+    parser->error.message = NULL;
+
+    return false;
+}
+
+/**
+ * \brief Helper function to tell if events at the current depth are reported. For a values stream
+ * this also makes sure there is a document to build the next value into.
+ *
+ * \param[in] stream stream state
+ * \param[in] offset stream offset of the value
+ *
+ * \return true if the value starting at the current depth is reported, false if it is skipped or
+ * there is no memory for its document (the stream has failed then)
+ */
+static bool json_stream_forward(json_stream_t *stream, size_t offset)
+{
+    if (stream->depth < stream->emit_depth) return false;
+
+    if (stream->on_value != NULL && stream->builder.document == NULL)
+    {
+        json_document_t *document = (json_document_t *) malloc(sizeof(json_document_t));
+        if (document == NULL) return json_stream_fail(stream, offset, "out of memory");
+
+        json_arena_init(&document->arena, JSON_ARENA_MIN_BLOCK_SIZE);
+        stream->builder.document = document;
+    }
+
+    return true;
+}
+
+/**
+ * \brief Helper function called whenever a value is complete. Counts it as a member of its container
+ * and hands it out if it is a value the stream was set up to hand out.
+ *
+ * \param[in] stream stream state
+ * \param[in] offset stream offset right after the value
+ *
+ * \return true to keep parsing, false if the callback stopped the stream
+ */
+static bool json_stream_complete(json_stream_t *stream, size_t offset)
+{
+    if (stream->depth == 0)
+    {
+        stream->state = JSON_STREAM_DONE;
+    } else
+    {
+        stream->frames[stream->depth - 1].size++;
+        stream->state = JSON_STREAM_COMMA_OR_END;
+    }
+
+    if (stream->on_value != NULL && stream->depth == stream->emit_depth)
+    {
+        json_document_t *document = stream->builder.document;
+        stream->builder.document = NULL;
+        document->root.flags = JSON_VALUE_DOCUMENT;
+
+        if (!stream->on_value(stream->value_user, &document->root)) return json_stream_fail(stream, offset, "stopped by handler");
+    }
+
+    return true;
+}
+
+/**
+ * \brief Helper function to open an object or array
+ *
+ * \param[in] stream stream state
+ * \param[in] is_object true for an object, false for an array
+ * \param[in] offset stream offset of the opening bracket
+ *
+ * \return true to keep parsing, false if the container nests too deep, out of memory or a callback
+ * stopped the stream
+ */
+static bool json_stream_begin(json_stream_t *stream, bool is_object, size_t offset)
+{
+    if (stream->depth >= stream->max_depth) return json_stream_fail(stream, offset, "nesting too deep");
+
+    if (json_stream_forward(stream, offset))
+    {
+        bool (*on_begin)(void *) = is_object ? stream->handler->on_object_begin : stream->handler->on_array_begin;
+        if (on_begin != NULL && !on_begin(stream->user)) return json_stream_fail(stream, offset, "stopped by handler");
+    }
+    if (stream->error.message != NULL) return false;
+
+    if (stream->depth == stream->frames_capacity)
+    {
+        size_t frames_capacity = stream->frames_capacity == 0 ? 32 : stream->frames_capacity * 2;
+        json_stream_frame_t *frames = (json_stream_frame_t *) realloc(stream->frames, frames_capacity * sizeof(json_stream_frame_t));
+        if (frames == NULL) return json_stream_fail(stream, offset, "out of memory");
+
+        stream->frames = frames;
+        stream->frames_capacity = frames_capacity;
+    }
+
+    json_stream_frame_t *frame = &stream->frames[stream->depth++];
+    frame->size = 0;
+    frame->is_object = is_object;
+    stream->state = is_object ? JSON_STREAM_KEY_OR_END : JSON_STREAM_VALUE_OR_END;
+
+    return true;
+}
+
+/**
+ * \brief Helper function to close the innermost container
+ *
+ * \param[in] stream stream state
+ * \param[in] offset stream offset of the closing bracket
+ *
+ * \return true to keep parsing, false if a callback stopped the stream
+ */
+static bool json_stream_end(json_stream_t *stream, size_t offset)
+{
+    json_stream_frame_t frame = stream->frames[--stream->depth];
+    if (stream->depth >= stream->emit_depth)
+    {
+        bool (*on_end)(void *, size_t) = frame.is_object ? stream->handler->on_object_end : stream->handler->on_array_end;
+        if (on_end != NULL && !on_end(stream->user, frame.size)) return json_stream_fail(stream, offset, "stopped by handler");
+    }
+
+    return json_stream_complete(stream, offset + 1);
+}
+
+/**
+ * \brief Helper function to report a complete string, number or literal through the recursive
+ * descent parser
+ *
+ * \param[in] stream stream state, its parser points at the buffer holding the token
+ * \param[in] start first byte of the token
+ * \param[in] stop end of the token, the parser has to consume exactly the bytes up to here
+ *
+ * \return true to keep parsing, false if the token is malformed or a callback stopped the stream
+ */
+static bool json_stream_value(json_stream_t *stream, char *start, char *stop)
+{
+    json_parser_t *parser = &stream->parser;
+    bool forward = json_stream_forward(stream, stream->base + (size_t) (start - parser->input));
+    if (stream->error.message != NULL) return false;
+
+    parser->handler = forward ? stream->handler : &json_stream_skip_handler;
+    parser->arena = forward && stream->on_value != NULL ? &stream->builder.document->arena : NULL;
+
+    char *json = load_json_helper(parser, start);
+    if (parser->error.message == NULL && json != stop)
+    {
+        // the token runs on past its value, reported the way the parser reports what follows a value
+        const char *message = "unexpected characters after the root value";
+        if (stream->depth > 0) message = stream->frames[stream->depth - 1].is_object ? "expected ',' or '}' in object" : "expected ',' or ']' in array";
+        json_parser_fail(parser, json, message);
+    }
+    if (!json_stream_check(stream)) return false;
+
+    return json_stream_complete(stream, stream->base + (size_t) (stop - parser->input));
+}
+
+/**
+ * \brief Helper function to report a complete object key
+ *
+ * \param[in] stream stream state, its parser points at the buffer holding the key
+ * \param[in] start opening quote of the key
+ *
+ * \return true to keep parsing, false if the key is malformed or a callback stopped the stream
+ */
+static bool json_stream_key(json_stream_t *stream, char *start)
+{
+    json_parser_t *parser = &stream->parser;
+    bool forward = stream->depth > stream->emit_depth; // keys of handed out values are dropped
+    parser->arena = forward && stream->on_value != NULL ? &stream->builder.document->arena : NULL;
+
+    const char *key;
+    size_t key_size;
+    char *json = read_string(parser, start, &key, &key_size, *start);
+    if (!json_stream_check(stream)) return false;
+
+    if (forward && stream->handler->on_key != NULL && !stream->handler->on_key(stream->user, key, key_size))
+    {
+        return json_stream_fail(stream, stream->base + (size_t) (json - parser->input), "stopped by handler");
+    }
+    stream->state = JSON_STREAM_COLON;
+
+    return true;
+}
+
+/**
+ * \brief Helper function to find the closing quote of a string, carrying a trailing backslash over
+ * to the next chunk
+ *
+ * \param[in] stream stream state holding the quote style, its parser points at the current chunk
+ * \param[in] in first byte to scan
+ * \param[in] end end of the current chunk
+ *
+ * \return closing quote, NULL if the string goes on in the next chunk
+ */
+static char* json_stream_string_end(json_stream_t *stream, char *in, char *end)
+{
+    if (stream->escaped)
+    {
+        if (in == end) return NULL;
+        stream->escaped = false;
+        in++;
+    }
+
+    for (;;)
+    {
+        in = json_find_quote_or_backslash(&stream->parser, in, stream->quote);
+        if (in >= end) return NULL;
+        if (*in == stream->quote) return in;
+
+        // step over the escaped byte, the escape itself is decoded once the string is complete
+        if (++in == end)
+        {
+            stream->escaped = true;
+            return NULL;
+        }
+        in++;
+    }
+}
+
+/**
+ * \brief Helper function to find the end of a number or literal
+ *
+ * \param[in] in first byte to scan
+ * \param[in] end end of the current chunk
+ *
+ * \return first byte after the token, end if the token may go on in the next chunk
+ */
+static char* json_stream_scalar_end(char *in, char *end)
+{
+    while (in < end)
+    {
+        switch (*in)
+        {
+            case ' ': case '\t': case '\n': case '\r':
+            case '{': case '}': case '[': case ']': case ':': case ',':
+            case '"': case '\'':
+                return in;
+            default:
+                in++;
+        }
+    }
+
+    return end;
+}
+
+/**
+ * \brief Helper function to append bytes of a split token to the token buffer
+ *
+ * \param[in] stream stream state
+ * \param[in] data bytes to append
+ * \param[in] size number of bytes
+ *
+ * \return true if the bytes were appended, false if out of memory
+ */
+static bool json_stream_append(json_stream_t *stream, const char *data, size_t size)
+{
+    if (stream->token_size + size > stream->token_capacity)
+    {
+        size_t token_capacity = stream->token_capacity == 0 ? 256 : stream->token_capacity;
+        while (token_capacity < stream->token_size + size)
+        {
+            token_capacity *= 2;
+        }
+
+        char *token_buffer = (char *) realloc(stream->token_buffer, token_capacity);
+        if (token_buffer == NULL) return json_stream_fail(stream, stream->token_offset, "out of memory");
+
+        stream->token_buffer = token_buffer;
+        stream->token_capacity = token_capacity;
+    }
+
+    memcpy(stream->token_buffer + stream->token_size, data, size);
+    stream->token_size += size;
+
+    return true;
+}
+
+/**
+ * \brief Helper function to hold back a token the current chunk ends in
+ *
+ * \param[in] stream stream state
+ * \param[in] token kind of the token
+ * \param[in] in first byte of the token
+ * \param[in] end end of the current chunk
+ *
+ * \return end of the current chunk, NULL if out of memory
+ */
+static char* json_stream_hold(json_stream_t *stream, json_stream_token_t token, char *in, char *end)
+{
+    stream->token = token;
+    stream->token_size = 0;
+    stream->token_offset = stream->base + (size_t) (in - stream->parser.input);
+
+    return json_stream_append(stream, in, (size_t) (end - in)) ? end : NULL;
+}
+
+/**
+ * \brief Helper function to read a string value or key starting in the current chunk. Strings
+ * closed within the chunk are read straight from it, others are held back.
+ *
+ * \param[in] stream stream state
+ * \param[in] in opening quote
+ * \param[in] end end of the current chunk
+ * \param[in] token JSON_STREAM_TOKEN_STRING or JSON_STREAM_TOKEN_KEY
+ *
+ * \return first byte after the string, NULL on error
+ */
+static char* json_stream_string(json_stream_t *stream, char *in, char *end, json_stream_token_t token)
+{
+    stream->quote = *in;
+    stream->escaped = false;
+
+    char *close = json_stream_string_end(stream, in + 1, end);
+    if (close == NULL) return json_stream_hold(stream, token, in, end);
+
+    bool parsed = token == JSON_STREAM_TOKEN_KEY ? json_stream_key(stream, in) : json_stream_value(stream, in, close + 1);
+
+    return parsed ? close + 1 : NULL;
+}
+
+/**
+ * \brief Helper function to read a value starting in the current chunk
+ *
+ * \param[in] stream stream state
+ * \param[in] in first byte of the value
+ * \param[in] end end of the current chunk
+ *
+ * \return first byte after the token read, NULL on error
+ */
+static char* json_stream_start_value(json_stream_t *stream, char *in, char *end)
+{
+    size_t offset = stream->base + (size_t) (in - stream->parser.input);
+
+    switch (*in)
+    {
+        case '{':
+            return json_stream_begin(stream, true, offset) ? in + 1 : NULL;
+
+        case '[':
+            return json_stream_begin(stream, false, offset) ? in + 1 : NULL;
+
+        case '"':
+        case '\'':
+            return json_stream_string(stream, in, end, JSON_STREAM_TOKEN_STRING);
+
+        case '}':
+        case ']':
+        case ':':
+        case ',':
+            json_stream_fail(stream, offset, "unexpected character");
+            return NULL;
+
+        default:
+        {
+            // numbers and literals end at the next delimiter, which may only come with the next chunk
+            char *stop = json_stream_scalar_end(in, end);
+            if (stop == end) return json_stream_hold(stream, JSON_STREAM_TOKEN_SCALAR, in, end);
+
+            return json_stream_value(stream, in, stop) ? stop : NULL;
+        }
+    }
+}
+
+/**
+ * \brief Helper function to consume the token starting at in, driven by what the stream expects
+ *
+ * \param[in] stream stream state
+ * \param[in] in first byte of the token, not white space
+ * \param[in] end end of the current chunk
+ *
+ * \return first byte after the token, NULL on error
+ */
+static char* json_stream_step(json_stream_t *stream, char *in, char *end)
+{
+    size_t offset = stream->base + (size_t) (in - stream->parser.input);
+    char c = *in;
+
+    switch (stream->state)
+    {
+        case JSON_STREAM_DONE:
+            if (!(stream->flags & JSON_STREAM_MULTIPLE_VALUES))
+            {
+                json_stream_fail(stream, offset, "unexpected characters after the root value");
+                return NULL;
+            }
+            return json_stream_start_value(stream, in, end);
+
+        case JSON_STREAM_VALUE:
+            return json_stream_start_value(stream, in, end);
+
+        case JSON_STREAM_VALUE_OR_END:
+            if (c == ']') return json_stream_end(stream, offset) ? in + 1 : NULL;
+            return json_stream_start_value(stream, in, end);
+
+        case JSON_STREAM_KEY_OR_END:
+            if (c == '}') return json_stream_end(stream, offset) ? in + 1 : NULL;
+            if (c != '"' && c != '\'')
+            {
+                json_stream_fail(stream, offset, "expected a string key");
+                return NULL;
+            }
+            return json_stream_string(stream, in, end, JSON_STREAM_TOKEN_KEY);
+
+        case JSON_STREAM_COLON:
+            if (c != ':')
+            {
+                json_stream_fail(stream, offset, "expected ':' after object key");
+                return NULL;
+            }
+            stream->state = JSON_STREAM_VALUE;
+            return in + 1;
+
+        case JSON_STREAM_COMMA_OR_END:
+        default:
+        {
+            bool is_object = stream->frames[stream->depth - 1].is_object;
+            if (c == ',')
+            {
+                stream->state = is_object ? JSON_STREAM_KEY_OR_END : JSON_STREAM_VALUE_OR_END;
+                return in + 1;
+            }
+            if (c == (is_object ? '}' : ']')) return json_stream_end(stream, offset) ? in + 1 : NULL;
+
+            json_stream_fail(stream, offset, is_object ? "expected ',' or '}' in object" : "expected ',' or ']' in array");
+            return NULL;
+        }
+    }
+}
+
+/**
+ * \brief Helper function to parse a held back token once it is complete
+ *
+ * \param[in] stream stream state
+ *
+ * \return true to keep parsing, false if the token is malformed or a callback stopped the stream
+ */
+static bool json_stream_release(json_stream_t *stream)
+{
+    json_parser_t *parser = &stream->parser;
+    char *input = parser->input;
+    size_t size = (size_t) (parser->end - input);
+    size_t base = stream->base;
+
+    json_stream_token_t token = stream->token;
+    stream->token = JSON_STREAM_TOKEN_NONE;
+
+    json_stream_bind(stream, stream->token_buffer, stream->token_size, stream->token_offset);
+    bool parsed = token == JSON_STREAM_TOKEN_KEY ? json_stream_key(stream, stream->token_buffer)
+        : json_stream_value(stream, stream->token_buffer, stream->token_buffer + stream->token_size);
+    json_stream_bind(stream, input, size, base);
+
+    return parsed;
+}
+
+/**
+ * \brief Helper function to continue a token held back by the previous chunk
+ *
+ * \param[in] stream stream state
+ * \param[in] in start of the current chunk
+ * \param[in] end end of the current chunk
+ *
+ * \return first byte after the token, end if it goes on in the next chunk, NULL on error
+ */
+static char* json_stream_resume(json_stream_t *stream, char *in, char *end)
+{
+    char *stop;
+    if (stream->token == JSON_STREAM_TOKEN_SCALAR)
+    {
+        stop = json_stream_scalar_end(in, end);
+        if (!json_stream_append(stream, in, (size_t) (stop - in))) return NULL;
+        if (stop == end) return end;
+    } else
+    {
+        char *close = json_stream_string_end(stream, in, end);
+        stop = close != NULL ? close + 1 : end;
+        if (!json_stream_append(stream, in, (size_t) (stop - in))) return NULL;
+        if (close == NULL) return end;
+    }
+
+    return json_stream_release(stream) ? stop : NULL;
+}
+
+/**
+ * \brief Function to feed the next chunk of input to an incremental parser. Chunks may be cut
+ * anywhere, even inside a string, an escape or a number: the cut token is copied aside and finished
+ * by a later chunk, everything else is parsed straight from the chunk. Events are delivered before
+ * this returns, the chunk is not referenced afterwards.
+ *
+ * \param[in] stream stream set up with json_stream_init or json_stream_init_values
+ * \param[in] chunk next bytes of input
+ * \param[in] size length of chunk
+ *
+ * \return true if the input so far is valid, false once the stream found an error or was stopped
+ */
+bool json_stream_feed(json_stream_t *stream, const char *chunk, size_t size)
+{
+    if (stream->error.message != NULL) return false;
+
+    // the input is never written to without JSON_PARSE_INSITU
+    char *in = (char *) chunk;
+    char *end = in + size;
+    json_stream_bind(stream, in, size, stream->offset);
+
+    if (stream->token != JSON_STREAM_TOKEN_NONE) in = json_stream_resume(stream, in, end);
+
+    while (in != NULL && in < end)
+    {
+        if (*in == ' ' || *in == '\t' || *in == '\n' || *in == '\r')
+        {
+            in++;
+            continue;
+        }
+
+        in = json_stream_step(stream, in, end);
+    }
+
+    stream->offset += size;
+
+    return stream->error.message == NULL;
+}
+
+/**
+ * \brief Function to end the input of an incremental parser and release its memory. A number or
+ * literal held back by the last chunk is parsed now; anything else left open is an error.
+ *
+ * \param[in] stream stream to close
+ * \param[in] error receives the reason and byte offset if the input is rejected, may be NULL
+ *
+ * \return true if the input was complete and valid, false otherwise
+ */
+bool json_stream_close(json_stream_t *stream, json_parse_error_t *error)
+{
+    if (stream->error.message == NULL)
+    {
+        json_stream_bind(stream, NULL, 0, stream->offset);
+
+        if (stream->token == JSON_STREAM_TOKEN_SCALAR)
+        {
+            json_stream_release(stream);
+        } else if (stream->token != JSON_STREAM_TOKEN_NONE)
+        {
+            json_stream_fail(stream, stream->offset, "unterminated string");
+        }
+
+        if (stream->error.message == NULL && stream->depth > 0 && (stream->state == JSON_STREAM_VALUE || stream->state == JSON_STREAM_VALUE_OR_END))
+        {
+            json_stream_fail(stream, stream->offset, "unexpected end of input");
+        } else if (stream->error.message == NULL && stream->state == JSON_STREAM_COLON)
+        {
+            json_stream_fail(stream, stream->offset, "expected ':' after object key");
+        } else if (stream->error.message == NULL && stream->depth > 0)
+        {
+            json_stream_fail(stream, stream->offset, stream->frames[stream->depth - 1].is_object ? "unterminated object" : "unterminated array");
+        } else if (stream->error.message == NULL && stream->state != JSON_STREAM_DONE && !(stream->flags & JSON_STREAM_MULTIPLE_VALUES))
+        {
+            json_stream_fail(stream, stream->offset, "unexpected end of input");
+        }
+    }
+
+    // a value that was still being built is dropped
+    if (stream->builder.document != NULL)
+    {
+        json_arena_free(&stream->builder.document->arena);
+        free(stream->builder.document);
+    }
+    free(stream->builder.stack);
+    free(stream->builder.frames);
+    free(stream->frames);
+    free(stream->token_buffer);
+    free(stream->parser.scratch);
+
+    if (error != NULL) *error = stream->error;
+
+    return stream->error.message == NULL;
+}
+//===== END STREAM JSON IMPLEMENTATION =====
+
+//===== LINES JSON IMPLEMENTATION =====
+/**
+ * \brief Helper function to find the line feeds in 64 bytes of input
+ *
+ * \param[in] in 64 readable bytes of input
+ *
+ * \return bit mask with bit i set if byte i is a line feed
+ */
+static uint64_t json_newline_bits(const char *in)
+{
+#if defined(JSON_SIMD_AVX2)
+    uint64_t low = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *) in), _mm256_set1_epi8('\n')));
+    uint64_t high = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *) (in + 32)), _mm256_set1_epi8('\n')));
+    return low | (high << 32);
+#elif defined(JSON_SIMD_SSE2)
+    uint64_t bits = 0;
+    for (int i = 0; i < 64; i += 16)
+    {
+        bits |= (uint64_t) (uint16_t) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) (in + i)), _mm_set1_epi8('\n'))) << i;
+    }
+    return bits;
+#else
+    uint64_t bits = 0;
+    for (int i = 0; i < 64; ++i)
+    {
+        if (in[i] == '\n') bits |= (uint64_t) 1 << i;
+    }
+    return bits;
+#endif
+}
+
+/**
+ * \brief Helper function to record the line from start to end as a record, unless it is blank
+ *
+ * \param[in] json input string
+ * \param[in] start offset of the first byte of the line
+ * \param[in] end offset of the line feed ending the line
+ * \param[in] records start and end offsets of the records found so far, grown as needed
+ * \param[in] count number of records found so far
+ * \param[in] capacity number of records records has room for
+ *
+ * \return false if out of memory, true otherwise
+ */
+static bool json_lines_add(const char *json, size_t start, size_t end, size_t **records, size_t *count, size_t *capacity)
+{
+    while (start < end && (json[start] == ' ' || json[start] == '\t' || json[start] == '\r'))
+    {
+        start++;
+    }
+    if (start == end) return true;
+
+    if (*count == *capacity)
+    {
+        *capacity *= 2;
+        size_t *grown = (size_t *) realloc(*records, *capacity * 2 * sizeof(size_t));
+        if (grown == NULL) return false;
+        *records = grown;
+    }
+
+    (*records)[2 * *count] = start;
+    (*records)[2 * *count + 1] = end;
+    (*count)++;
+
+    return true;
+}
+
+/**
+ * \brief Helper function to split NDJSON into records. Classifies the input 64 bytes at a time like
+ * the structural index does, so line feeds inside strings (not valid json, but tolerated by the
+ * parser) do not end a record. Blank lines are skipped.
+ *
+ * NOTE: only double quoted strings are tracked, see json_build_structural_index
+ *
+ * \param[in] json input string
+ * \param[in] size length of input
+ * \param[in] padded true if JSON_PADDING bytes after the input may be read
+ * \param[in] count address of a size that stores the number of records
+ *
+ * \return start and end offset of every record, NULL if out of memory
+ */
+static size_t* json_lines_split(const char *json, size_t size, bool padded, size_t *count)
+{
+    size_t capacity = 1024;
+    size_t *records = (size_t *) malloc(capacity * 2 * sizeof(size_t));
+    if (records == NULL) return NULL;
+    *count = 0;
+
+    uint64_t prev_escaped = 0;
+    uint64_t prev_in_string = 0;
+    size_t line_start = 0;
+
+    char tail[64];
+    for (size_t offset = 0; offset < size; offset += 64)
+    {
+        const char *in = json + offset;
+        uint64_t valid = ~(uint64_t) 0;
+        if (size - offset < 64)
+        {
+            valid = ((uint64_t) 1 << (size - offset)) - 1;
+            if (!padded)
+            {
+                memset(tail, ' ', sizeof(tail));
+                memcpy(tail, in, size - offset);
+                in = tail;
+            }
+        }
+
+        json_block_t block;
+        json_classify_block(in, &block);
+
+        uint64_t escaped = json_escaped_bits(block.backslash & valid, &prev_escaped);
+        uint64_t quote = block.quote & valid & ~escaped;
+        uint64_t in_string = json_prefix_xor(quote) ^ prev_in_string;
+        prev_in_string = (uint64_t) ((int64_t) in_string >> 63);
+
+        uint64_t newline = json_newline_bits(in) & valid & ~in_string;
+        while (newline != 0)
+        {
+            size_t line_end = offset + (size_t) json_ctz64(newline);
+            if (!json_lines_add(json, line_start, line_end, &records, count, &capacity))
+            {
+                free(records);
+                return NULL;
+            }
+            line_start = line_end + 1;
+            newline &= newline - 1;
+        }
+    }
+
+    // the last line does not need a line feed
+    if (!json_lines_add(json, line_start, size, &records, count, &capacity))
+    {
+        free(records);
+        return NULL;
+    }
+
+    return records;
+}
+
+/**
+ * \brief Helper function to claim the next batch of records for a worker
+ *
+ * \param[in] job shared work
+ *
+ * \return index of the first record of the batch, record_count or more if there is nothing left
+ */
+static size_t json_lines_claim(json_lines_job_t *job)
+{
+#if defined(JSON_HAS_THREADS)
+    return __atomic_fetch_add(&job->next_record, JSON_LINES_BATCH, __ATOMIC_RELAXED);
+#else
+    size_t first = job->next_record;
+    job->next_record += JSON_LINES_BATCH;
+    return first;
+#endif
+}
+
+/**
+ * \brief Helper function to lower the index of the first malformed record. Batches after it are not
+ * parsed anymore, batches before it still are so the reported error does not depend on timing.
+ *
+ * \param[in] job shared work
+ * \param[in] record index of a malformed record
+ */
+static void json_lines_fail(json_lines_job_t *job, size_t record)
+{
+#if defined(JSON_HAS_THREADS)
+    size_t failed = __atomic_load_n(&job->failed, __ATOMIC_RELAXED);
+    while (record < failed && !__atomic_compare_exchange_n(&job->failed, &failed, record, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+#else
+    if (record < job->failed) job->failed = record;
+#endif
+}
+
+/**
+ * \brief Helper function to parse record i of a job into the worker's arena
+ *
+ * \param[in] worker worker state owning the arena
+ * \param[in] builder DOM builder of the worker
+ * \param[in] i index of the record
+ * \param[in] error receives the reason and the offset into the whole input if the record is malformed
+ *
+ * \return true if the record was parsed and stored at values[i], false if it is malformed
+ */
+static bool json_lines_parse(json_lines_worker_t *worker, json_builder_t *builder, size_t i, json_parse_error_t *error)
+{
+    json_lines_job_t *job = worker->job;
+    size_t start = job->records[2 * i];
+    size_t end = job->records[2 * i + 1];
+
+    builder->stack_size = 0;
+    builder->depth = 0;
+    builder->key = NULL;
+    builder->key_size = 0;
+    builder->failure = NULL;
+
+    json_parser_t parser;
+    if (job->structurals != NULL)
+    {
+        // elements of one document share its structural index, so positions stay relative to the whole input
+        json_parser_init(&parser, (char *) job->json, end, job->flags & ~(unsigned int) JSON_PARSE_STRUCTURAL_INDEX, &json_builder_handler, builder);
+        parser.readable_end = job->json + job->size + ((job->flags & JSON_PARSE_PADDED) ? JSON_PADDING : 0);
+        parser.structurals = (uint32_t *) job->structurals;
+        parser.structural_cursor = job->tokens[i];
+        parser.arena = &worker->document.arena;
+        parser.max_depth = job->max_depth;
+        if (job->flags & JSON_PARSE_INTERN_KEYS) parser.intern = &worker->intern;
+
+        char *json = skip_white_space(&parser, load_json_helper(&parser, (char *) job->json + start));
+        if (json < parser.end) json_parser_fail(&parser, json, "unexpected characters after the element");
+
+        free(parser.scratch);
+        *error = parser.error;
+    } else
+    {
+        // the records after this one are readable padding
+        unsigned int flags = job->flags;
+        if (end + JSON_PADDING <= job->size) flags |= JSON_PARSE_PADDED;
+
+        json_parser_init(&parser, (char *) job->json + start, end - start, flags, &json_builder_handler, builder);
+        parser.arena = &worker->document.arena;
+        parser.max_depth = job->max_depth;
+        if (job->flags & JSON_PARSE_INTERN_KEYS) parser.intern = &worker->intern;
+
+        json_parser_run(&parser, error);
+        error->offset += start;
+    }
+
+    if (error->message != NULL && builder->failure != NULL) error->message = builder->failure;
+    if (error->message != NULL) return false;
+
+    job->values[i] = worker->document.root;
+    return true;
+}
+
+/**
+ * \brief Helper function run by every worker of a job. Claims batches of records until none are left
+ * and parses them into the worker's arena, the root of record i is stored at values[i].
+ *
+ * \param[in] argument worker state
+ *
+ * \return NULL
+ */
+static void* json_lines_work(void *argument)
+{
+    json_lines_worker_t *worker = (json_lines_worker_t *) argument;
+    json_lines_job_t *job = worker->job;
+
+    json_builder_t builder;
+    json_builder_init(&builder, &worker->document);
+
+    for (;;)
+    {
+        size_t first = json_lines_claim(job);
+#if defined(JSON_HAS_THREADS)
+        size_t failed = __atomic_load_n(&job->failed, __ATOMIC_RELAXED);
+#else
+        size_t failed = job->failed;
+#endif
+        if (first >= job->record_count || first > failed) break;
+
+        size_t last = first + JSON_LINES_BATCH < job->record_count ? first + JSON_LINES_BATCH : job->record_count;
+        for (size_t i = first; i < last; ++i)
+        {
+            json_parse_error_t error;
+            if (!json_lines_parse(worker, &builder, i, &error))
+            {
+                if (i < worker->error_record)
+                {
+                    worker->error_record = i;
+                    worker->error = error;
+                }
+                json_lines_fail(job, i);
+                break;
+            }
+        }
+    }
+
+    free(builder.stack);
+    free(builder.frames);
+
+    return NULL;
+}
+
+/**
+ * \brief Helper function to pick the number of workers for a job
+ *
+ * \param[in] threads requested number of workers, 0 for one per online processor
+ * \param[in] record_count number of records of the job
+ *
+ * \return number of workers, at least 1 and never more than there are batches
+ */
+static size_t json_lines_threads(size_t threads, size_t record_count)
+{
+#if defined(JSON_HAS_THREADS)
+    if (threads == 0)
+    {
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = processors > 0 ? (size_t) processors : 1;
+    }
+#else
+    threads = 1;
+#endif
+    size_t batches = (record_count + JSON_LINES_BATCH - 1) / JSON_LINES_BATCH;
+    if (threads > batches) threads = batches;
+
+    return threads == 0 ? 1 : threads;
+}
+
+/**
+ * \brief Helper function to parse every record of a job on threads workers. The calling thread is
+ * worker 0, a thread that can not be started leaves its batches to the others.
+ *
+ * \param[in] job work to do, values must have room for every record
+ * \param[in] threads number of workers, see json_lines_threads
+ * \param[in] arenas receives the arena of every worker, threads of them. Released by the caller also on failure
+ * \param[in] error receives the reason and byte offset of the first malformed record, may be NULL
+ *
+ * \return true if every record was parsed, false otherwise
+ */
+static bool json_lines_run(json_lines_job_t *job, size_t threads, json_arena_t *arenas, json_parse_error_t *error)
+{
+    json_parse_error_t no_error = { NULL, 0 };
+    json_parse_error_t memory_error = { "out of memory", 0 };
+
+    job->next_record = 0;
+    job->failed = job->record_count;
+
+    json_lines_worker_t *workers = (json_lines_worker_t *) malloc(threads * sizeof(json_lines_worker_t));
+    if (workers == NULL)
+    {
+        for (size_t i = 0; i < threads; ++i)
+        {
+            json_arena_init(&arenas[i], JSON_ARENA_MIN_BLOCK_SIZE);
+        }
+        if (error != NULL) *error = memory_error;
+        return false;
+    }
+
+    for (size_t i = 0; i < threads; ++i)
+    {
+        workers[i].job = job;
+        json_arena_init(&workers[i].document.arena, JSON_ARENA_MIN_BLOCK_SIZE);
+        json_intern_init(&workers[i].intern, &workers[i].document.arena);
+        workers[i].error_record = job->record_count;
+        workers[i].error = no_error;
+    }
+
+#if defined(JSON_HAS_THREADS)
+    pthread_t *ids = (pthread_t *) malloc(threads * sizeof(pthread_t));
+    bool *started = (bool *) calloc(threads, sizeof(bool));
+    for (size_t i = 1; ids != NULL && started != NULL && i < threads; ++i)
+    {
+        started[i] = pthread_create(&ids[i], NULL, json_lines_work, &workers[i]) == 0;
+    }
+    json_lines_work(&workers[0]);
+    for (size_t i = 1; ids != NULL && started != NULL && i < threads; ++i)
+    {
+        if (started[i]) pthread_join(ids[i], NULL);
+    }
+    free(ids);
+    free(started);
+#else
+    json_lines_work(&workers[0]);
+#endif
+
+    json_lines_worker_t *failed = NULL;
+    for (size_t i = 0; i < threads; ++i)
+    {
+        if (workers[i].error_record < job->record_count && (failed == NULL || workers[i].error_record < failed->error_record)) failed = &workers[i];
+        arenas[i] = workers[i].document.arena;
+        free(workers[i].intern.entries);
+    }
+
+    if (error != NULL) *error = failed != NULL ? failed->error : no_error;
+    free(workers);
+
+    return failed == NULL;
+}
+
+/**
+ * \brief NDJSON (JSON Lines) parser in jajson.h. Splits exactly size bytes of json into records at
+ * line feeds outside of strings and parses the records on threads workers. Workers claim batches of
+ * JSON_LINES_BATCH records as they go and build them into an arena of their own, so they never
+ * share memory. Blank lines are skipped. JSON_PARSE_PADDED and JSON_PARSE_STRUCTURAL_INDEX work as
+ * for load_json_n, JSON_PARSE_INSITU is ignored. With JSON_PARSE_INTERN_KEYS every worker interns
+ * the keys of all its records into a table of its own. A shared intern table in options is left
+ * alone, workers can not share it: they intern into tables of their own as with
+ * JSON_PARSE_INTERN_KEYS, so keys only compare by pointer within the records of one worker.
+ *
+ * \param[in] json: input that represents json records separated by line feeds
+ * \param[in] size: length of the input in bytes
+ * \param[in] options: parse options applied to every record, NULL for defaults
+ * \param[in] threads: number of workers, 0 for one per online processor. Always 1 without POSIX threads
+ * \param[in] error: receives the reason and byte offset of the first malformed record, may be NULL
+ *
+ * \returns records in input order, released with free_json_lines. NULL if any record is malformed
+ */
+json_lines_t* load_json_lines(const char *json, size_t size, const json_parse_options_t *options, size_t threads, json_parse_error_t *error)
+{
+    unsigned int flags = options != NULL ? options->flags : JSON_PARSE_DEFAULT;
+    json_parse_error_t memory_error = { "out of memory", 0 };
+
+    size_t record_count = 0;
+    size_t *records = json_lines_split(json, size, (flags & JSON_PARSE_PADDED) != 0, &record_count);
+    threads = json_lines_threads(threads, record_count);
+
+    json_lines_t *lines = (json_lines_t *) malloc(sizeof(json_lines_t));
+    json_value_t *values = (json_value_t *) malloc((record_count + 1) * sizeof(json_value_t));
+    json_arena_t *arenas = (json_arena_t *) malloc(threads * sizeof(json_arena_t));
+    if (records == NULL || lines == NULL || values == NULL || arenas == NULL)
+    {
+        free(records);
+        free(lines);
+        free(values);
+        free(arenas);
+        if (error != NULL) *error = memory_error;
+        return NULL;
+    }
+
+    json_lines_job_t job;
+    job.json = json;
+    job.size = size;
+    job.flags = flags & ~(unsigned int) JSON_PARSE_INSITU;
+    if (options != NULL && options->intern != NULL) job.flags |= JSON_PARSE_INTERN_KEYS; // a shared table is not thread safe, see json_intern_create
+    job.max_depth = json_parse_max_depth(options);
+    job.records = records;
+    job.structurals = NULL;
+    job.tokens = NULL;
+    job.record_count = record_count;
+    job.values = values;
+
+    bool parsed = json_lines_run(&job, threads, arenas, error);
+    free(records);
+
+    lines->values = values;
+    lines->size = record_count;
+    lines->arenas = arenas;
+    lines->arena_count = threads;
+
+    if (!parsed)
+    {
+        free_json_lines(lines);
+        return NULL;
+    }
+
+    return lines;
+}
+
+/**
+ * \brief Function to free the records returned by load_json_lines, every worker arena at once
+ *
+ * \param[in] lines records returned by load_json_lines
+ */
+void free_json_lines(json_lines_t *lines)
+{
+    for (size_t i = 0; i < lines->arena_count; ++i)
+    {
+        json_arena_free(&lines->arenas[i]);
+    }
+    free(lines->arenas);
+    free(lines->values);
+    free(lines);
+}
+
+/**
+ * \brief Helper function to record an element of an array that is parsed in parallel
+ *
+ * \param[in] job job collecting the elements, records and tokens grown as needed
+ * \param[in] capacity number of elements records and tokens have room for
+ * \param[in] start offset of the first byte of the element
+ * \param[in] end offset of the ',' or ']' after the element
+ * \param[in] token position of the element in the structural index
+ *
+ * \return false if out of memory, true otherwise
+ */
+static bool json_parallel_add(json_lines_job_t *job, size_t *capacity, size_t start, size_t end, size_t token)
+{
+    if (job->record_count == *capacity)
+    {
+        *capacity = *capacity == 0 ? 1024 : *capacity * 2;
+        size_t *records = (size_t *) realloc((size_t *) job->records, *capacity * 2 * sizeof(size_t));
+        if (records != NULL) job->records = records;
+        size_t *tokens = (size_t *) realloc((size_t *) job->tokens, *capacity * sizeof(size_t));
+        if (tokens != NULL) job->tokens = tokens;
+        if (records == NULL || tokens == NULL) return false;
+    }
+
+    ((size_t *) job->records)[2 * job->record_count] = start;
+    ((size_t *) job->records)[2 * job->record_count + 1] = end;
+    ((size_t *) job->tokens)[job->record_count] = token;
+    job->record_count++;
+
+    return true;
+}
+
+/**
+ * \brief Function to materialize the array behind a cursor with its elements parsed in parallel. One
+ * bracket matching pass over the structural index finds where every element starts and ends, then
+ * threads workers parse batches of elements into arenas of their own. At the end the worker arenas
+ * are handed to the lazy document and the elements are stitched into one array value, which looks
+ * exactly like the same array materialized with json_cursor_value. Navigate to an array deep inside
+ * a document with the json_cursor_* functions first to parse it in parallel. Values other than arrays
+ * are materialized on the calling thread.
+ *
+ * \param[in] cursor cursor pointing at an array
+ * \param[in] threads number of workers, 0 for one per online processor. Always 1 without POSIX threads
+ * \param[in] error receives the reason and byte offset if the array is malformed, may be NULL
+ *
+ * \return materialized value owned by the lazy document, NULL if it is malformed
+ */
+json_value_t* json_cursor_value_parallel(json_cursor_t cursor, size_t threads, json_parse_error_t *error)
+{
+    json_lazy_t *document = cursor.document;
+    json_parser_t *parser = &document->parser;
+    if (json_lazy_char(document, cursor.token) != '[') return json_cursor_value(cursor, error);
+
+    json_parse_error_t parse_error = { NULL, 0 };
+    json_parse_error_t memory_error = { "out of memory", 0 };
+
+    json_lines_job_t job;
+    job.json = parser->input;
+    job.size = (size_t) (parser->end - parser->input);
+    job.flags = parser->readable_end != parser->end ? JSON_PARSE_PADDED : JSON_PARSE_DEFAULT;
+    job.max_depth = parser->max_depth - 1; // the elements sit inside the array
+    job.records = NULL;
+    job.structurals = parser->structurals;
+    job.tokens = NULL;
+    job.record_count = 0;
+
+    // split the array into elements, the elements themselves are validated by the workers
+    bool malformed = false;
+    size_t capacity = 0;
+    size_t token = cursor.token + 1;
+    while (!malformed && parse_error.message == NULL && json_lazy_char(document, token) != ']')
+    {
+        char c = json_lazy_char(document, token);
+        size_t next = json_lazy_skip(document, token);
+        if (c == ',' || c == '}' || c == ':' || c == '\0' || next == JSON_LAZY_INVALID)
+        {
+            malformed = true;
+        } else if (!json_parallel_add(&job, &capacity, parser->structurals[token], parser->structurals[next], token))
+        {
+            parse_error = memory_error;
+        } else
+        {
+            token = next;
+            if (json_lazy_char(document, token) == ',') token++;
+            else if (json_lazy_char(document, token) != ']') malformed = true;
+        }
+    }
+
+    // the index does not track single quoted strings, a ',' or ']' inside one splits the array in
+    // the wrong place, so such arrays are parsed serially as well. Outside double quoted strings
+    // every single quoted one starts a token, apostrophes in ordinary strings do not count.
+    for (size_t i = cursor.token + 1; !malformed && parse_error.message == NULL && i < token; ++i)
+    {
+        malformed = parser->input[parser->structurals[i]] == '\'';
+    }
+
+    if (malformed)
+    {
+        // a serial parse reports the same error load_json would and reads single quotes correctly
+        free((size_t *) job.records);
+        free((size_t *) job.tokens);
+        return json_cursor_value(cursor, error);
+    }
+
+    json_arena_t *arena = &document->document.arena;
+    threads = json_lines_threads(threads, job.record_count);
+    json_arena_t *arenas = (json_arena_t *) malloc(threads * sizeof(json_arena_t));
+    if (parse_error.message == NULL && arenas == NULL) parse_error = memory_error;
+
+    json_array_t *json_array = NULL;
+    json_value_t *values = NULL;
+    if (parse_error.message == NULL)
+    {
+        // elements are stored straight into the array that is handed out
+        json_array = (json_array_t *) json_arena_alloc(arena, sizeof(json_array_t));
+        values = (json_value_t *) json_arena_alloc(arena, job.record_count * sizeof(json_value_t));
+        if (json_array == NULL || (values == NULL && job.record_count > 0)) parse_error = memory_error;
+    }
+
+    bool run = parse_error.message == NULL;
+    bool parsed = false;
+    if (run)
+    {
+        json_array->size = job.record_count;
+        json_array->capacity = job.record_count;
+        json_array->values = values;
+        job.values = values;
+
+        parsed = json_lines_run(&job, threads, arenas, &parse_error);
+        for (size_t i = 0; i < threads; ++i)
+        {
+            // nodes of elements parsed before a failure are released with the lazy document
+            json_arena_merge(arena, &arenas[i]);
+        }
+    }
+
+    free(arenas);
+    free((size_t *) job.records);
+    free((size_t *) job.tokens);
+
+    // a worker only sees its own element, a serial parse reports the same error load_json would
+    if (run && !parsed) return json_cursor_value(cursor, error);
+
+    if (parsed && cursor.token == 0 && json_lazy_char(document, token + 1) != '\0')
+    {
+        // only white space may follow the root value, like json_cursor_value checks
+        json_parse_error_t trailing_error = { "unexpected characters after the root value", parser->structurals[token + 1] };
+        parse_error = trailing_error;
+        parsed = false;
+    }
+
+    json_value_t *json_value = parsed ? (json_value_t *) json_arena_alloc(arena, sizeof(json_value_t)) : NULL;
+    if (parsed && json_value == NULL) parse_error = memory_error;
+    if (error != NULL) *error = parse_error;
+    if (json_value == NULL) return NULL;
+
+    json_value->value.array = json_array;
+    json_value->size = 0;
+    json_value->type = JSON_ARRAY;
+    json_value->flags = JSON_VALUE_ARENA;
+
+    return json_value;
+}
+
+/**
+ * \brief Parallel json parser in jajson.h for huge documents. Indexes exactly size bytes of json
+ * like load_json_lazy and parses the root value with json_cursor_value_parallel, so the elements of a
+ * root array are spread over threads workers. Documents whose root is not an array are parsed on
+ * the calling thread. The result is an ordinary document released with free_json, the input is not
+ * referenced by it.
+ *
+ * \param[in] json: input that represents json data
+ * \param[in] size: length of the input in bytes, must be below UINT32_MAX
+ * \param[in] options: parse options, NULL for defaults (see load_json_lazy)
+ * \param[in] threads: number of workers, 0 for one per online processor. Always 1 without POSIX threads
+ * \param[in] error: receives the reason and byte offset if the input is rejected, may be NULL
+ *
+ * \returns json_value_t variable containing json data represented
+ * using jajson.h defined json structs, enums, and unions, NULL if json is malformed
+ */
+json_value_t* load_json_parallel(const char *json, size_t size, const json_parse_options_t *options, size_t threads, json_parse_error_t *error)
+{
+    json_lazy_t *lazy = load_json_lazy(json, size, options, error);
+    if (lazy == NULL) return NULL;
+
+    // the root cursor rejects anything but white space after the root value
+    json_value_t *root = json_cursor_value_parallel(json_lazy_root(lazy), threads, error);
+
+    json_document_t *document = root != NULL ? (json_document_t *) malloc(sizeof(json_document_t)) : NULL;
+    if (root != NULL && document == NULL && error != NULL)
+    {
+        json_parse_error_t memory_error = { "out of memory", 0 };
+        *error = memory_error;
+    }
+
+    if (document != NULL)
+    {
+        // the document takes over the arena holding every node
+        document->root = *root;
+        document->root.flags = JSON_VALUE_DOCUMENT;
+        document->arena = lazy->document.arena;
+        json_arena_init(&lazy->document.arena, JSON_ARENA_MIN_BLOCK_SIZE);
+    }
+    free_json_lazy(lazy);
+
+    return document != NULL ? &document->root : NULL;
+}
+//===== END LINES JSON IMPLEMENTATION =====
+
+//===== VALIDATE JSON IMPLEMENTATION =====
+/**
+ * \brief Helper function to record why and where validation stopped
+ *
+ * \param[in] error error to fill in
+ * \param[in] offset byte offset of the offending input
+ * \param[in] message reason the input is rejected
+ *
+ * \return false, so callers can return it right away
+ */
+static bool json_validate_fail(json_parse_error_t *error, size_t offset, const char *message)
+{
+    error->message = message;
+    error->offset = offset;
+
+    return false;
+}
+
+/**
+ * \brief Helper function to skip the white space RFC 8259 allows between tokens
+ *
+ * \param[in] json input
+ * \param[in] size length of the input in bytes
+ * \param[in] i offset to start at
+ *
+ * \return offset of the first byte that is not white space, size if there is none
+ */
+static size_t json_validate_white_space(const char *json, size_t size, size_t i)
+{
+    while (i < size && (json[i] == ' ' || json[i] == '\n' || json[i] == '\r' || json[i] == '\t'))
+    {
+        i++;
+    }
+
+    return i;
+}
+
+/**
+ * \brief Helper function to find the next byte of a string that needs a closer look: a quote, a
+ * backslash, a control character or the lead byte of a multi byte UTF-8 sequence. Checks 32 (AVX2)
+ * or 16 (SSE2) bytes at a time, loads never cross the end of the input.
+ *
+ * \param[in] json input
+ * \param[in] size length of the input in bytes
+ * \param[in] i offset to start at
+ *
+ * \return offset of the first such byte, size if there is none
+ */
+static size_t json_validate_find_special(const char *json, size_t size, size_t i)
+{
+#if defined(JSON_SIMD_AVX2)
+    while (i + 32 <= size)
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *) (json + i));
+        __m256i special = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'))),
+            _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, _mm256_set1_epi8(0x1F)), chunk)); // bytes <= 0x1F
+        uint32_t mask = (uint32_t) _mm256_movemask_epi8(special) | (uint32_t) _mm256_movemask_epi8(chunk); // bytes >= 0x80
+        if (mask != 0) return i + json_ctz64(mask);
+        i += 32;
+    }
+#elif defined(JSON_SIMD_SSE2)
+    while (i + 16 <= size)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) (json + i));
+        __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))),
+            _mm_cmpeq_epi8(_mm_min_epu8(chunk, _mm_set1_epi8(0x1F)), chunk)); // bytes <= 0x1F
+        uint32_t mask = (uint32_t) _mm_movemask_epi8(special) | (uint32_t) _mm_movemask_epi8(chunk); // bytes >= 0x80
+        if (mask != 0) return i + json_ctz64(mask);
+        i += 16;
+    }
+#endif
+
+    while (i < size)
+    {
+        unsigned char c = (unsigned char) json[i];
+        if (c == '"' || c == '\\' || c < 0x20 || c >= 0x80) break;
+        i++;
+    }
+
+    return i;
+}
+
+/**
+ * \brief Helper function to check a single multi byte UTF-8 sequence (RFC 3629). Overlong forms,
+ * surrogates and code points above U+10FFFF are rejected.
+ *
+ * \param[in] in lead byte of the sequence
+ * \param[in] available number of bytes left in the input, at least 1
+ *
+ * \return length of the sequence, 0 if it is malformed or cut off by the end of the input
+ */
+static size_t json_validate_utf8(const unsigned char *in, size_t available)
+{
+    // the second byte has the tightest range, it rules out overlong forms, surrogates and big code points
+    unsigned char low = 0x80, high = 0xBF;
+    size_t length;
+    if (in[0] >= 0xC2 && in[0] <= 0xDF)
+    {
+        length = 2;
+    } else if (in[0] >= 0xE0 && in[0] <= 0xEF)
+    {
+        length = 3;
+        if (in[0] == 0xE0) low = 0xA0;
+        if (in[0] == 0xED) high = 0x9F;
+    } else if (in[0] >= 0xF0 && in[0] <= 0xF4)
+    {
+        length = 4;
+        if (in[0] == 0xF0) low = 0x90;
+        if (in[0] == 0xF4) high = 0x8F;
+    } else
+    {
+        return 0;
+    }
+
+    if (available < length || in[1] < low || in[1] > high) return 0;
+    for (size_t k = 2; k < length; ++k)
+    {
+        if ((in[k] & 0xC0) != 0x80) return 0;
+    }
+
+    return length;
+}
+
+/**
+ * \brief Helper function to validate a string: only double quotes, the escapes RFC 8259 defines
+ * with surrogates in pairs, no raw control characters and well formed UTF-8
+ *
+ * \param[in] json input
+ * \param[in] size length of the input in bytes
+ * \param[in] i address of the offset of the opening quote, advanced past the closing quote
+ * \param[in] error receives the reason and offset if the string is malformed
+ *
+ * \return true if the string is valid, false otherwise
+ */
+static bool json_validate_string(const char *json, size_t size, size_t *i, json_parse_error_t *error)
+{
+    size_t start = *i;
+    size_t p = start + 1;
+
+    for (;;)
+    {
+        p = json_validate_find_special(json, size, p);
+        if (p >= size) return json_validate_fail(error, p, "unterminated string");
+
+        unsigned char c = (unsigned char) json[p];
+        if (c == '"')
+        {
+            *i = p + 1;
+            return true;
+        } else if (c == '\\')
+        {
+            if (p + 1 >= size) return json_validate_fail(error, p + 1, "unterminated string");
+
+            switch (json[p + 1])
+            {
+                case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                    p += 2;
+                    break;
+
+                case 'u':
+                {
+                    // surrogates only come in pairs, a high one right before a low one
+                    long code = read_hex4(json + p + 2, json + size);
+                    if (code < 0 || (code >= 0xDC00 && code <= 0xDFFF)) return json_validate_fail(error, p, "invalid \\u escape");
+                    if (code >= 0xD800 && code <= 0xDBFF)
+                    {
+                        long low = p + 12 <= size && json[p + 6] == '\\' && json[p + 7] == 'u' ? read_hex4(json + p + 8, json + size) : -1;
+                        if (low < 0xDC00 || low > 0xDFFF) return json_validate_fail(error, p, "invalid \\u escape");
+                        p += 6;
+                    }
+                    p += 6;
+                    break;
+                }
+
+                default:
+                    return json_validate_fail(error, p, "invalid escape sequence");
+            }
+        } else if (c < 0x20)
+        {
+            return json_validate_fail(error, p, "control character in string");
+        } else
+        {
+            size_t length = json_validate_utf8((const unsigned char *) json + p, size - p);
+            if (length == 0) return json_validate_fail(error, p, "invalid UTF-8");
+            p += length;
+        }
+    }
+}
+
+/**
+ * \brief Helper function to skip a run of digits, 8 at a time while they last
+ *
+ * \param[in] json input
+ * \param[in] size length of the input in bytes
+ * \param[in] i offset to start at
+ *
+ * \return offset of the first byte that is not a digit, size if there is none
+ */
+static size_t json_validate_digits(const char *json, size_t size, size_t i)
+{
+    while (i + 8 <= size && json_is_eight_digits(json_load_eight_bytes(json + i)))
+    {
+        i += 8;
+    }
+    while (i < size && is_json_digit(json[i]))
+    {
+        i++;
+    }
+
+    return i;
+}
+
+/**
+ * \brief Helper function to validate a number: an optional minus, no leading zeros, and digits
+ * on both sides of a decimal point and after an exponent
+ *
+ * \param[in] json input
+ * \param[in] size length of the input in bytes
+ * \param[in] i address of the offset of the first byte of the number, advanced past it
+ * \param[in] error receives the reason and offset if the number is malformed
+ *
+ * \return true if the number is valid, false otherwise
+ */
+static bool json_validate_number(const char *json, size_t size, size_t *i, json_parse_error_t *error)
+{
+    size_t p = *i;
+    if (json[p] == '-') p++;
+
+    if (p >= size || !is_json_digit(json[p])) return json_validate_fail(error, p, "expected a digit");
+    if (json[p] == '0')
+    {
+        p++;
+        if (p < size && is_json_digit(json[p])) return json_validate_fail(error, p, "leading zeros are not allowed");
+    } else
+    {
+        p = json_validate_digits(json, size, p);
+    }
+
+    if (p < size && json[p] == '.')
+    {
+        p++;
+        if (p >= size || !is_json_digit(json[p])) return json_validate_fail(error, p, "expected a digit after the decimal point");
+        p = json_validate_digits(json, size, p);
+    }
+
+    if (p < size && (json[p] == 'e' || json[p] == 'E'))
+    {
+        p++;
+        if (p < size && (json[p] == '-' || json[p] == '+')) p++;
+        if (p >= size || !is_json_digit(json[p])) return json_validate_fail(error, p, "expected a digit in the exponent");
+        p = json_validate_digits(json, size, p);
+    }
+
+    *i = p;
+    return true;
+}
+
+/**
+ * \brief Helper function to validate an object key and the colon after it
+ *
+ * \param[in] json input
+ * \param[in] size length of the input in bytes
+ * \param[in] i address of the offset of the key, advanced to the member's value
+ * \param[in] error receives the reason and offset if the key is malformed
+ *
+ * \return true if the key is valid, false otherwise
+ */
+static bool json_validate_key(const char *json, size_t size, size_t *i, json_parse_error_t *error)
+{
+    if (*i >= size) return json_validate_fail(error, *i, "unterminated object");
+    if (json[*i] != '"') return json_validate_fail(error, *i, "expected a string key");
+    if (!json_validate_string(json, size, i, error)) return false;
+
+    *i = json_validate_white_space(json, size, *i);
+    if (*i >= size || json[*i] != ':') return json_validate_fail(error, *i, "expected ':' after object key");
+    *i = json_validate_white_space(json, size, *i + 1);
+
+    return true;
+}
+
+/**
+ * \brief Strict validator in jajson.h. Checks that exactly size bytes of json are one value that
+ * follows the RFC 8259 grammar, with well formed UTF-8 inside strings. Nothing is allocated and
+ * nothing is decoded: the open containers are tracked one bit each on the C stack, strings are
+ * scanned 32 (AVX2) or 16 (SSE2) bytes at a time. Unlike the parsers single quoted strings,
+ * \' escapes and trailing commas are rejected.
+ *
+ * \param[in] json: input that represents json data, need not be null terminated
+ * \param[in] size: length of the input in bytes
+ * \param[in] error: receives the reason and byte offset of the first error, may be NULL
+ *
+ * \returns true if the input is valid json, false otherwise. Input nested deeper than
+ * JSON_VALIDATE_MAX_DEPTH is rejected
+ */
+bool json_validate(const char *json, size_t size, json_parse_error_t *error)
+{
+    uint64_t objects[JSON_VALIDATE_MAX_DEPTH / 64]; // bit set for every open container that is an object
+    size_t depth = 0;
+
+    json_parse_error_t ignored;
+    if (error == NULL) error = &ignored;
+    error->message = NULL;
+    error->offset = 0;
+
+    size_t i = json_validate_white_space(json, size, 0);
+    for (;;)
+    {
+        // a value starts at i
+        char c = i < size ? json[i] : '\0';
+        if (c == '{' || c == '[')
+        {
+            if (depth == JSON_VALIDATE_MAX_DEPTH) return json_validate_fail(error, i, "nesting too deep");
+
+            uint64_t bit = (uint64_t) 1 << (depth % 64);
+            if (c == '{') objects[depth / 64] |= bit;
+            else objects[depth / 64] &= ~bit;
+            depth++;
+
+            i = json_validate_white_space(json, size, i + 1);
+            if (i < size && json[i] == (c == '{' ? '}' : ']'))
+            {
+                depth--;
+                i++;
+            } else
+            {
+                if (c == '{' && !json_validate_key(json, size, &i, error)) return false;
+                continue;
+            }
+        } else if (c == '"')
+        {
+            if (!json_validate_string(json, size, &i, error)) return false;
+        } else if (c == '-' || is_json_digit(c))
+        {
+            if (!json_validate_number(json, size, &i, error)) return false;
+        } else if (size - i >= 4 && memcmp(json + i, "true", 4) == 0)
+        {
+            i += 4;
+        } else if (size - i >= 5 && memcmp(json + i, "false", 5) == 0)
+        {
+            i += 5;
+        } else if (size - i >= 4 && memcmp(json + i, "null", 4) == 0)
+        {
+            i += 4;
+        } else
+        {
+            return json_validate_fail(error, i, i < size ? "unexpected character" : "unexpected end of input");
+        }
+
+        // close every container the value completes, then step to the next value
+        for (;;)
+        {
+            i = json_validate_white_space(json, size, i);
+            if (depth == 0)
+            {
+                if (i < size) return json_validate_fail(error, i, "unexpected characters after the root value");
+                return true;
+            }
+
+            bool is_object = (objects[(depth - 1) / 64] >> ((depth - 1) % 64)) & 1;
+            if (i < size && json[i] == ',')
+            {
+                i = json_validate_white_space(json, size, i + 1);
+                if (is_object && !json_validate_key(json, size, &i, error)) return false;
+                break;
+            }
+            if (i < size && json[i] == (is_object ? '}' : ']'))
+            {
+                depth--;
+                i++;
+                continue;
+            }
+
+            if (i >= size) return json_validate_fail(error, i, is_object ? "unterminated object" : "unterminated array");
+            return json_validate_fail(error, i, is_object ? "expected ',' or '}' in object" : "expected ',' or ']' in array");
+        }
+    }
+}
+//===== END VALIDATE JSON IMPLEMENTATION =====
+
+//===== TAPE JSON IMPLEMENTATION =====
+/**
+ * \brief Helper function to make room for count more words on the tape
+ *
+ * \param[in] builder tape builder
+ * \param[in] count number of words about to be appended
+ *
+ * \return false if out of memory or if the tape would outgrow the 32 bit jump offsets, true otherwise
+ */
+static bool json_tape_reserve(json_tape_builder_t *builder, size_t count)
+{
+    size_t size = builder->tape->size + count;
+    if (size <= builder->capacity) return true;
+    if (size > UINT32_MAX)
+    {
+        builder->failure = "document too large for a tape";
+        return false;
+    }
+
+    size_t capacity = builder->capacity * 2;
+    while (capacity < size)
+    {
+        capacity *= 2;
+    }
+
+    json_tape_t *tape = (json_tape_t *) realloc(builder->tape, sizeof(json_tape_t) + capacity * sizeof(uint64_t));
+    if (tape == NULL)
+    {
+        builder->failure = "out of memory";
+        return false;
+    }
+
+    builder->tape = tape;
+    builder->capacity = capacity;
+    return true;
+}
+
+/**
+ * \brief Helper function to append a word to the tape
+ *
+ * \param[in] builder tape builder
+ * \param[in] tag json_tape_tags_t value stored in the top 8 bits
+ * \param[in] payload value stored in the low 56 bits
+ *
+ * \return false if out of memory, true otherwise
+ */
+static bool json_tape_append(json_tape_builder_t *builder, char tag, uint64_t payload)
+{
+    if (!json_tape_reserve(builder, 1)) return false;
+
+    json_tape_t *tape = builder->tape;
+    tape->words[tape->size++] = ((uint64_t) (unsigned char) tag << 56) | payload;
+    return true;
+}
+
+/**
+ * \brief Helper function to append a scalar that takes a tag word and a value word
+ *
+ * \param[in] builder tape builder
+ * \param[in] tag JSON_TAPE_INT or JSON_TAPE_FLOAT
+ * \param[in] bits bits of the value
+ *
+ * \return false if out of memory, true otherwise
+ */
+static bool json_tape_append_number(json_tape_builder_t *builder, char tag, uint64_t bits)
+{
+    if (!json_tape_reserve(builder, 2)) return false;
+
+    json_tape_t *tape = builder->tape;
+    tape->words[tape->size++] = (uint64_t) (unsigned char) tag << 56;
+    tape->words[tape->size++] = bits;
+    return true;
+}
+
+/**
+ * \brief Helper function to open a container. Its begin word is patched once the container is closed.
+ *
+ * \param[in] builder tape builder
+ * \param[in] tag JSON_TAPE_OBJECT_BEGIN or JSON_TAPE_ARRAY_BEGIN
+ *
+ * \return false if out of memory, true otherwise
+ */
+static bool json_tape_begin(json_tape_builder_t *builder, char tag)
+{
+    if (builder->depth == builder->open_capacity)
+    {
+        size_t open_capacity = builder->open_capacity == 0 ? 32 : builder->open_capacity * 2;
+        size_t *open = (size_t *) realloc(builder->open, open_capacity * sizeof(size_t));
+        if (open == NULL)
+        {
+            builder->failure = "out of memory";
+            return false;
+        }
+
+        builder->open = open;
+        builder->open_capacity = open_capacity;
+    }
+
+    builder->open[builder->depth++] = builder->tape->size;
+    return json_tape_append(builder, tag, 0);
+}
+
+/**
+ * \brief Helper function to close a container: the end word points back at the begin word, the
+ * begin word gets the member count and the index right after the end word.
+ *
+ * \param[in] builder tape builder
+ * \param[in] tag JSON_TAPE_OBJECT_END or JSON_TAPE_ARRAY_END
+ * \param[in] size number of members or elements of the container
+ *
+ * \return false if out of memory, true otherwise
+ */
+static bool json_tape_end(json_tape_builder_t *builder, char tag, size_t size)
+{
+    size_t begin = builder->open[--builder->depth];
+    if (!json_tape_append(builder, tag, begin)) return false;
+
+    uint64_t count = size < JSON_TAPE_COUNT_MAX ? size : JSON_TAPE_COUNT_MAX;
+    builder->tape->words[begin] |= count << 32 | builder->tape->size;
+    return true;
+}
+
+/**
+ * \brief Callback adding a string or key: its length, bytes and null termination character go to the
+ * string buffer, the tape gets its offset there.
+ */
+static bool json_tape_on_string(void *user, const char *string, size_t size)
+{
+    json_tape_builder_t *builder = (json_tape_builder_t *) user;
+    if (size > UINT32_MAX)
+    {
+        builder->failure = "string too long for a tape";
+        return false;
+    }
+
+    json_tape_t *tape = builder->tape;
+    size_t needed = tape->strings_size + sizeof(uint32_t) + size + 1;
+    if (needed > builder->strings_capacity)
+    {
+        size_t strings_capacity = builder->strings_capacity == 0 ? 4096 : builder->strings_capacity * 2;
+        while (strings_capacity < needed)
+        {
+            strings_capacity *= 2;
+        }
+
+        char *strings = (char *) realloc(tape->strings, strings_capacity);
+        if (strings == NULL)
+        {
+            builder->failure = "out of memory";
+            return false;
+        }
+
+        tape->strings = strings;
+        builder->strings_capacity = strings_capacity;
+    }
+
+    size_t offset = tape->strings_size;
+    uint32_t length = (uint32_t) size;
+    memcpy(tape->strings + offset, &length, sizeof(uint32_t));
+    memcpy(tape->strings + offset + sizeof(uint32_t), string, size);
+    tape->strings[offset + sizeof(uint32_t) + size] = '\0';
+    tape->strings_size = needed;
+
+    return json_tape_append(builder, JSON_TAPE_STRING, offset);
+}
+
+/**
+ * \brief Callback opening an object
+ */
+static bool json_tape_on_object_begin(void *user)
+{
+    return json_tape_begin((json_tape_builder_t *) user, JSON_TAPE_OBJECT_BEGIN);
+}
+
+/**
+ * \brief Callback closing an object
+ */
+static bool json_tape_on_object_end(void *user, size_t size)
+{
+    return json_tape_end((json_tape_builder_t *) user, JSON_TAPE_OBJECT_END, size);
+}
+
+/**
+ * \brief Callback opening an array
+ */
+static bool json_tape_on_array_begin(void *user)
+{
+    return json_tape_begin((json_tape_builder_t *) user, JSON_TAPE_ARRAY_BEGIN);
+}
+
+/**
+ * \brief Callback closing an array
+ */
+static bool json_tape_on_array_end(void *user, size_t size)
+{
+    return json_tape_end((json_tape_builder_t *) user, JSON_TAPE_ARRAY_END, size);
+}
+
+/**
+ * \brief Callback adding an integer
+ */
+static bool json_tape_on_int(void *user, long value)
+{
+    return json_tape_append_number((json_tape_builder_t *) user, JSON_TAPE_INT, (uint64_t) value);
+}
+
+/**
+ * \brief Callback adding a floating point value
+ */
+static bool json_tape_on_float(void *user, double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    return json_tape_append_number((json_tape_builder_t *) user, JSON_TAPE_FLOAT, bits);
+}
+
+/**
+ * \brief Callback adding a boolean
+ */
+static bool json_tape_on_bool(void *user, bool value)
+{
+    return json_tape_append((json_tape_builder_t *) user, value ? JSON_TAPE_TRUE : JSON_TAPE_FALSE, 0);
+}
+
+/**
+ * \brief Callback adding a null
+ */
+static bool json_tape_on_null(void *user)
+{
+    return json_tape_append((json_tape_builder_t *) user, JSON_TAPE_NULL, 0);
+}
+
+/**
+ * \brief Callbacks of the tape builder, load_json_tape is a SAX parse with these
+ */
+static const json_sax_handler_t json_tape_handler = {
+    json_tape_on_object_begin,
+    json_tape_on_string,
+    json_tape_on_object_end,
+    json_tape_on_array_begin,
+    json_tape_on_array_end,
+    json_tape_on_string,
+    json_tape_on_int,
+    json_tape_on_float,
+    json_tape_on_bool,
+    json_tape_on_null
+};
+
+/**
+ * \brief Tape json parser in jajson.h. Parses exactly size bytes of json into a tape instead of a
+ * tree of nodes: the values are written out as 64 bit words in document order and every string
+ * is copied into one side buffer. Containers know the index right after their end, so a subtree
+ * is skipped in O(1). The result is two allocations, which makes it cheap to keep many documents
+ * around and to free them. Options work as for load_json_n, JSON_PARSE_INSITU is ignored.
+ *
+ * \param[in] json: input that represents json data
+ * \param[in] size: length of the input in bytes
+ * \param[in] options: parse options, NULL for defaults
+ * \param[in] error: receives the reason and byte offset if the input is rejected, may be NULL
+ *
+ * \returns tape of the document, released with free_json_tape. NULL if json is malformed
+ */
+json_tape_t* load_json_tape(const char *json, size_t size, const json_parse_options_t *options, json_parse_error_t *error)
+{
+    unsigned int flags = options != NULL ? options->flags : JSON_PARSE_DEFAULT;
+    json_parse_error_t memory_error = { "out of memory", 0 };
+
+    // a word per 8 bytes of input is about what typical documents need
+    json_tape_builder_t builder;
+    builder.capacity = size / 8 > 64 ? size / 8 : 64;
+    builder.tape = (json_tape_t *) malloc(sizeof(json_tape_t) + builder.capacity * sizeof(uint64_t));
+    builder.strings_capacity = 0;
+    builder.open = NULL;
+    builder.depth = 0;
+    builder.open_capacity = 0;
+    builder.failure = NULL;
+    if (builder.tape == NULL)
+    {
+        if (error != NULL) *error = memory_error;
+        return NULL;
+    }
+
+    json_tape_t *tape = builder.tape;
+    tape->strings = NULL;
+    tape->strings_size = 0;
+    tape->size = 0;
+    json_tape_append(&builder, JSON_TAPE_ROOT, 0);
+
+    // strings are borrowed from the input and copied into the string buffer by the callbacks
+    json_parser_t parser;
+    json_parser_init(&parser, (char *) json, size, flags & ~(unsigned int) JSON_PARSE_INSITU, &json_tape_handler, &builder);
+    parser.max_depth = json_parse_max_depth(options);
+    json_parse_error_t parse_error;
+    bool parsed = json_parser_run(&parser, &parse_error) && json_tape_append(&builder, JSON_TAPE_ROOT, 0);
+    if (builder.failure != NULL) parse_error.message = builder.failure;
+    free(builder.open);
+
+    tape = builder.tape;
+    if (!parsed)
+    {
+        if (error != NULL) *error = parse_error;
+        free(tape->strings);
+        free(tape);
+        return NULL;
+    }
+    tape->words[0] |= tape->size;
+
+    // give back what the growth left over
+    json_tape_t *trimmed = (json_tape_t *) realloc(tape, sizeof(json_tape_t) + tape->size * sizeof(uint64_t));
+    if (trimmed != NULL) tape = trimmed;
+    char *strings = tape->strings_size > 0 ? (char *) realloc(tape->strings, tape->strings_size) : tape->strings;
+    if (strings != NULL) tape->strings = strings;
+
+    if (error != NULL) *error = parse_error;
+
+    return tape;
+}
+
+/**
+ * \brief Function to free a tape returned by load_json_tape
+ *
+ * \param[in] tape tape to free
+ */
+void free_json_tape(json_tape_t *tape)
+{
+    free(tape->strings);
+    free(tape);
+}
+
+/**
+ * \brief Function to get the type of the value at index i of a tape
+ *
+ * \param[in] tape tape returned by load_json_tape
+ * \param[in] i index of a value, 1 for the root
+ *
+ * \return type of the value
+ */
+json_types_t json_tape_type(const json_tape_t *tape, size_t i)
+{
+    switch ((char) (tape->words[i] >> 56))
+    {
+        case JSON_TAPE_OBJECT_BEGIN: return JSON_OBJECT;
+        case JSON_TAPE_ARRAY_BEGIN: return JSON_ARRAY;
+        case JSON_TAPE_STRING: return JSON_STRING;
+        case JSON_TAPE_INT: return JSON_INT;
+        case JSON_TAPE_FLOAT: return JSON_FLOAT;
+        case JSON_TAPE_TRUE:
+        case JSON_TAPE_FALSE: return JSON_BOOL;
+        default: return JSON_NULL;
+    }
+}
+
+/**
+ * \brief Function to step over the value at index i of a tape in O(1), containers jump to the
+ * word after their end
+ *
+ * \param[in] tape tape returned by load_json_tape
+ * \param[in] i index of a value
+ *
+ * \return index of the word after the value
+ */
+size_t json_tape_skip(const json_tape_t *tape, size_t i)
+{
+    switch ((char) (tape->words[i] >> 56))
+    {
+        case JSON_TAPE_OBJECT_BEGIN:
+        case JSON_TAPE_ARRAY_BEGIN: return (size_t) (tape->words[i] & UINT32_MAX);
+        case JSON_TAPE_INT:
+        case JSON_TAPE_FLOAT: return i + 2;
+        default: return i + 1;
+    }
+}
+
+/**
+ * \brief Function to get the first child of a container on a tape. The children of an object
+ * alternate between keys and values, the value of a key at index k is at k + 1.
+ *
+ * \param[in] tape tape returned by load_json_tape
+ * \param[in] i index of an object or array
+ *
+ * \return index of the first element or key, JSON_TAPE_INVALID if the container is empty
+ */
+size_t json_tape_child(const json_tape_t *tape, size_t i)
+{
+    char tag = (char) (tape->words[i + 1] >> 56);
+
+    return tag == JSON_TAPE_OBJECT_END || tag == JSON_TAPE_ARRAY_END ? JSON_TAPE_INVALID : i + 1;
+}
+
+/**
+ * \brief Function to get the next child of a container on a tape, see json_tape_child
+ *
+ * \param[in] tape tape returned by load_json_tape
+ * \param[in] i index of an element, or of a member value
+ *
+ * \return index of the next element or key, JSON_TAPE_INVALID after the last one
+ */
+size_t json_tape_next(const json_tape_t *tape, size_t i)
+{
+    return json_tape_child(tape, json_tape_skip(tape, i) - 1);
+}
+
+/**
+ * \brief Function to get the number of members of an object, elements of an array or bytes of a
+ * string on a tape
+ *
+ * \param[in] tape tape returned by load_json_tape
+ * \param[in] i index of an object, array or string
+ *
+ * \return size of the value, 0 for other types
+ */
+size_t json_tape_size(const json_tape_t *tape, size_t i)
+{
+    char tag = (char) (tape->words[i] >> 56);
+    if (tag == JSON_TAPE_STRING)
+    {
+        uint32_t length;
+        memcpy(&length, tape->strings + (tape->words[i] & JSON_TAPE_PAYLOAD_MASK), sizeof(uint32_t));
+        return length;
+    }
+    if (tag != JSON_TAPE_OBJECT_BEGIN && tag != JSON_TAPE_ARRAY_BEGIN) return 0;
+
+    size_t count = (size_t) ((tape->words[i] & JSON_TAPE_PAYLOAD_MASK) >> 32);
+    if (count < JSON_TAPE_COUNT_MAX) return count;
+
+    // the count saturated, walk the children
+    count = 0;
+    for (size_t child = json_tape_child(tape, i); child != JSON_TAPE_INVALID; child = json_tape_next(tape, child + (tag == JSON_TAPE_OBJECT_BEGIN)))
+    {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * \brief Function to get the integer at index i of a tape
+ *
+ * \param[in] tape tape returned by load_json_tape
+ * \param[in] i index of an integer
+ *
+ * \return value of the integer
+ */
+long json_tape_int(const json_tape_t *tape, size_t i)
+{
+    return (long) tape->words[i + 1];
+}
+
+/**
+ * \brief Function to get the number at index i of a tape as a floating point value
+ *
+ * \param[in] tape tape returned by load_json_tape
+ * \param[in] i index of a float or an integer
+ *
+ * \return value of the number
+ */
+double json_tape_float(const json_tape_t *tape, size_t i)
+{
+    if ((char) (tape->words[i] >> 56) == JSON_TAPE_INT) return (double) json_tape_int(tape, i);
+
+    double value;
+    memcpy(&value, &tape->words[i + 1], sizeof(value));
+    return value;
+}
+
+/**
+ * \brief Function to get the boolean at index i of a tape
+ *
+ * \param[in] tape tape returned by load_json_tape
+ * \param[in] i index of a boolean
+ *
+ * \return value of the boolean
+ */
+bool json_tape_bool(const json_tape_t *tape, size_t i)
+{
+    return (char) (tape->words[i] >> 56) == JSON_TAPE_TRUE;
+}
+
+/**
+ * \brief Function to get the string or key at index i of a tape
+ *
+ * \param[in] tape tape returned by load_json_tape
+ * \param[in] i index of a string or key
+ * \param[in] size receives the length of the string, may be NULL
+ *
+ * \return null terminated string owned by the tape
+ */
+const char* json_tape_string(const json_tape_t *tape, size_t i, size_t *size)
+{
+    const char *string = tape->strings + (tape->words[i] & JSON_TAPE_PAYLOAD_MASK);
+    if (size != NULL)
+    {
+        uint32_t length;
+        memcpy(&length, string, sizeof(uint32_t));
+        *size = length;
+    }
+
+    return string + sizeof(uint32_t);
+}
+
+/**
+ * \brief Function to look up the value of a key in an object on a tape, members are compared in order
+ *
+ * \param[in] tape tape returned by load_json_tape
+ * \param[in] i index of an object
+ * \param[in] key key to look for
+ * \param[in] key_size length of key
+ *
+ * \return index of the value of the first member with that key, JSON_TAPE_INVALID if there is none
+ */
+size_t json_tape_object_get(const json_tape_t *tape, size_t i, const char *key, size_t key_size)
+{
+    for (size_t child = json_tape_child(tape, i); child != JSON_TAPE_INVALID; child = json_tape_next(tape, child + 1))
+    {
+        size_t size;
+        const char *string = json_tape_string(tape, child, &size);
+        if (size == key_size && memcmp(string, key, key_size) == 0) return child + 1;
+    }
+
+    return JSON_TAPE_INVALID;
+}
+
+/**
+ * \brief Function to get an element of an array on a tape, elements before it are skipped in O(1) each
+ *
+ * \param[in] tape tape returned by load_json_tape
+ * \param[in] i index of an array
+ * \param[in] index position of the element
+ *
+ * \return index of the element, JSON_TAPE_INVALID if the array is shorter
+ */
+size_t json_tape_array_get(const json_tape_t *tape, size_t i, size_t index)
+{
+    size_t child = json_tape_child(tape, i);
+    while (child != JSON_TAPE_INVALID && index-- > 0)
+    {
+        child = json_tape_next(tape, child);
+    }
+
+    return child;
+}
+//===== END TAPE JSON IMPLEMENTATION =====
+
+//===== INTERN JSON IMPLEMENTATION =====
+/**
+ * \brief Helper function to set up an empty intern table, no memory is taken until the first key
+ *
+ * \param[in] intern table to initialize
+ * \param[in] arena arena receiving the stored keys
+ */
+static void json_intern_init(json_intern_t *intern, json_arena_t *arena)
+{
+    intern->entries = NULL;
+    intern->size = 0;
+    intern->mask = 0;
+    intern->arena = arena;
+}
+
+/**
+ * \brief Helper function to double the slots of an intern table, or allocate its first
+ * JSON_INTERN_MIN_SLOTS. Stored keys keep their address, only the slots move.
+ *
+ * \param[in] intern table to grow
+ *
+ * \return true if the table grew, false if memory ran out
+ */
+static bool json_intern_grow(json_intern_t *intern)
+{
+    size_t slots = intern->entries != NULL ? (intern->mask + 1) * 2 : JSON_INTERN_MIN_SLOTS;
+    json_intern_entry_t *entries = (json_intern_entry_t *) calloc(slots, sizeof(json_intern_entry_t));
+    if (entries == NULL) return false;
+
+    for (size_t i = 0; intern->entries != NULL && i <= intern->mask; ++i)
+    {
+        if (intern->entries[i].key == NULL) continue;
+
+        size_t slot = intern->entries[i].hash & (slots - 1);
+        while (entries[slot].key != NULL)
+        {
+            slot = (slot + 1) & (slots - 1);
+        }
+        entries[slot] = intern->entries[i];
+    }
+
+    free(intern->entries);
+    intern->entries = entries;
+    intern->mask = slots - 1;
+
+    return true;
+}
+
+/**
+ * \brief Function to create a long lived intern table. Set it as the intern of json_parse_options_t
+ * and every document parsed with those options shares one copy of each distinct key, across
+ * documents too. Keys are compared by pointer then: json_object_get finds a key passed as returned
+ * by json_intern without comparing bytes. A table must not be used by two parses at the same time.
+ * load_json_lines is the exception: it parses on several threads, so it leaves the table alone and
+ * interns into one table per worker instead.
+ *
+ * \returns empty table to be released with json_intern_free, NULL if memory ran out
+ */
+json_intern_t* json_intern_create(void)
+{
+    json_intern_t *intern = (json_intern_t *) malloc(sizeof(json_intern_t));
+    if (intern == NULL) return NULL;
+
+    json_arena_init(&intern->storage, JSON_ARENA_MIN_BLOCK_SIZE);
+    json_intern_init(intern, &intern->storage);
+
+    return intern;
+}
+
+/**
+ * \brief Function to release a table from json_intern_create together with every key stored in it.
+ * Documents parsed with the table point at those keys, release them first.
+ *
+ * \param[in] intern table to release, may be NULL
+ */
+void json_intern_free(json_intern_t *intern)
+{
+    if (intern == NULL) return;
+
+    free(intern->entries);
+    json_arena_free(&intern->storage);
+    free(intern);
+}
+
+/**
+ * \brief Function to look up a key in an intern table, storing a copy on first sight
+ *
+ * \param[in] intern table to look in
+ * \param[in] key bytes of the key, need not be null terminated
+ * \param[in] key_size length of key
+ *
+ * \return stored null terminated copy, the same pointer for every call with equal bytes. NULL if memory ran out
+ */
+const char* json_intern(json_intern_t *intern, const char *key, size_t key_size)
+{
+    if (key_size > UINT32_MAX) return NULL; // longer than an entry can describe
+    if ((intern->size + 1) * 2 > intern->mask + 1 && !json_intern_grow(intern)) return NULL;
+
+    uint32_t hash = (uint32_t) json_hash_key(key, key_size);
+    size_t slot = hash & intern->mask;
+    while (intern->entries[slot].key != NULL)
+    {
+        json_intern_entry_t *entry = &intern->entries[slot];
+        if (entry->hash == hash && entry->key_size == key_size && memcmp(entry->key, key, key_size) == 0)
+        {
+            return entry->key;
+        }
+        slot = (slot + 1) & intern->mask;
+    }
+
+    char *copy = (char *) json_arena_alloc(intern->arena, key_size + 1);
+    if (copy == NULL) return NULL;
+    memcpy(copy, key, key_size);
+    copy[key_size] = '\0';
+
+    intern->entries[slot].key = copy;
+    intern->entries[slot].key_size = (uint32_t) key_size;
+    intern->entries[slot].hash = hash;
+    intern->size++;
+
+    return copy;
 }
+//===== END INTERN JSON IMPLEMENTATION =====
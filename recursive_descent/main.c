@@ -74,10 +74,13 @@ int main() {
     printf("below will be json loaded through file!\n");
     // load file into string
 
-    char *json_test1 = readFile("test1.json");
-    printf("file contents: %s\n", json_test1);
-    json_value_t *json = load_json(json_test1);
+    json_value_t *json = load_json_file("test1.json");
+    if (json == NULL) {
+        fprintf(stderr, "could not load test1.json\n");
+        return 1;
+    }
     print_json_value(*json);
+    free_json(json);
     printf("\n");
 
     // printf("Value of json loaded: %d\n", json->value->boolean.value);
@@ -0,0 +1,1017 @@
+#include "jajson.h"
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+
+
+static int failures = 0;
+
+// documents every parse mode has to accept or reject exactly like load_json_n in scalar mode
+static const char *cases[] = {
+    "{}",
+    "[]",
+    "[{}, [], {\"a\":[]}, [[{}]], \"\"]",
+    "{\"a\":{\"b\":{\"c\":[1,{\"d\":null}]}},\"e\":[true,false],\"a\":2.5}",
+    "[1x]",
+    "[truex]",
+    "[nullnull]",
+    "[nullx]",
+    "{\"a\":1x}",
+    "{\"a\":truex,\"b\":2}",
+    "1x",
+    "[1x,2]",
+    "[1 x]",
+    "[1,2 ]",
+    "[1, 2 ]",
+    "[-1.5e3, \"a\" ,true , null]",
+    "{\"a\" : [1, {\"b\" :false}] , \"c\":\"d\"}",
+    "{\"a\":{},\"b\":[],\"c\":[{}]}",
+    "['a,b']",
+    "['a]',2]",
+    "  42  ",
+    "42 x",
+    "[1,2] x",
+    "[1,2]]",
+    "['a'] 'b'",
+    "[\"it's\", {\"k\":'x],y'}, 2]",
+    "[\"it's\", 1x]",
+    "[1,",
+    "{\"a\"",
+    "{\"a\":",
+    "{\"a\":1,",
+    "[\"a\\q\", 1]",
+    "{\"k\\ud800\":1}",
+    "[\"\\ud83d\\ude00\", '\\u12']",
+};
+
+/**
+ * \brief Helper function to compare a document with the one load_json_n returns in scalar mode
+ *
+ * \param[in] mode name printed when they differ
+ * \param[in] json input both documents were parsed from
+ * \param[in] expected document parsed in scalar mode, NULL if it was rejected
+ * \param[in] expected_error error of the scalar mode parse
+ * \param[in] actual document to check, NULL if it was rejected
+ * \param[in] actual_error error of the parse being checked
+ */
+static void check_same(const char *mode, const char *json, json_value_t *expected, json_parse_error_t expected_error, json_value_t *actual, json_parse_error_t actual_error) {
+    bool same;
+    if (expected == NULL || actual == NULL) {
+        same = expected == NULL && actual == NULL && strcmp(expected_error.message, actual_error.message) == 0 && expected_error.offset == actual_error.offset;
+    } else {
+        char *expected_dump = dump_json(expected);
+        char *actual_dump = dump_json(actual);
+        same = expected_dump != NULL && actual_dump != NULL && strcmp(expected_dump, actual_dump) == 0;
+        free(expected_dump);
+        free(actual_dump);
+    }
+
+    if (!same) {
+        printf("FAIL %s: %.60s -> %s at %zu, expected %s at %zu\n", mode, json,
+            actual != NULL ? "accepted" : actual_error.message, actual_error.offset,
+            expected != NULL ? "accepted" : expected_error.message, expected_error.offset);
+        failures++;
+    }
+}
+
+static void test_structural_index(const char *json) {
+    json_parse_options_t scalar = { JSON_PARSE_DEFAULT, 0, NULL };
+    json_parse_options_t indexed = { JSON_PARSE_STRUCTURAL_INDEX, 0, NULL };
+    json_parse_error_t expected_error = { NULL, 0 };
+    json_parse_error_t actual_error = { NULL, 0 };
+
+    json_value_t *expected = load_json_n(json, strlen(json), &scalar, &expected_error);
+    json_value_t *actual = load_json_n(json, strlen(json), &indexed, &actual_error);
+    check_same("structural index", json, expected, expected_error, actual, actual_error);
+
+    if (expected != NULL) free_json(expected);
+    if (actual != NULL) free_json(actual);
+}
+
+static void test_cursor(const char *json) {
+    json_parse_error_t expected_error = { NULL, 0 };
+    json_parse_error_t actual_error = { NULL, 0 };
+    json_value_t *expected = load_json_n(json, strlen(json), NULL, &expected_error);
+
+    json_lazy_t *lazy = load_json_lazy(json, strlen(json), NULL, &actual_error);
+    json_value_t *actual = lazy != NULL ? json_cursor_value(json_lazy_root(lazy), &actual_error) : NULL;
+    check_same("cursor", json, expected, expected_error, actual, actual_error);
+
+    if (expected != NULL) free_json(expected);
+    if (lazy != NULL) free_json_lazy(lazy);
+}
+
+static void test_parallel(const char *json) {
+    json_parse_error_t expected_error = { NULL, 0 };
+    json_parse_error_t actual_error = { NULL, 0 };
+    json_value_t *expected = load_json_n(json, strlen(json), NULL, &expected_error);
+
+    // more threads than elements, so every element of the short cases gets a worker of its own
+    json_value_t *actual = load_json_parallel(json, strlen(json), NULL, 4, &actual_error);
+    check_same("parallel", json, expected, expected_error, actual, actual_error);
+
+    if (expected != NULL) free_json(expected);
+    if (actual != NULL) free_json(actual);
+}
+
+static void test_cursor_elements(void) {
+    // every element cursor has to reject a value with bytes glued to it
+    const char *json = "[1x, truex, nullnull, {\"a\":1x}, [2x], 3]";
+    json_lazy_t *lazy = load_json_lazy(json, strlen(json), NULL, NULL);
+    json_cursor_t root = json_lazy_root(lazy);
+
+    for (size_t i = 0; i < 6; ++i) {
+        json_cursor_t element;
+        json_parse_error_t error = { NULL, 0 };
+        bool found = json_cursor_array_get(root, i, &element);
+        json_value_t *value = found ? json_cursor_value(element, &error) : NULL;
+        if (!found || (value != NULL) != (i == 5)) {
+            printf("FAIL cursor: element %zu of %s -> %s\n", i, json, value != NULL ? "accepted" : error.message);
+            failures++;
+        }
+    }
+
+    free_json_lazy(lazy);
+}
+
+/**
+ * \brief struct collecting SAX events as bytes, so two parses can be compared with memcmp
+ */
+typedef struct {
+    char *data;
+    size_t size;
+    size_t capacity;
+} event_log_t;
+
+static bool log_event(event_log_t *log, char tag, const void *payload, size_t size) {
+    if (log->size + size + 1 > log->capacity) {
+        char *data = (char *) realloc(log->data, (log->size + size + 1) * 2);
+        if (data == NULL) return false;
+        log->data = data;
+        log->capacity = (log->size + size + 1) * 2;
+    }
+    log->data[log->size++] = tag;
+    if (size > 0) memcpy(log->data + log->size, payload, size);
+    log->size += size;
+    return true;
+}
+
+static bool log_object_begin(void *user) { return log_event((event_log_t *) user, '{', NULL, 0); }
+static bool log_array_begin(void *user) { return log_event((event_log_t *) user, '[', NULL, 0); }
+static bool log_object_end(void *user, size_t size) { return log_event((event_log_t *) user, '}', &size, sizeof(size)); }
+static bool log_array_end(void *user, size_t size) { return log_event((event_log_t *) user, ']', &size, sizeof(size)); }
+static bool log_int(void *user, long value) { return log_event((event_log_t *) user, 'l', &value, sizeof(value)); }
+static bool log_float(void *user, double value) { return log_event((event_log_t *) user, 'd', &value, sizeof(value)); }
+static bool log_bool(void *user, bool value) { return log_event((event_log_t *) user, value ? 't' : 'f', NULL, 0); }
+static bool log_null(void *user) { return log_event((event_log_t *) user, 'n', NULL, 0); }
+
+static bool log_key(void *user, const char *key, size_t size) {
+    return log_event((event_log_t *) user, 'k', &size, sizeof(size)) && log_event((event_log_t *) user, ':', key, size);
+}
+
+static bool log_string(void *user, const char *string, size_t size) {
+    return log_event((event_log_t *) user, 's', &size, sizeof(size)) && log_event((event_log_t *) user, ':', string, size);
+}
+
+static const json_sax_handler_t log_handler = {
+    log_object_begin, log_key, log_object_end, log_array_begin, log_array_end,
+    log_string, log_int, log_float, log_bool, log_null
+};
+
+/**
+ * \brief Helper function to feed json to a stream in chunks
+ *
+ * \param[in] stream stream set up by the caller, closed here
+ * \param[in] json input
+ * \param[in] size length of the input
+ * \param[in] split end of the first chunk, the rest follows as one chunk. 0 feeds one byte at a time
+ * \param[in] error receives the error of the stream
+ *
+ * \return true if the stream accepted the input
+ */
+static bool feed_stream(json_stream_t *stream, const char *json, size_t size, size_t split, json_parse_error_t *error) {
+    if (split == 0) {
+        for (size_t i = 0; i < size && json_stream_feed(stream, json + i, 1); ++i);
+    } else if (json_stream_feed(stream, json, split)) {
+        json_stream_feed(stream, json + split, size - split);
+    }
+
+    return json_stream_close(stream, error);
+}
+
+static bool append_dump(void *user, json_value_t *value) {
+    event_log_t *log = (event_log_t *) user;
+    char *dump = dump_json(value);
+    if (dump != NULL) log_event(log, '\n', dump, strlen(dump));
+    free(dump);
+    free_json(value);
+    return true;
+}
+
+/**
+ * \brief Helper function to compare a stream fed in chunks with json_sax_parse and load_json_n on
+ * the same input: the same events, the same values and the same error
+ *
+ * \param[in] json input
+ * \param[in] split see feed_stream
+ */
+static void test_stream_split(const char *json, size_t split) {
+    size_t size = strlen(json);
+    json_parse_error_t expected_error = { NULL, 0 };
+    json_parse_error_t actual_error = { NULL, 0 };
+    event_log_t expected = { NULL, 0, 0 };
+    event_log_t actual = { NULL, 0, 0 };
+
+    bool expected_valid = json_sax_parse(json, size, NULL, &log_handler, &expected, &expected_error);
+    json_stream_t stream;
+    json_stream_init(&stream, JSON_STREAM_DEFAULT, &log_handler, &actual);
+    bool actual_valid = feed_stream(&stream, json, size, split, &actual_error);
+
+    // events before an error are delivered too and have to match as well
+    bool same = expected_valid == actual_valid && expected.size == actual.size && (expected.size == 0 || memcmp(expected.data, actual.data, expected.size) == 0)
+        && (expected_valid || (strcmp(expected_error.message, actual_error.message) == 0 && expected_error.offset == actual_error.offset));
+    if (!same) {
+        printf("FAIL stream split at %zu: %.60s -> %s at %zu, expected %s at %zu\n", split, json,
+            actual_valid ? "accepted" : actual_error.message, actual_error.offset,
+            expected_valid ? "accepted" : expected_error.message, expected_error.offset);
+        failures++;
+    }
+
+    // root values and the members of a root container are handed out as documents of their own
+    json_value_t *document = load_json_n(json, size, NULL, NULL);
+    for (size_t depth = 0; depth < 2; ++depth) {
+        expected.size = 0;
+        actual.size = 0;
+        if (document != NULL && depth == 0) {
+            append_dump(&expected, document);
+            document = load_json_n(json, size, NULL, NULL);
+        } else if (document != NULL && (document->type == JSON_ARRAY || document->type == JSON_OBJECT)) {
+            bool is_object = document->type == JSON_OBJECT;
+            size_t count = is_object ? json_object_size(document) : json_array_size(document);
+            for (size_t i = 0; i < count; ++i) {
+                char *dump = dump_json(is_object ? &document->value.object->entries[i].value : json_array_get(document, i));
+                if (dump != NULL) log_event(&expected, '\n', dump, strlen(dump));
+                free(dump);
+            }
+        }
+
+        json_stream_init_values(&stream, JSON_STREAM_DEFAULT, depth, append_dump, &actual);
+        actual_valid = feed_stream(&stream, json, size, split, &actual_error);
+        if (actual_valid != (document != NULL) || (document != NULL && (expected.size != actual.size || memcmp(expected.data, actual.data, expected.size) != 0))) {
+            printf("FAIL stream values at depth %zu, split at %zu: %.60s -> %s\n", depth, split, json, actual_valid ? "accepted" : actual_error.message);
+            failures++;
+        }
+    }
+
+    if (document != NULL) free_json(document);
+    free(expected.data);
+    free(actual.data);
+}
+
+static void test_stream(const char *json) {
+    test_stream_split(json, 0);
+}
+
+static void test_stream_splits(const char *json) {
+    for (size_t split = 0; split < strlen(json); ++split) {
+        test_stream_split(json, split);
+    }
+}
+
+/**
+ * \brief Helper function to compare the value at index i of a tape with a document node
+ *
+ * \param[in] tape tape to walk
+ * \param[in] i index of the value on the tape
+ * \param[in] value node holding the same value in a document from load_json_n
+ *
+ * \return true if the tape and the node hold the same json and json_tape_skip steps over exactly
+ * the words the value took
+ */
+static bool same_tape(const json_tape_t *tape, size_t i, const json_value_t *value) {
+    if (json_tape_type(tape, i) != value->type) return false;
+
+    switch (value->type) {
+        case JSON_STRING:
+        {
+            size_t size, expected_size;
+            const char *string = json_tape_string(tape, i, &size);
+            const char *expected = json_string_get(value, &expected_size);
+            return size == expected_size && json_tape_size(tape, i) == size && memcmp(string, expected, size) == 0
+                && json_tape_skip(tape, i) == i + 1;
+        }
+        case JSON_INT:
+            return json_tape_int(tape, i) == value->value.integer && json_tape_skip(tape, i) == i + 2;
+        case JSON_FLOAT:
+        {
+            double number = json_tape_float(tape, i);
+            return memcmp(&number, &value->value.floating, sizeof(double)) == 0 && json_tape_skip(tape, i) == i + 2;
+        }
+        case JSON_BOOL:
+            return json_tape_bool(tape, i) == value->value.boolean && json_tape_skip(tape, i) == i + 1;
+        case JSON_NULL:
+            return json_tape_skip(tape, i) == i + 1;
+        case JSON_OBJECT:
+        {
+            // members alternate between a key and its value, the end word follows the last one
+            size_t child = json_tape_child(tape, i);
+            size_t end = i + 1;
+            const json_object_t *object = value->value.object;
+            for (size_t k = 0; k < object->size; ++k) {
+                const json_object_entry_t *entry = &object->entries[k];
+                if (child == JSON_TAPE_INVALID || json_tape_type(tape, child) != JSON_STRING) return false;
+
+                size_t key_size;
+                const char *key = json_tape_string(tape, child, &key_size);
+                if (key_size != entry->key_size || memcmp(key, entry->key, key_size) != 0) return false;
+                if (!same_tape(tape, child + 1, &entry->value)) return false;
+
+                // a duplicate key finds its first member
+                size_t found = json_tape_object_get(tape, i, entry->key, entry->key_size);
+                if (found == JSON_TAPE_INVALID || found > child + 1) return false;
+
+                end = json_tape_skip(tape, child + 1);
+                child = json_tape_next(tape, child + 1);
+            }
+            return child == JSON_TAPE_INVALID && json_tape_size(tape, i) == object->size && json_tape_skip(tape, i) == end + 1;
+        }
+        case JSON_ARRAY:
+        {
+            size_t child = json_tape_child(tape, i);
+            size_t end = i + 1;
+            for (size_t k = 0; k < json_array_size(value); ++k) {
+                if (child == JSON_TAPE_INVALID || json_tape_array_get(tape, i, k) != child) return false;
+                if (!same_tape(tape, child, json_array_get(value, k))) return false;
+
+                end = json_tape_skip(tape, child);
+                child = json_tape_next(tape, child);
+            }
+            return child == JSON_TAPE_INVALID && json_tape_array_get(tape, i, json_array_size(value)) == JSON_TAPE_INVALID
+                && json_tape_size(tape, i) == json_array_size(value) && json_tape_skip(tape, i) == end + 1;
+        }
+    }
+
+    return false;
+}
+
+static void test_tape(const char *json) {
+    json_parse_error_t expected_error = { NULL, 0 };
+    json_parse_error_t actual_error = { NULL, 0 };
+    json_value_t *expected = load_json_n(json, strlen(json), NULL, &expected_error);
+    json_tape_t *actual = load_json_tape(json, strlen(json), NULL, &actual_error);
+
+    bool same;
+    if (expected == NULL || actual == NULL) {
+        same = expected == NULL && actual == NULL && strcmp(expected_error.message, actual_error.message) == 0 && expected_error.offset == actual_error.offset;
+    } else {
+        // the root sits between the two root words
+        same = same_tape(actual, 1, expected) && json_tape_skip(actual, 1) == actual->size - 1;
+    }
+
+    if (!same) {
+        printf("FAIL tape: %.60s -> %s at %zu, expected %s at %zu\n", json,
+            actual != NULL ? "accepted" : actual_error.message, actual_error.offset,
+            expected != NULL ? "accepted" : expected_error.message, expected_error.offset);
+        failures++;
+    }
+
+    if (expected != NULL) free_json(expected);
+    if (actual != NULL) free_json_tape(actual);
+}
+
+static void test_tape_saturated(void) {
+    // member counts saturate at JSON_TAPE_COUNT_MAX, json_tape_size then counts the children
+    size_t counts[] = { JSON_TAPE_COUNT_MAX - 1, JSON_TAPE_COUNT_MAX, JSON_TAPE_COUNT_MAX + 2 };
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+        size_t count = counts[c];
+        size_t size = 2 * count + 1;
+        char *json = (char *) malloc(size);
+        json[0] = '[';
+        for (size_t k = 0; k < count; ++k) {
+            json[2 * k + 1] = k % 10 + '0';
+            json[2 * k + 2] = k + 1 < count ? ',' : ']';
+        }
+
+        json_tape_t *tape = load_json_tape(json, size, NULL, NULL);
+        size_t last = tape != NULL ? json_tape_array_get(tape, 1, count - 1) : JSON_TAPE_INVALID;
+        if (tape == NULL || json_tape_size(tape, 1) != count || last == JSON_TAPE_INVALID || json_tape_int(tape, last) != (long) ((count - 1) % 10)
+            || json_tape_next(tape, last) != JSON_TAPE_INVALID || json_tape_skip(tape, 1) != tape->size - 1) {
+            printf("FAIL tape: array of %zu elements -> size %zu\n", count, tape != NULL ? json_tape_size(tape, 1) : 0);
+            failures++;
+        }
+
+        if (tape != NULL) free_json_tape(tape);
+        free(json);
+    }
+}
+
+// documents json_validate has to reject at a given offset, or accept when message is NULL. The
+// length comes from the literal, so inputs may stop in the middle of a string or escape
+#define VALIDATE_CASE(json, message, offset) { json, sizeof(json) - 1, message, offset }
+
+static const struct {
+    const char *json;
+    size_t size;
+    const char *message;
+    size_t offset;
+} validate_cases[] = {
+    VALIDATE_CASE("[0, -0, 0.5, -0e1, 10, 1E+2]", NULL, 0),
+    VALIDATE_CASE("0123", "leading zeros are not allowed", 1),
+    VALIDATE_CASE("[1, 00]", "leading zeros are not allowed", 5),
+    VALIDATE_CASE("-012", "leading zeros are not allowed", 2),
+    VALIDATE_CASE("1.", "expected a digit after the decimal point", 2),
+    VALIDATE_CASE("1e+", "expected a digit in the exponent", 3),
+    VALIDATE_CASE("[1,]", "unexpected character", 3),
+    VALIDATE_CASE("[1,2,]", "unexpected character", 5),
+    VALIDATE_CASE("{\"a\":1,}", "expected a string key", 7),
+    VALIDATE_CASE("['a']", "unexpected character", 1),
+    VALIDATE_CASE("{'a':1}", "expected a string key", 1),
+    VALIDATE_CASE("[\"it's\"]", NULL, 0),
+    VALIDATE_CASE("\"a\x01\"", "control character in string", 2),
+    VALIDATE_CASE("[\"\t\"]", "control character in string", 2),
+    VALIDATE_CASE("\"a\nb\"", "control character in string", 2),
+    VALIDATE_CASE("\"\x7f\"", NULL, 0),
+    VALIDATE_CASE("\"\\u00e9\\uD83D\\uDE00\\/\\b\\f\\n\\r\\t\"", NULL, 0),
+    VALIDATE_CASE("\"\\q\"", "invalid escape sequence", 1),
+    VALIDATE_CASE("\"ab\\x41\"", "invalid escape sequence", 3),
+    VALIDATE_CASE("\"\\u12G4\"", "invalid \\u escape", 1),
+    VALIDATE_CASE("\"\\u12\"", "invalid \\u escape", 1),
+    VALIDATE_CASE("\"\\u12", "invalid \\u escape", 1),
+    VALIDATE_CASE("\"\\ud83d\\ude00\"", NULL, 0),
+    VALIDATE_CASE("\"\\ud800\"", "invalid \\u escape", 1),
+    VALIDATE_CASE("\"\\udc00\\ud800\"", "invalid \\u escape", 1),
+    VALIDATE_CASE("\"\\", "unterminated string", 2),
+    VALIDATE_CASE("\"abc", "unterminated string", 4),
+    VALIDATE_CASE("\"\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80\"", NULL, 0),
+    VALIDATE_CASE("\"\xed\x9f\xbf\xee\x80\x80\xf4\x8f\xbf\xbf\"", NULL, 0),
+    VALIDATE_CASE("\"\xc0\xaf\"", "invalid UTF-8", 1),
+    VALIDATE_CASE("\"\xc1\xbf\"", "invalid UTF-8", 1),
+    VALIDATE_CASE("\"a\xe0\x80\xaf\"", "invalid UTF-8", 2),
+    VALIDATE_CASE("\"\xf0\x80\x80\xaf\"", "invalid UTF-8", 1),
+    VALIDATE_CASE("\"\xed\xa0\x80\"", "invalid UTF-8", 1),
+    VALIDATE_CASE("\"\xed\xbf\xbf\"", "invalid UTF-8", 1),
+    VALIDATE_CASE("\"\xf4\x90\x80\x80\"", "invalid UTF-8", 1),
+    VALIDATE_CASE("\"\xf5\x80\x80\x80\"", "invalid UTF-8", 1),
+    VALIDATE_CASE("\"\xff\"", "invalid UTF-8", 1),
+    VALIDATE_CASE("\"\x80\"", "invalid UTF-8", 1),
+    VALIDATE_CASE("\"\xe2\x82\"", "invalid UTF-8", 1),
+    VALIDATE_CASE("\"\xf0\x9f\x98\"", "invalid UTF-8", 1),
+    VALIDATE_CASE("\"\xe2\x82", "invalid UTF-8", 1),
+    VALIDATE_CASE("{\"a\" 1}", "expected ':' after object key", 5),
+    VALIDATE_CASE("[1 2]", "expected ',' or ']' in array", 3),
+    VALIDATE_CASE("{\"a\":1 \"b\":2}", "expected ',' or '}' in object", 7),
+    VALIDATE_CASE("[1, 2", "unterminated array", 5),
+    VALIDATE_CASE("{\"a\":1", "unterminated object", 6),
+    VALIDATE_CASE("", "unexpected end of input", 0),
+    VALIDATE_CASE("[1] 2", "unexpected characters after the root value", 4),
+    VALIDATE_CASE("tru", "unexpected character", 0),
+    VALIDATE_CASE("nul1", "unexpected character", 0),
+};
+
+static void test_validate(void) {
+    for (size_t i = 0; i < sizeof(validate_cases) / sizeof(validate_cases[0]); ++i) {
+        json_parse_error_t error = { NULL, 0 };
+        bool valid = json_validate(validate_cases[i].json, validate_cases[i].size, &error);
+
+        const char *message = validate_cases[i].message;
+        bool expected = message == NULL ? valid : !valid && strcmp(error.message, message) == 0 && error.offset == validate_cases[i].offset;
+        if (!expected) {
+            printf("FAIL validate: case %zu -> %s at %zu, expected %s at %zu\n", i,
+                valid ? "accepted" : error.message, error.offset,
+                message != NULL ? message : "accepted", validate_cases[i].offset);
+            failures++;
+        }
+    }
+}
+
+// string contents every parse mode has to decode to the given bytes, or reject with message at
+// offset bytes into the quoted string
+static const struct {
+    const char *string;
+    const char *decoded;
+    const char *message;
+    size_t offset;
+} escape_cases[] = {
+    { "\"\\\"\\\\\\/\\b\\f\\n\\r\\t\"", "\"\\/\b\f\n\r\t", NULL, 0 },
+    { "\"it\\'s\"", "it's", NULL, 0 },
+    { "\"\\u0041\\u00e9\\u20AC\"", "A\xC3\xA9\xE2\x82\xAC", NULL, 0 },
+    { "\"\\ud83d\\ude00\"", "\xF0\x9F\x98\x80", NULL, 0 },
+    { "\"\\udbff\\udfff\"", "\xF4\x8F\xBF\xBF", NULL, 0 },
+    { "\"\\q\"", NULL, "invalid escape sequence", 1 },
+    { "\"ab\\x41\"", NULL, "invalid escape sequence", 3 },
+    { "\"\\U0041\"", NULL, "invalid escape sequence", 1 },
+    { "\"\\u12\"", NULL, "invalid \\u escape", 1 },
+    { "\"\\u12G4\"", NULL, "invalid \\u escape", 1 },
+    { "\"a\\ud800\"", NULL, "invalid \\u escape", 2 },
+    { "\"\\ud800x\"", NULL, "invalid \\u escape", 1 },
+    { "\"\\ud800\\u0041\"", NULL, "invalid \\u escape", 1 },
+    { "\"\\ud800\\ud800\"", NULL, "invalid \\u escape", 1 },
+    { "\"\\ud800\\udc0\"", NULL, "invalid \\u escape", 1 },
+    { "\"\\udc00\"", NULL, "invalid \\u escape", 1 },
+    { "\"\\udfff\\ud800\"", NULL, "invalid \\u escape", 1 },
+};
+
+/**
+ * \brief Helper function to check the string a parse left at the root or as the key of the root
+ *
+ * \param[in] mode name printed when the outcome is wrong
+ * \param[in] i index into escape_cases
+ * \param[in] value parsed document, NULL if it was rejected
+ * \param[in] error error of the parse
+ * \param[in] shift offset of the quoted string inside the parsed input
+ */
+static void check_escape(const char *mode, size_t i, json_value_t *value, json_parse_error_t error, size_t shift) {
+    const char *decoded = escape_cases[i].decoded;
+    bool same;
+    if (decoded == NULL) {
+        same = value == NULL && error.message != NULL && strcmp(error.message, escape_cases[i].message) == 0 && error.offset == escape_cases[i].offset + shift;
+    } else if (value != NULL && value->type == JSON_OBJECT) {
+        json_object_entry_t *entry = &value->value.object->entries[0];
+        same = json_object_size(value) == 1 && entry->key_size == strlen(decoded) && memcmp(entry->key, decoded, entry->key_size) == 0;
+    } else {
+        size_t size = 0;
+        const char *string = value != NULL ? json_string_get(value, &size) : NULL;
+        same = string != NULL && size == strlen(decoded) && memcmp(string, decoded, size) == 0;
+    }
+    if (!same) {
+        printf("FAIL escape %s: %s -> %s at %zu\n", mode, escape_cases[i].string, value != NULL ? "accepted" : error.message, error.offset);
+        failures++;
+    }
+    if (value != NULL) free_json(value);
+}
+
+static void test_escapes(void) {
+    json_parse_options_t insitu = { JSON_PARSE_INSITU, 0, NULL };
+    json_parse_options_t interned = { JSON_PARSE_INTERN_KEYS, 0, NULL };
+    json_sax_handler_t handler = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+    char json[64];
+
+    for (size_t i = 0; i < sizeof(escape_cases) / sizeof(escape_cases[0]); ++i) {
+        const char *string = escape_cases[i].string;
+        size_t size = strlen(string);
+        json_parse_error_t error = { NULL, 0 };
+        check_escape("load_json_n", i, load_json_n(string, size, NULL, &error), error, 0);
+
+        error.message = NULL;
+        strcpy(json, string);
+        check_escape("insitu", i, load_json_n(json, size, &insitu, &error), error, 0);
+
+        // keys without an arena are decoded into the scratch buffer instead
+        size = (size_t) snprintf(json, sizeof(json), "{%s:1}", string);
+        error.message = NULL;
+        check_escape("key", i, load_json_n(json, size, NULL, &error), error, 1);
+
+        error.message = NULL;
+        check_escape("interned key", i, load_json_n(json, size, &interned, &error), error, 1);
+
+        error.message = NULL;
+        bool valid = json_sax_parse(json, size, NULL, &handler, NULL, &error);
+        check_escape("json_sax_parse", i, valid ? load_json_n(json, size, NULL, NULL) : NULL, error, 1);
+
+        // json_validate takes no single quotes, but rejects the rest alike
+        if (strchr(string, '\'') == NULL) {
+            error.message = NULL;
+            valid = json_validate(string, strlen(string), &error);
+            check_escape("json_validate", i, valid ? load_json_n(string, strlen(string), NULL, NULL) : NULL, error, 0);
+        }
+    }
+}
+
+/**
+ * \brief Helper function to find the stored key of an object member
+ *
+ * \param[in] object object to search
+ * \param[in] key key to look for
+ *
+ * \return the key as stored in the object, NULL if no member has it
+ */
+static const char* stored_key(const json_value_t *object, const char *key) {
+    for (size_t i = 0; object != NULL && i < json_object_size(object); ++i) {
+        if (strcmp(object->value.object->entries[i].key, key) == 0) return object->value.object->entries[i].key;
+    }
+    return NULL;
+}
+
+static void test_intern_shared(void) {
+    json_intern_t *table = json_intern_create();
+    json_parse_options_t shared = { JSON_PARSE_DEFAULT, 0, table };
+    const char *first_json = "{\"id\":1,\"name\":\"a\",\"tags\":[{\"id\":2}]}";
+    const char *second_json = "[{\"name\":\"b\",\"id\":3}]";
+    json_value_t *first = load_json_n(first_json, strlen(first_json), &shared, NULL);
+    json_value_t *second = load_json_n(second_json, strlen(second_json), &shared, NULL);
+    json_value_t *nested = first != NULL ? json_array_get(json_object_get(first, "tags", 4), 0) : NULL;
+    json_value_t *element = second != NULL ? json_array_get(second, 0) : NULL;
+
+    // keys of both documents are the table's copies, so equal keys are the same pointer
+    const char *id = json_intern(table, "id", 2);
+    const char *name = json_intern(table, "name", 4);
+    bool same = table->size == 3 && id != NULL && stored_key(first, "id") == id && stored_key(nested, "id") == id
+        && stored_key(element, "id") == id && stored_key(first, "name") == name && stored_key(element, "name") == name;
+    if (!same) {
+        printf("FAIL intern: keys of two documents sharing a table are not the same pointers\n");
+        failures++;
+    }
+    if (first != NULL) free_json(first);
+    if (second != NULL) free_json(second);
+
+    // load_json_lines interns per worker and leaves the shared table alone
+    const char *lines_json = "{\"id\":1}\n{\"id\":2,\"other\":3}\n";
+    json_lines_t *lines = load_json_lines(lines_json, strlen(lines_json), &shared, 1, NULL);
+    if (lines == NULL || table->size != 3 || stored_key(&lines->values[0], "id") != stored_key(&lines->values[1], "id")
+        || stored_key(&lines->values[0], "id") == id) {
+        printf("FAIL intern: load_json_lines with a shared table\n");
+        failures++;
+    }
+    if (lines != NULL) free_json_lines(lines);
+
+    json_intern_free(table);
+}
+
+/**
+ * \brief Helper function to check the outcome of one entry point on nested brackets
+ *
+ * \param[in] entry name of the entry point printed when it is wrong
+ * \param[in] depth nesting depth of the input
+ * \param[in] accepted true if the entry point accepted the input
+ * \param[in] error error it reported, NULL message if it reports none
+ */
+static void check_depth(const char *entry, size_t depth, bool accepted, json_parse_error_t error) {
+    bool deep = depth > JSON_MAX_DEPTH;
+    bool reported = error.message == NULL || (strcmp(error.message, "nesting too deep") == 0 && error.offset == JSON_MAX_DEPTH);
+    if (accepted == deep || (deep && !reported)) {
+        printf("FAIL depth: %s on %zu brackets -> %s at %zu\n", entry, depth, accepted ? "accepted" : error.message, error.offset);
+        failures++;
+    }
+}
+
+static bool free_value(void *user, json_value_t *value) {
+    (void) user;
+    free_json(value);
+    return true;
+}
+
+static void test_depth(size_t depth) {
+    json_sax_handler_t handler = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+    json_parse_error_t none = { NULL, 0 };
+    json_parse_error_t error = none;
+
+    // depth arrays around a 1, the innermost '[' sits at offset depth - 1
+    size_t size = 2 * depth + 1;
+    char *json = (char *) malloc(size + 1);
+    memset(json, '[', depth);
+    json[depth] = '1';
+    memset(json + depth + 1, ']', depth);
+    json[size] = '\0';
+    char *input = (char *) malloc(size + 1);
+
+    json_value_t *value = load_json(strcpy(input, json));
+    check_depth("load_json", depth, value != NULL, none);
+    if (value != NULL) free_json(value);
+
+    json_parse_options_t indexed = { JSON_PARSE_STRUCTURAL_INDEX, 0, NULL };
+    value = load_json_ex(strcpy(input, json), &indexed);
+    check_depth("load_json_ex", depth, value != NULL, none);
+    if (value != NULL) free_json(value);
+
+    value = load_json_insitu(strcpy(input, json));
+    check_depth("load_json_insitu", depth, value != NULL, none);
+    if (value != NULL) free_json(value);
+
+    value = load_json_n(json, size, NULL, &error);
+    check_depth("load_json_n", depth, value != NULL, error);
+    if (value != NULL) free_json(value);
+
+    char path[] = "/tmp/jajson_depth_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0 || write(fd, json, size) != (ssize_t) size) {
+        printf("FAIL depth: can not write %s\n", path);
+        failures++;
+    } else {
+        error = none;
+        value = load_json_file_ex(path, NULL, &error);
+        check_depth("load_json_file_ex", depth, value != NULL, error);
+        if (value != NULL) free_json(value);
+    }
+    if (fd >= 0) {
+        close(fd);
+        unlink(path);
+    }
+
+    error = none;
+    check_depth("json_sax_parse", depth, json_sax_parse(json, size, NULL, &handler, NULL, &error), error);
+
+    error = none;
+    json_lazy_t *lazy = load_json_lazy(json, size, NULL, &error);
+    value = lazy != NULL ? json_cursor_value(json_lazy_root(lazy), &error) : NULL;
+    check_depth("json_cursor_value", depth, value != NULL, error);
+    if (lazy != NULL) free_json_lazy(lazy);
+
+    error = none;
+    value = load_json_parallel(json, size, NULL, 4, &error);
+    check_depth("load_json_parallel", depth, value != NULL, error);
+    if (value != NULL) free_json(value);
+
+    error = none;
+    json_lines_t *lines = load_json_lines(json, size, NULL, 2, &error);
+    check_depth("load_json_lines", depth, lines != NULL, error);
+    if (lines != NULL) free_json_lines(lines);
+
+    error = none;
+    json_tape_t *tape = load_json_tape(json, size, NULL, &error);
+    check_depth("load_json_tape", depth, tape != NULL, error);
+    if (tape != NULL) free_json_tape(tape);
+
+    error = none;
+    check_depth("json_validate", depth, json_validate(json, size, &error), error);
+
+    // streams get the brackets one at a time
+    json_stream_t stream;
+    json_stream_init(&stream, JSON_STREAM_DEFAULT, &handler, NULL);
+    for (size_t i = 0; i < size && json_stream_feed(&stream, json + i, 1); ++i);
+    error = none;
+    check_depth("json_stream_init", depth, json_stream_close(&stream, &error), error);
+
+    json_stream_init_values(&stream, JSON_STREAM_DEFAULT, 1, free_value, NULL);
+    for (size_t i = 0; i < size && json_stream_feed(&stream, json + i, 1); ++i);
+    error = none;
+    check_depth("json_stream_init_values", depth, json_stream_close(&stream, &error), error);
+
+    free(input);
+    free(json);
+}
+
+// doubles whose dump is known exactly, the boundaries of the formatting and of the double range
+static const struct {
+    double value;
+    const char *dump;
+} float_cases[] = {
+    { 0.0, "0.0" },
+    { -0.0, "-0.0" },
+    { 1.0, "1.0" },
+    { -1.5, "-1.5" },
+    { 0.1, "0.1" },
+    { 123456.789, "123456.789" },
+    { 1e-6, "0.000001" },
+    { 1e-7, "1e-7" },
+    { 999999999999999900000.0, "999999999999999900000.0" },
+    { 1e21, "1e21" },
+    { 1e22, "1e22" },
+    { DBL_MAX, "1.7976931348623157e308" },
+    { -DBL_MAX, "-1.7976931348623157e308" },
+    { DBL_MIN, "2.2250738585072014e-308" },
+    { 2.225073858507201e-308, "2.225073858507201e-308" },
+    { 5e-324, "5e-324" },
+    { -5e-324, "-5e-324" },
+    { INFINITY, "null" },
+    { -INFINITY, "null" },
+    { NAN, "null" },
+};
+
+/**
+ * \brief Helper function to check that dump_json writes a double with the fewest significant
+ * digits that read back as the same double, through strtod and through load_json_n
+ *
+ * \param[in] value finite double to check
+ */
+static void check_float_round_trip(double value) {
+    json_value_t json_value = build_json_float(value);
+    char *dump = dump_json(&json_value);
+    json_value_t *parsed = dump != NULL ? load_json_n(dump, strlen(dump), NULL, NULL) : NULL;
+    double read = dump != NULL ? strtod(dump, NULL) : 0.0;
+
+    // the fewest digits that round trip is what the dump has to reach, the nearest decimal with that
+    // many digits can lie just outside the rounding interval while its neighbour lies inside
+    size_t shortest = 0;
+    char buffer[48];
+    bool found = value == 0.0;
+    while (!found && shortest < 17) {
+        shortest++;
+        snprintf(buffer, sizeof(buffer), "%.*e", (int) shortest - 1, fabs(value));
+        uint64_t mantissa = 0;
+        char *c = buffer;
+        for (; *c != 'e'; ++c) {
+            if (*c != '.') mantissa = mantissa * 10 + (uint64_t) (*c - '0');
+        }
+        int exponent = atoi(c + 1) - (int) shortest + 1;
+        for (uint64_t candidate = mantissa - 1; candidate <= mantissa + 1 && !found; ++candidate) {
+            snprintf(buffer, sizeof(buffer), "%llue%d", (unsigned long long) candidate, exponent);
+            found = strtod(buffer, NULL) == fabs(value);
+        }
+    }
+
+    size_t digits = 0;
+    size_t zeros = 0;
+    for (const char *c = dump; c != NULL && *c != '\0' && *c != 'e'; ++c) {
+        if (*c < '0' || *c > '9' || (*c == '0' && digits == 0)) continue;
+        zeros = *c == '0' ? zeros + 1 : 0;
+        digits++;
+    }
+    digits -= zeros;
+
+    bool same = dump != NULL && memcmp(&read, &value, sizeof(value)) == 0 && digits == shortest
+        && parsed != NULL && parsed->type == JSON_FLOAT && memcmp(&parsed->value.floating, &value, sizeof(value)) == 0;
+    if (!same) {
+        printf("FAIL float round trip: %.17g -> %s\n", value, dump != NULL ? dump : "(null)");
+        failures++;
+    }
+
+    if (parsed != NULL) free_json(parsed);
+    free(dump);
+}
+
+static void test_float_format(void) {
+    for (size_t i = 0; i < sizeof(float_cases) / sizeof(float_cases[0]); ++i) {
+        json_value_t json_value = build_json_float(float_cases[i].value);
+        char *dump = dump_json(&json_value);
+        if (dump == NULL || strcmp(dump, float_cases[i].dump) != 0) {
+            printf("FAIL float dump: %.17g -> %s, expected %s\n", float_cases[i].value, dump != NULL ? dump : "(null)", float_cases[i].dump);
+            failures++;
+        }
+        if (isfinite(float_cases[i].value)) check_float_round_trip(float_cases[i].value);
+        free(dump);
+    }
+
+    // every power of two with its neighbours covers each binary exponent, subnormals included
+    for (int exponent = -1074; exponent <= 1023; ++exponent) {
+        double power = ldexp(1.0, exponent);
+        check_float_round_trip(power);
+        check_float_round_trip(nextafter(power, 0.0));
+        check_float_round_trip(-nextafter(power, DBL_MAX));
+    }
+
+    srand(1);
+    for (size_t i = 0; i < 200000; ++i) {
+        uint64_t bits = 0;
+        for (size_t k = 0; k < 4; ++k) bits = (bits << 16) | (uint64_t) (rand() & 0xFFFF);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        if (isfinite(value)) check_float_round_trip(value);
+    }
+}
+
+// numbers whose rounding the fast paths get wrong easily: halfway cases, more than 19 digits, the
+// subnormal and overflow boundaries
+static const char *number_cases[] = {
+    "0.1",
+    "-0.0",
+    "1.00000000000000011102230246251565404236316680908203125",
+    "1.00000000000000011102230246251565404236316680908203124",
+    "1.00000000000000011102230246251565404236316680908203126",
+    "9007199254740993.0",
+    "9007199254740993.0000000000000000001",
+    "123456789012345678901234567890.0",
+    "0.000000000000000000000000000000012345678901234567890123e+10",
+    "2.2250738585072011e-308",
+    "2.2250738585072012e-308",
+    "4.9406564584124654e-324",
+    "2.4703282292062327e-324",
+    "2.4703282292062328e-324",
+    "1.0e-400",
+    "1.7976931348623157e308",
+    "1.7976931348623158e308",
+    "1.7976931348623159e308",
+    "1.0e400",
+    "7.2057594037927933e16",
+    "1.0e22",
+    "1.0e23",
+    "8.98846567431158e307",
+};
+
+/**
+ * \brief Helper function to check that load_json_n reads a float to the same bits as strtod
+ *
+ * \param[in] number json number with a fraction part
+ */
+static void check_float_parse(const char *number) {
+    json_value_t *parsed = load_json_n(number, strlen(number), NULL, NULL);
+    double expected = strtod(number, NULL);
+    if (parsed == NULL || parsed->type != JSON_FLOAT || memcmp(&parsed->value.floating, &expected, sizeof(expected)) != 0) {
+        printf("FAIL float parse: %s -> %.17g, expected %.17g\n", number, parsed != NULL && parsed->type == JSON_FLOAT ? parsed->value.floating : 0.0, expected);
+        failures++;
+    }
+    if (parsed != NULL) free_json(parsed);
+}
+
+static void test_float_parse(void) {
+    char number[64];
+    for (size_t i = 0; i < sizeof(number_cases) / sizeof(number_cases[0]); ++i) check_float_parse(number_cases[i]);
+
+    srand(1);
+    for (size_t i = 0; i < 200000; ++i) {
+        // random digits with the point anywhere and an exponent spanning the whole double range
+        size_t digits = 1 + (size_t) rand() % 40;
+        size_t point = 1 + (size_t) rand() % digits;
+        size_t size = 0;
+        if (rand() % 2) number[size++] = '-';
+        for (size_t k = 0; k < digits; ++k) {
+            if (k == point) number[size++] = '.';
+            number[size++] = (char) ('0' + (k == 0 && digits > 1 ? 1 + rand() % 9 : rand() % 10));
+        }
+        if (point == digits) size += (size_t) snprintf(number + size, 3, ".%d", rand() % 10);
+        snprintf(number + size, sizeof(number) - size, "e%d", rand() % 700 - 360);
+        check_float_parse(number);
+
+        // and a random double written with 17 and 19 significant digits, close to a rounding boundary
+        uint64_t bits = 0;
+        for (size_t k = 0; k < 4; ++k) bits = (bits << 16) | (uint64_t) (rand() & 0xFFFF);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        if (!isfinite(value)) continue;
+        snprintf(number, sizeof(number), "%.16e", value);
+        check_float_parse(number);
+        snprintf(number, sizeof(number), "%.18e", value);
+        check_float_parse(number);
+    }
+}
+
+/**
+ * \brief Helper function to read a whole file into a null terminated buffer
+ *
+ * \param[in] path file to read
+ * \param[in] size address of a size that stores the file length
+ *
+ * \return buffer that must be freed, NULL if the file can not be read
+ */
+static char* read_file(const char *path, size_t *size) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return NULL;
+
+    fseek(file, 0L, SEEK_END);
+    *size = (size_t) ftell(file);
+    fseek(file, 0L, SEEK_SET);
+
+    char *buffer = (char *) malloc(*size + 1);
+    if (buffer != NULL && fread(buffer, 1, *size, file) == *size) {
+        buffer[*size] = '\0';
+    } else {
+        free(buffer);
+        buffer = NULL;
+    }
+    fclose(file);
+
+    return buffer;
+}
+
+/**
+ * \brief Helper function to run test on a corpus file and on copies of it with a few bytes replaced
+ * by structural characters, quotes or letters, some of them cut short
+ *
+ * \param[in] path corpus file
+ * \param[in] test test to run on every document
+ */
+static void test_corpus(const char *path, void (*test)(const char *json)) {
+    size_t size;
+    char *json = read_file(path, &size);
+    if (json == NULL) {
+        printf("FAIL can not read %s\n", path);
+        failures++;
+        return;
+    }
+
+    test(json);
+
+    srand(1);
+    char *mutated = (char *) malloc(size + 1);
+    for (int i = 0; i < 200; ++i) {
+        memcpy(mutated, json, size + 1);
+        for (int j = 0; j < 3; ++j) {
+            mutated[rand() % size] = "{}[]:,\"x0 "[rand() % 10];
+        }
+        if (i % 2 == 1) mutated[rand() % size] = '\0';
+        test(mutated);
+    }
+
+    free(mutated);
+    free(json);
+}
+
+int main() {
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        test_structural_index(cases[i]);
+        test_cursor(cases[i]);
+        test_parallel(cases[i]);
+        test_tape(cases[i]);
+        test_stream_splits(cases[i]);
+    }
+    test_cursor_elements();
+    test_validate();
+    test_escapes();
+    test_intern_shared();
+    test_tape_saturated();
+    test_depth(JSON_MAX_DEPTH);
+    test_depth(JSON_MAX_DEPTH + 1);
+    test_depth(2 * JSON_MAX_DEPTH);
+    test_float_format();
+    test_float_parse();
+    test_corpus("../benchmark_generation/twitter.json", test_structural_index);
+    test_corpus("../benchmark_generation/gists.json", test_structural_index);
+    test_corpus("../benchmark_generation/twitter.json", test_parallel);
+    test_corpus("../benchmark_generation/gists.json", test_parallel);
+    test_corpus("../benchmark_generation/twitter.json", test_tape);
+    test_corpus("../benchmark_generation/gists.json", test_tape);
+    test_corpus("../benchmark_generation/twitter.json", test_stream);
+    test_corpus("../benchmark_generation/gists.json", test_stream);
+
+    if (failures == 0) printf("all tests passed\n");
+    return failures == 0 ? 0 : 1;
+}